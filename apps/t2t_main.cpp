@@ -1,15 +1,32 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <thread>
 #include <vector>
 #include <fstream>
+#include <memory>
+#include <span>
 
 #include "libutil/affinity.h"
 #include "libutil/timing.h"
 #include "libutil/histo.h"
 #include "libutil/nomalloc.h"
+#include "libutil/perf_counters.h"
+#include "libutil/trace.h"
+#include "libengine/batch.h"
+#include "libengine/sharded.h"
 #include "libitch/itch.h"
+#include "libitch/csv_cursor.h"
+#include "libitch/itch5.h"
+#include "libitch/symbols.h"
+#include "libitch/t2tb.h"
+#include "libring/spsc_ring.hpp"
+#include "libring/wait_strategy.hpp"
+#include "liblob/book_manager.h"
 #include "liblob/lob.h"
 #include "libsig/mm.h"
 #include "librisk/risk.h"
@@ -19,20 +36,60 @@
 using namespace t2t;
 
 struct Args {
-  std::string replay, results="out.csv", latency="latency.csv", histo="latency_hist.csv";
+  std::string replay, results="out.csv", latency, histo="latency_hist.csv";   // latency: raw samples (optional)
+  int histo_bits=8;                // stage histogram precision (LogHisto sub_bits)
+  std::string probe_stats;         // optional id-map probe histogram CSV
+  std::string itch;                // binary ITCH 5.0 capture (instead of --replay)
+  std::string itch_framing="auto"; // auto | raw | len
+  std::string symbols;             // optional directory CSV: locate,symbol[,max_orders[,max_levels]]
+  long long book_orders=-1, book_levels=-1;  // default book sizing (else Lob defaults)
+  bool book_lazy=false;            // touch book pools on first use instead of at creation
+  long long id_window=0;           // direct order-id table span per book (0 = hash only)
+  int batch=0, batch_ahead=4;      // serial: decode N events, apply with lookahead prefetch
   int core=-1, warmup=200, max_msgs=1'000'000;
+  int load_threads=1;              // CSV replay: parallel chunked load
+  long long start_event=-1;        // .t2tb replay: first event offset
+  long long start_ts=-1;           // .t2tb replay: first event with ts_ns >= this
+  bool stream=false;               // producer thread feeds the pipeline over a ring
+  bool pipeline=false;             // decode | book+signal | risk+encode on 3 threads
+  int producer_core=-1, book_core=-1, ring_size=4096;
+  std::string wait="yield";        // ring wait policy: spin | pause | yield | park
+  std::string clock="tsc";         // stage timer: tsc (falls back if unusable) | steady
+  int perf_sample=0;               // >0: hardware counters on every Nth event, per stage
+  std::string perf_csv;            // optional per-stage counter CSV (with --perf-sample)
+  std::string trace;               // optional binary event trace (tools/read_trace.py)
+  long long trace_cap=1 << 16;     // records kept (newest)
+  int trace_every=1;               // keep every Nth event
+  double trace_slow_us=0.0;        // >0: keep only events with e2e >= this, plus context
+  int trace_context=16;            // events kept either side of a slow one
+  int shards=0;                    // >0: symbol-sharded engine with this many workers
+  std::vector<int> shard_cores;    // worker k pinned to shard_cores[k]
   int inv_cap=100, throttle=200;
   double notional_cap=1e12;
   std::string mode="heuristic";
   double avs_gamma=1e-6, avs_k=0.1, avs_horizon=10.0;
+  std::string avs_est="rolling";   // rolling | ew
+  int avs_window=1024;             // rolling: mids kept in the OU window
+  double avs_halflife=256.0;       // ew: half-life in samples
 };
 
 static void usage() {
   std::fprintf(stderr,
-    "t2t_main --replay path.csv [--results out.csv] [--latency lat.csv] [--histo hist.csv]\n"
-    "         [--pinner core_id] [--warmup N] [--max-msgs N]\n"
+    "t2t_main (--replay path.csv|path.t2tb | --itch path.bin [--itch-framing auto|raw|len])\n"
+    "         [--start-event N | --start-ts NS]   (.t2tb only)\n"
+    "         [--results out.csv] [--latency lat.csv] [--histo hist.csv] [--histo-bits B]\n"
+    "         [--probe-stats probes.csv] [--load-threads N]\n"
+    "         [--symbols dir.csv] [--book-orders N] [--book-levels N] [--book-lazy]\n"
+    "         [--id-window N] [--batch N [--batch-ahead D]]\n"
+    "         [--pinner core_id] [--warmup N] [--max-msgs N] [--clock tsc|steady]\n"
+    "         [--perf-sample N [--perf-csv counters.csv]]\n"
+    "         [--trace trace.bin [--trace-cap N] [--trace-every N | --trace-slow-us X [--trace-context N]]]\n"
+    "         [--stream | --pipeline [--book-core core_id]]\n"
+    "         [--producer-core core_id] [--ring-size N] [--wait spin|pause|yield|park]\n"
+    "         [--shards N [--shard-cores c0,c1,...]]\n"
     "         [--inv-cap N] [--throttle N_per_ms]\n"
-    "         [--mode heuristic|avs] [--avs-gamma G] [--avs-k K] [--avs-horizon S]\n");
+    "         [--mode heuristic|avs] [--avs-gamma G] [--avs-k K] [--avs-horizon S]\n"
+    "         [--avs-est rolling|ew] [--avs-window N] [--avs-halflife N]\n");
 }
 
 static bool parse_args(int argc, char** argv, Args& a) {
@@ -43,30 +100,226 @@ static bool parse_args(int argc, char** argv, Args& a) {
     else if (eq("--results")) a.results = next();
     else if (eq("--latency")) a.latency = next();
     else if (eq("--histo")) a.histo = next();
+    else if (eq("--histo-bits")) a.histo_bits = std::atoi(next());
+    else if (eq("--probe-stats")) a.probe_stats = next();
+    else if (eq("--itch")) a.itch = next();
+    else if (eq("--itch-framing")) a.itch_framing = next();
+    else if (eq("--symbols")) a.symbols = next();
+    else if (eq("--book-orders")) a.book_orders = std::atoll(next());
+    else if (eq("--book-levels")) a.book_levels = std::atoll(next());
+    else if (eq("--book-lazy")) a.book_lazy = true;
+    else if (eq("--id-window")) a.id_window = std::atoll(next());
+    else if (eq("--batch")) a.batch = std::atoi(next());
+    else if (eq("--batch-ahead")) a.batch_ahead = std::atoi(next());
     else if (eq("--pinner")) a.core = std::atoi(next());
     else if (eq("--warmup")) a.warmup = std::atoi(next());
     else if (eq("--max-msgs")) a.max_msgs = std::atoi(next());
+    else if (eq("--load-threads")) a.load_threads = std::atoi(next());
+    else if (eq("--start-event")) a.start_event = std::atoll(next());
+    else if (eq("--start-ts")) a.start_ts = std::atoll(next());
+    else if (eq("--stream")) a.stream = true;
+    else if (eq("--pipeline")) a.pipeline = true;
+    else if (eq("--book-core")) a.book_core = std::atoi(next());
+    else if (eq("--producer-core")) a.producer_core = std::atoi(next());
+    else if (eq("--ring-size")) a.ring_size = std::atoi(next());
+    else if (eq("--wait")) a.wait = next();
+    else if (eq("--clock")) a.clock = next();
+    else if (eq("--perf-sample")) a.perf_sample = std::atoi(next());
+    else if (eq("--perf-csv")) a.perf_csv = next();
+    else if (eq("--trace")) a.trace = next();
+    else if (eq("--trace-cap")) a.trace_cap = std::atoll(next());
+    else if (eq("--trace-every")) a.trace_every = std::atoi(next());
+    else if (eq("--trace-slow-us")) a.trace_slow_us = std::atof(next());
+    else if (eq("--trace-context")) a.trace_context = std::atoi(next());
+    else if (eq("--shards")) a.shards = std::atoi(next());
+    else if (eq("--shard-cores")) {
+      for (const char* p = next(); p && *p; ) {
+        char* e = nullptr;
+        a.shard_cores.push_back(static_cast<int>(std::strtol(p, &e, 10)));
+        p = (e && *e == ',') ? e + 1 : e;
+      }
+    }
     else if (eq("--inv-cap")) a.inv_cap = std::atoi(next());
     else if (eq("--throttle")) a.throttle = std::atoi(next());
     else if (eq("--mode")) a.mode = next();
     else if (eq("--avs-gamma")) a.avs_gamma = std::atof(next());
     else if (eq("--avs-k")) a.avs_k = std::atof(next());
     else if (eq("--avs-horizon")) a.avs_horizon = std::atof(next());
+    else if (eq("--avs-est")) a.avs_est = next();
+    else if (eq("--avs-window")) a.avs_window = std::atoi(next());
+    else if (eq("--avs-halflife")) a.avs_halflife = std::atof(next());
     else { std::fprintf(stderr, "Unknown arg: %s\n", argv[i]); return false; }
   }
-  if (a.replay.empty()) { usage(); return false; }
+  if (a.replay.empty() == a.itch.empty()) { usage(); return false; }
+  if (a.itch_framing != "auto" && a.itch_framing != "raw" && a.itch_framing != "len") { usage(); return false; }
+  if (a.avs_est != "rolling" && a.avs_est != "ew") { usage(); return false; }
+  if (a.clock != "tsc" && a.clock != "steady") { usage(); return false; }
+  if (a.histo_bits < 1 || a.histo_bits > 16) { usage(); return false; }
+  if (a.avs_window < 64) a.avs_window = 64;
+  // EwOu's weight sum tends to 1/(1 - 2^(-1/h)), which exceeds the 2 degrees
+  // of freedom the fit needs only for h > 1 (h <= 0: expanding window)
+  if (a.avs_halflife > 0.0 && a.avs_halflife <= 1.0) {
+    std::fprintf(stderr, "--avs-halflife must be > 1 sample (or <= 0 for an expanding window)\n");
+    return false;
+  }
+  if (a.load_threads < 1) a.load_threads = 1;
+  if (a.start_event >= 0 && a.start_ts >= 0) { usage(); return false; }
+  if (a.ring_size < 2) a.ring_size = 2;
+  if (a.book_levels == 0 || a.book_levels > static_cast<long long>(lob::LevelBitmap::MAX_BITS)) {
+    std::fprintf(stderr, "--book-levels must be in [1, %zu]\n", lob::LevelBitmap::MAX_BITS);
+    return false;
+  }
+  if (a.pipeline) a.stream = true;   // pipeline = stream + a book/signal thread
+  if (a.shards > 0 && (a.stream || a.mode != "heuristic")) {
+    std::fprintf(stderr, "--shards runs its own dispatcher (no --stream/--pipeline) and heuristic mode only\n");
+    return false;
+  }
+  if (a.batch > 0 && (a.stream || a.shards > 0)) {
+    std::fprintf(stderr, "--batch is a serial-mode option (no --stream/--pipeline/--shards)\n");
+    return false;
+  }
+  if (a.batch_ahead < 0) a.batch_ahead = 0;
+  if (a.perf_sample < 0) a.perf_sample = 0;
+  if (a.perf_sample > 0 && a.shards > 0) {
+    std::fprintf(stderr, "--perf-sample counts the serial, --batch, --stream and --pipeline stages (no --shards)\n");
+    return false;
+  }
+  if (!a.trace.empty() && a.shards > 0) {
+    std::fprintf(stderr, "--trace records on the thread that finishes each event (no --shards)\n");
+    return false;
+  }
+  if (a.trace_cap < 1 || a.trace_every < 1 || a.trace_slow_us < 0.0 || a.trace_context < 0) { usage(); return false; }
+  ring::WaitPolicy wp{};
+  if (!ring::parse_wait_policy(a.wait, wp)) { usage(); return false; }
   return true;
 }
 
-struct PnL {
-  int inv{0};
-  double pnl{0.0};
-  void on_exec(int32_t px, int32_t qty, bool is_buy) {
-    inv += is_buy ? qty : -qty;
-    pnl += (is_buy ? -1.0 : 1.0) * static_cast<double>(px) * static_cast<double>(qty);
+// id-map probe-length histogram per side, summed over every instrument's
+// book in every manager (after the run, off the hot path)
+static bool write_probe_stats(const std::string& path, const std::vector<const lob::BookManager*>& mgrs) {
+  FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return false;
+  std::fputs("side,probe,count\n", f);
+  for (const bool bid : {true, false}) {
+    lob::Lob::IdMap::ProbeStats st;
+    double probe_sum = 0.0;
+    for (const lob::BookManager* books : mgrs) for (size_t b = 0; b < books->size(); ++b) {
+      const auto one = books->at(b).id_map_stats(bid);
+      st.size     += one.size;
+      st.capacity += one.capacity;
+      st.max_probe = std::max(st.max_probe, one.max_probe);
+      probe_sum   += one.mean_probe * static_cast<double>(one.size);
+      if (st.hist.size() < one.hist.size()) st.hist.resize(one.hist.size(), 0);
+      for (size_t d = 0; d < one.hist.size(); ++d) st.hist[d] += one.hist[d];
+    }
+    st.mean_probe = st.size ? probe_sum / static_cast<double>(st.size) : 0.0;
+    for (size_t d = 0; d < st.hist.size(); ++d) {
+      std::fprintf(f, "%s,%zu,%llu\n", bid ? "bid" : "ask", d, (unsigned long long)st.hist[d]);
+    }
+    std::fprintf(stderr, "[idmap] %s size=%zu cap=%zu mean_probe=%.3f max_probe=%zu\n",
+                 bid ? "bid" : "ask", st.size, st.capacity, st.mean_probe, st.max_probe);
+  }
+  size_t window = 0, live = 0, hashed = 0;
+  for (const lob::BookManager* books : mgrs) for (size_t b = 0; b < books->size(); ++b) {
+    window = std::max(window, books->at(b).id_window());
+    live   += books->at(b).live_orders();
+    hashed += books->at(b).hashed_ids();
+  }
+  if (window > 0) {
+    std::fprintf(stderr, "[idtable] window=%zu live=%zu direct=%zu hashed=%zu\n",
+                 window, live, live - hashed, hashed);
   }
+  std::fclose(f);
+  return true;
+}
+
+// --perf-sample: counter deltas per stage, summed over sampled events.
+// parse is only counted when the main thread decodes (serial mode); in
+// --pipeline lob and sig run on the book thread, under its own counters.
+struct PerfStages {
+  perf::StageCounts parse, lob, sig, risk, encode;
 };
 
+// Per-stage table (stdout) and optional CSV: means per sampled event, net
+// of the snapshot cost on the thread that ran the stage.
+static void report_perf(const std::string& csv_path, int every, const PerfStages& ps,
+                        const perf::Group& main_g, const perf::Group& book_g) {
+  const perf::Group& bg = book_g.ok() ? book_g : main_g;
+  struct Row { const char* stage; const perf::StageCounts& c; const perf::Group& g; };
+  const Row rows[] = {{"parse", ps.parse, main_g}, {"lob", ps.lob, bg}, {"sig", ps.sig, bg},
+                      {"risk", ps.risk, main_g}, {"encode", ps.encode, main_g}};
+  FILE* f = csv_path.empty() ? nullptr : std::fopen(csv_path.c_str(), "wb");
+  if (!csv_path.empty() && !f) std::perror("fopen(perf-csv)");
+  if (f) std::fputs("stage,events,cycles,instructions,ipc,l1d_miss,llc_miss,branch_miss,dtlb_miss\n", f);
+  std::printf("Counters per event (1 in %d sampled, %s):\n", every, main_g.rdpmc() ? "rdpmc" : "read()");
+  std::printf("  %-6s %8s %8s %5s %8s %8s %8s %9s\n", "stage", "events", "cycles", "IPC",
+              "L1D-miss", "LLC-miss", "br-miss", "dTLB-miss");
+  for (const Row& r : rows) {
+    if (r.c.events == 0) continue;
+    const perf::Snapshot& o = r.g.overhead();
+    std::printf("  %-6s %8llu", r.stage, (unsigned long long)r.c.events);
+    if (f) std::fprintf(f, "%s,%llu", r.stage, (unsigned long long)r.c.events);
+    for (const perf::Counter k : {perf::Cycles, perf::Instructions, perf::L1dMiss, perf::LlcMiss,
+                                  perf::BranchMiss, perf::DtlbMiss}) {
+      if (k == perf::Instructions) {   // shown as IPC
+        if (r.g.has(k)) std::printf(" %5.2f", r.c.ipc(o));
+        else            std::printf(" %5s", "-");
+        if (f) {
+          if (r.g.has(k)) std::fprintf(f, ",%.3f,%.3f", r.c.per_event(k, o), r.c.ipc(o));
+          else            std::fputs(",,", f);
+        }
+        continue;
+      }
+      const int w = k == perf::DtlbMiss ? 9 : 8;
+      if (r.g.has(k)) std::printf(" %*.2f", w, r.c.per_event(k, o));
+      else            std::printf(" %*s", w, "-");
+      if (f) {
+        if (r.g.has(k)) std::fprintf(f, ",%.3f", r.c.per_event(k, o));
+        else            std::fputs(",", f);
+      }
+    }
+    std::printf("\n");
+    if (f) std::fputc('\n', f);
+  }
+  if (f) std::fclose(f);
+  for (const perf::Group* g : {&main_g, &book_g}) {
+    const double run = g->running_fraction();
+    if (g->ok() && run < 0.99) {
+      std::fprintf(stderr, "[perf] %s thread counters were on the PMU %.0f%% of the time (multiplexed); "
+                   "counts are approximate\n", g == &main_g ? "main" : "book", run * 100.0);
+    }
+  }
+}
+
+// Streaming mode: one decoded event, when the feed handler first saw it
+// (ingress, before decoding) and when it entered the ring (decode egress),
+// in timing::now_ticks.
+struct Handoff {
+  itch::Event ev;
+  uint64_t    t_ingress;
+  uint64_t    t_push;
+};
+
+// Book + signal result for one event: everything risk + encode needs
+// (64 bytes; the book -> risk ring in --pipeline).
+struct QuoteRec {
+  uint64_t   ts_ns;
+  uint64_t   t_ingress;    // ticks, as Handoff
+  uint64_t   t_push;       // --pipeline: signal egress, entering the ring
+  double     pnl;
+  sig::Quote q;
+  uint32_t   order_id;
+  int32_t    inv;
+  uint32_t   svc;          // service ticks of the stages already run elsewhere
+  char       type;
+  bool       side;
+};
+static_assert(sizeof(QuoteRec) == 64, "QuoteRec is one cache line in the --pipeline ring");
+
+static inline uint32_t clamp_ticks(uint64_t t) {
+  return t < UINT32_MAX ? static_cast<uint32_t>(t) : UINT32_MAX;
+}
+
 // fast append of one CSV line for outputs
 static inline int write_line(FILE* f, uint64_t ts_ns, char ev, uint32_t oid, bool side,
                              int32_t px, int32_t qty, int inv_after, double notional_after) {
@@ -84,24 +337,133 @@ int main(int argc, char** argv) {
     affinity::pin_to_core(args.core, &info);
     std::fprintf(stderr, "[pin] %s\n", info.c_str());
   }
+  // Stage samples are raw ticks; converted when reported.
+  const tsc::Info& clk = tsc::init(args.clock == "tsc");
 
+  // Event source: pre-parsed CSV rows, a mapped .t2tb cache, or binary ITCH
+  // decoded in place. --stream reads CSV row by row instead of preloading.
   itch::Replay rep;
+  itch::CsvCursor csv;
+  itch::T2tbFile cache;
+  itch::Itch5File bin;
+  itch::Itch5Cursor cur;
+  const bool use_bin = !args.itch.empty();
+  const bool use_cache = !use_bin && itch::t2tb::sniff(args.replay);
+  const bool use_csv_cursor = args.stream && !use_bin && !use_cache;
+  if ((args.start_event >= 0 || args.start_ts >= 0) && !use_cache) {
+    std::fprintf(stderr, "--start-event/--start-ts need a .t2tb replay\n");
+    return 2;
+  }
   std::string err;
-  if (!rep.load_csv(args.replay, static_cast<size_t>(args.max_msgs), &err)) {
-    std::fprintf(stderr, "replay load error: %s\n", err.c_str());
+  size_t N = 0, first = 0;
+  if (use_cache) {
+    if (!cache.open(args.replay, &err)) {
+      std::fprintf(stderr, "replay load error: %s\n", err.c_str());
+      return 3;
+    }
+    if (args.start_event >= 0) first = std::min(cache.size(), static_cast<size_t>(args.start_event));
+    if (args.start_ts >= 0)    first = cache.seek_time(static_cast<uint64_t>(args.start_ts));
+    N = cache.size() - first;
+    if (args.max_msgs > 0) N = std::min(N, static_cast<size_t>(args.max_msgs));
+  } else if (use_bin) {
+    const auto fr = args.itch_framing == "raw" ? itch::itch5::Framing::Raw
+                  : args.itch_framing == "len" ? itch::itch5::Framing::LengthPrefixed
+                                               : itch::itch5::Framing::Auto;
+    if (!bin.open(args.itch, fr, &err)) {
+      std::fprintf(stderr, "itch open error: %s\n", err.c_str());
+      return 3;
+    }
+    N = bin.count_events();
+    if (args.max_msgs > 0) N = std::min(N, static_cast<size_t>(args.max_msgs));
+    cur = bin.cursor();
+  } else if (use_csv_cursor) {
+    if (!csv.open(args.replay, &err)) {
+      std::fprintf(stderr, "replay load error: %s\n", err.c_str());
+      return 3;
+    }
+    N = csv.count_rows();
+    if (args.max_msgs > 0) N = std::min(N, static_cast<size_t>(args.max_msgs));
+  } else {
+    itch::Replay::LoadStats ls;
+    if (!rep.load_csv_parallel(args.replay, static_cast<size_t>(args.max_msgs),
+                               static_cast<unsigned>(args.load_threads), &err, &ls)) {
+      std::fprintf(stderr, "replay load error: %s\n", err.c_str());
+      return 3;
+    }
+    N = rep.events.size();
+    if (args.load_threads > 1) {
+      std::fprintf(stderr, "[load] %zu rows in %.2f ms (alloc %.2f ms)\n", N,
+                   static_cast<double>(ls.total_ns) / 1e6, static_cast<double>(ls.alloc_ns) / 1e6);
+      for (size_t k = 0; k < ls.workers.size(); ++k) {
+        const auto& w = ls.workers[k];
+        std::fprintf(stderr, "[load] worker %zu bytes=%zu rows=%zu count=%.2f ms parse=%.2f ms\n",
+                     k, w.bytes, w.rows, static_cast<double>(w.count_ns) / 1e6,
+                     static_cast<double>(w.parse_ns) / 1e6);
+      }
+    }
+  }
+
+  // Instrument directory (--symbols, then any ITCH 'R' messages) sizes each
+  // book; books are created on an instrument's first event.
+  itch::SymbolDirectory dir;
+  if (!args.symbols.empty() && !dir.load_csv(args.symbols, &err)) {
+    std::fprintf(stderr, "symbols load error: %s\n", err.c_str());
     return 3;
   }
+  if (use_bin) dir.load_itch5(bin);
+  lob::BookSpec def_spec;
+  if (args.book_orders >= 0) def_spec.max_orders = static_cast<size_t>(args.book_orders);
+  if (args.book_levels > 0)  def_spec.max_levels = static_cast<size_t>(args.book_levels);
+  def_spec.prefault = !args.book_lazy;
+  if (args.id_window > 0) def_spec.id_window = static_cast<size_t>(args.id_window);
+  lob::BookManager books(def_spec);
+  std::vector<std::pair<uint16_t, lob::BookSpec>> specs;
+  for (const auto& s : dir.entries()) {
+    if (s.max_orders == 0 && s.max_levels == 0) continue;
+    if (s.max_levels > lob::LevelBitmap::MAX_BITS) {
+      std::fprintf(stderr, "symbols: %s max_levels %zu exceeds %zu\n", s.symbol.c_str(),
+                   s.max_levels, lob::LevelBitmap::MAX_BITS);
+      return 3;
+    }
+    specs.emplace_back(s.locate, lob::BookSpec{s.max_orders ? s.max_orders : def_spec.max_orders,
+                                               s.max_levels ? s.max_levels : def_spec.max_levels,
+                                               def_spec.prefault, def_spec.id_window});
+  }
+  for (const auto& [loc, sp] : specs) books.set_spec(loc, sp);
+  books.reserve(std::max<size_t>(dir.size(), 1));
 
-  const size_t N = rep.events.size();
-  lob::Lob book;
   sig::MM mm;
   risk::Risk rg; rg.configure(args.inv_cap, args.notional_cap, args.throttle);
-  PnL pnl;
+  risk::PnL pnl;
 
-  std::vector<double>   mids; mids.reserve(N);
-  std::vector<uint64_t> ts;   ts.reserve(N);
+  // Incremental OU estimators for --mode avs (O(1) per mid, no allocation).
+  const bool use_ew = (args.avs_est == "ew");
+  stoch::RollingOu ou_roll(static_cast<size_t>(args.avs_window));
+  stoch::EwOu      ou_ew(stoch::EwOu::lambda_from_halflife(args.avs_halflife));
+
+  // Stage histograms always; raw per-event samples only for --latency.
+  timing::StageTimers st(static_cast<size_t>(std::max(args.warmup, 0)), args.latency.empty() ? 0 : N + 16,
+                         args.stream, static_cast<unsigned>(args.histo_bits));
+
+  // --perf-sample: each thread that runs stages counts on its own group
+  // (opened on that thread); unavailable counters only cost a warning.
+  PerfStages pst;
+  const uint64_t perf_skip = static_cast<uint64_t>(std::max(args.warmup, 0));
+  perf::Sampler main_pc(static_cast<unsigned>(args.perf_sample), perf_skip);
+  perf::Sampler book_pc(args.pipeline ? static_cast<unsigned>(args.perf_sample) : 0u, perf_skip);
+  if (args.perf_sample > 0) {
+    std::string why;
+    if (!main_pc.open(&why)) std::fprintf(stderr, "[perf] counters unavailable: %s\n", why.c_str());
+  }
 
-  timing::StageTimers st(N + 16);
+  // Event i from whichever source is active (preload loop or producer).
+  auto next_event = [&](size_t i, itch::Event& ev) -> bool {
+    if (use_bin)        return cur.next(ev);
+    if (use_csv_cursor) return csv.next(ev);
+    if (use_cache)      { ev = cache.at(first + i); return true; }
+    ev = rep.events[i];
+    return true;
+  };
 
   // Buffered CSV output via stdio with user buffer (created before guard)
   FILE* fout = std::fopen(args.results.c_str(), "wb");
@@ -111,102 +473,481 @@ int main(int argc, char** argv) {
   std::setvbuf(fout, outbuf, _IOFBF, BUF_SZ);
   std::fputs("ts_ns,event,order_id,side,px,qty,inv_after,notional_after\n", fout);
 
-  // histogram edges in microseconds
-  std::vector<uint32_t> edges = {1,2,5,10,20,50,80,100,200,500,1000};
-  histo::AllStageHistos H(edges);
-
-  size_t processed = 0;
-  bool guard_enabled = false;
-
-  for (size_t i=0; i<N; ++i) {
-    const auto& ev = rep.events[i];
-
-    if (!guard_enabled && processed >= static_cast<size_t>(args.warmup)) {
-      nomalloc::enable_guard();
-      guard_enabled = true;
-    }
-
-    { timing::ScopedTimer T(st.parse); /* already parsed */ }
-
-    { timing::ScopedTimer T(st.lob);
-      if (ev.type == itch::EvType('A')) {
-        book.add({ev.ts_ns, ev.order_id, ev.px, ev.qty, ev.side});
-      } else if (ev.type == itch::EvType('C')) {
-        book.cancel(ev.order_id); mm.on_cancel();
-      } else { // Exec
-        mm.on_exec();
-        pnl.on_exec(ev.px, ev.qty, !ev.side);
-        book.cancel(ev.order_id);
-      }
+  // Signal for one event already applied to its book: MM flow counters,
+  // P&L on fills (what the book says the exec took, see engine::apply),
+  // OU mid, quote.
+  auto signal = [&](const itch::Event& ev, const lob::Lob& book, const lob::Fill& fill, QuoteRec& r) {
+    if (ev.type == itch::EvType::Cancel || ev.type == itch::EvType::Reduce) {
+      mm.on_cancel();
+    } else if (ev.type == itch::EvType::Exec) {
+      mm.on_exec();
+      if (fill.qty > 0) pnl.on_exec(fill.px, fill.qty, !fill.is_buy);
     }
 
     const int bb = book.best_bid();
     const int aa = book.best_ask();
     if (bb != INT32_MIN && aa != INT32_MAX) {
       const int32_t mid = static_cast<int32_t>((bb + aa) / 2);
-      mids.push_back(static_cast<double>(mid));
-      ts.push_back(ev.ts_ns);
+      if (use_ew) ou_ew.push(ev.ts_ns, static_cast<double>(mid));
+      else        ou_roll.push(ev.ts_ns, static_cast<double>(mid));
     }
 
     sig::Quote q{};
-    { timing::ScopedTimer T(st.sig);
-      if (args.mode == "avs" && mids.size() >= 64u) {
-        const size_t M = mids.size();
-        double dt_s = 1e-3;
-        if (M > 1u) {
-          dt_s = (static_cast<double>(ts[M-1] - ts[0]) / 1e9) / static_cast<double>(M-1);
-          if (dt_s <= 0.0) dt_s = 1e-3;
-        }
-        const stoch::OuParams ou = stoch::fit_ou(mids, dt_s);
+    {
+      // avs quotes once the estimator has 64 mids and enough weight for a
+      // fit, and only from a usable fit; otherwise the heuristic quotes
+      const size_t M     = use_ew ? ou_ew.size()  : ou_roll.size();
+      const bool   ready = use_ew ? ou_ew.ready() : ou_roll.ready();
+      stoch::OuParams ou{};
+      if (args.mode == "avs" && M >= 64u && ready) ou = use_ew ? ou_ew.params() : ou_roll.params();
+      if (stoch::usable(ou)) {
+        const double s_mid = use_ew ? ou_ew.last() : ou_roll.last();
         const stoch::AvsParams avp{args.avs_gamma, args.avs_k, args.avs_horizon};
-        const auto pxs = stoch::avellaneda_stoikov(mids.back(), pnl.inv, ou, avp);
+        const auto pxs = stoch::avellaneda_stoikov(s_mid, pnl.inv, ou, avp);
         q = sig::Quote{pxs.bid_px, pxs.ask_px, 1, 1};
       } else {
         q = mm.quote(book, /*q_alpha=*/0.01, /*skew=*/2.0, pnl.inv, args.inv_cap);
       }
     }
 
-    bool allowed = false;
-    { timing::ScopedTimer T(st.risk);
-      allowed = rg.allow(q, pnl.inv, args.inv_cap, args.notional_cap, ev.ts_ns);
+    r.ts_ns    = ev.ts_ns;
+    r.pnl      = pnl.pnl;
+    r.q        = q;
+    r.order_id = ev.order_id;
+    r.inv      = pnl.inv;
+    r.type     = static_cast<char>(ev.type);
+    r.side     = ev.side;
+  };
+
+  // --trace: the main thread fills one trace::Record per event as its
+  // stages run and hands it to the recorder after encode, which keeps the
+  // sampled or slow ones. The ring is mapped here, before the alloc guard.
+  std::unique_ptr<trace::Recorder> tracer;
+  if (!args.trace.empty()) {
+    trace::Config tc;
+    tc.capacity   = static_cast<size_t>(args.trace_cap);
+    tc.every      = static_cast<uint32_t>(args.trace_every);
+    tc.slow_ticks = static_cast<uint64_t>(args.trace_slow_us * 1e3 / clk.ns_per_tick);
+    tc.context    = static_cast<uint32_t>(args.trace_context);
+    tracer = std::make_unique<trace::Recorder>(tc);
+    if (!tracer->ok()) { std::fprintf(stderr, "trace: cannot map %lld records\n", args.trace_cap); return 4; }
+  }
+  trace::Record trec{};
+  size_t processed = 0;
+
+  // Stages are timed between egress marks (timing::StageTimers): t is the
+  // last mark on the calling thread and moves to this stage's egress. ps is
+  // the thread's counter sampler when this event is sampled, else null; tr
+  // is the event's trace record when tracing on this thread, else null.
+
+  // LOB update + signal for one event (book thread in --pipeline).
+  auto book_and_signal = [&](const itch::Event& ev, QuoteRec& r, uint64_t& t, perf::Sampler* ps,
+                             trace::Record* tr) {
+    lob::Lob& book = engine::book_for(books, ev.locate);
+    lob::Fill fill;
+    engine::apply(book, ev, &fill);
+    const uint64_t t_book = timing::now_ticks();
+    st.lob.push(t_book - t);
+    if (ps) ps->charge(pst.lob);
+    if (tr) {
+      tr->mark[trace::Lob] = clamp_ticks(t_book - r.t_ingress);
+      tr->best_bid = book.best_bid();
+      tr->best_ask = book.best_ask();
+    }
+    signal(ev, book, fill, r);
+    t = timing::now_ticks();
+    st.sig.push(t - t_book);
+    if (ps) ps->charge(pst.sig);
+    if (tr) tr->mark[trace::Sig] = clamp_ticks(t - r.t_ingress);
+  };
+
+  // Risk gate + encode (main thread in every mode), then ingress -> output
+  // ready for the event. t_pick is when this thread took the event up; its
+  // service is t_pick -> output plus r.svc from earlier threads. Returns
+  // the output-ready mark.
+  auto risk_and_encode = [&](const QuoteRec& r, uint64_t t_pick, uint64_t t,
+                             perf::Sampler* ps, trace::Record* tr) -> uint64_t {
+    const bool allowed = rg.allow(r.q, r.inv, args.inv_cap, args.notional_cap, r.ts_ns);
+    const uint64_t t_risk = timing::now_ticks();
+    st.risk.push(t_risk - t);
+    if (ps) ps->charge(pst.risk);
+    if (allowed) {
+      write_line(fout, r.ts_ns, r.type, r.order_id, r.side,
+                 r.q.bid_px, r.q.bid_qty, r.inv, r.pnl);
+    }
+    const uint64_t t_out = timing::now_ticks();
+    st.encode.push(t_out - t_risk);
+    if (ps) ps->charge(pst.encode);
+    const uint64_t e2e = t_out - r.t_ingress;
+    st.split(e2e, r.svc + (t_out - t_pick));
+    if (tr) {
+      tr->seq                 = processed;
+      tr->t_ingress           = r.t_ingress;
+      tr->mark[trace::Risk]   = clamp_ticks(t_risk - r.t_ingress);
+      tr->mark[trace::Encode] = clamp_ticks(e2e);
+      tr->order_id            = r.order_id;
+      tr->bid_px              = r.q.bid_px;
+      tr->ask_px              = r.q.ask_px;
+      tr->inv                 = r.inv;
+      tr->type                = static_cast<uint8_t>(r.type);
+      tr->side                = r.side ? 1 : 0;
+      tr->allowed             = allowed ? 1 : 0;
+      tracer->record(*tr);
+    }
+    return t_out;
+  };
+
+  // --stream / --pipeline: a producer thread parses/decodes into ring and
+  // times each event into st.parse. With --stream the loop below pops and
+  // runs book+signal itself; with --pipeline a book thread does that and
+  // forwards QuoteRecs over qring. Each pop times push->pop (st.handoff,
+  // st.handoff2); ingress marks and service so far travel with the event. Rings,
+  // threads and pins are set up before the alloc guard.
+  ring::SpscRing<Handoff>  ring(std::bit_ceil(static_cast<size_t>(args.ring_size)));
+  ring::SpscRing<QuoteRec> qring(args.pipeline ? std::bit_ceil(static_cast<size_t>(args.ring_size)) : 1u);
+  std::atomic<int> threads_ready{0};
+  std::atomic<bool> producer_done{false}, book_done{false};
+  ring::WaitPolicy wp{};
+  ring::parse_wait_policy(args.wait, wp);
+  ring::Waiter data_wait(wp), space_wait(wp);     // event ring: consumer / producer side
+  ring::Waiter qdata_wait(wp), qspace_wait(wp);   // quote ring
+  auto pin_thread = [](int core, const char* who) {
+    if (core < 0) return;
+    std::string info;
+    affinity::pin_to_core(core, &info);
+    std::fprintf(stderr, "[pin] %s %s\n", who, info.c_str());
+  };
+  std::thread producer, book_thread;
+  if (args.stream) {
+    producer = std::thread([&] {
+      pin_thread(args.producer_core, "producer");
+      threads_ready.fetch_add(1, std::memory_order_release);
+      for (size_t i = 0; i < N; ++i) {
+        Handoff h;
+        h.t_ingress = timing::now_ticks();
+        if (!next_event(i, h.ev)) break;
+        h.t_push = timing::now_ticks();
+        st.parse.push(h.t_push - h.t_ingress);
+        space_wait.wait([&] { return ring.try_push(h); });
+        data_wait.notify();
+      }
+      producer_done.store(true, std::memory_order_release);
+      data_wait.notify();
+    });
+  }
+  auto pop_next = [&](Handoff& h) -> bool {
+    bool got = false;
+    data_wait.wait([&] {
+      got = ring.try_pop(h);
+      return got || producer_done.load(std::memory_order_acquire);
+    });
+    if (!got) got = ring.try_pop(h);   // anything pushed before done
+    if (got) space_wait.notify();
+    return got;
+  };
+  if (args.pipeline) {
+    book_thread = std::thread([&] {
+      pin_thread(args.book_core, "book");
+      std::string why;
+      if (args.perf_sample > 0 && !book_pc.open(&why)) {
+        std::fprintf(stderr, "[perf] book thread counters unavailable: %s\n", why.c_str());
+      }
+      threads_ready.fetch_add(1, std::memory_order_release);
+      Handoff h{};
+      while (pop_next(h)) {
+        const uint64_t t_pick = timing::now_ticks();
+        st.handoff.push(t_pick - h.t_push);
+        perf::Sampler* ps = book_pc.sample() ? &book_pc : nullptr;
+        QuoteRec r;
+        uint64_t t = t_pick;
+        book_and_signal(h.ev, r, t, ps, nullptr);
+        r.t_ingress = h.t_ingress;
+        r.svc       = clamp_ticks((h.t_push - h.t_ingress) + (t - t_pick));
+        r.t_push    = t;
+        qspace_wait.wait([&] { return qring.try_push(r); });
+        qdata_wait.notify();
+      }
+      book_done.store(true, std::memory_order_release);
+      qdata_wait.notify();
+    });
+  }
+  const int n_threads = (args.stream ? 1 : 0) + (args.pipeline ? 1 : 0);
+  while (threads_ready.load(std::memory_order_acquire) < n_threads) std::this_thread::yield();
+  auto pop_quote = [&](QuoteRec& r) -> bool {
+    bool got = false;
+    qdata_wait.wait([&] {
+      got = qring.try_pop(r);
+      return got || book_done.load(std::memory_order_acquire);
+    });
+    if (!got) got = qring.try_pop(r);
+    if (got) qspace_wait.notify();
+    return got;
+  };
+
+  // --shards: this thread decodes and dispatches by locate; each worker runs
+  // book + signal + risk for its instruments and logs one decision per event
+  // (merged in dispatch order after the run, so output does not depend on N).
+  std::unique_ptr<engine::ShardedEngine> eng;
+  if (args.shards > 0) {
+    engine::Config ec;
+    ec.shards       = static_cast<unsigned>(args.shards);
+    ec.cores        = args.shard_cores;
+    ec.ring_size    = std::bit_ceil(static_cast<size_t>(args.ring_size));
+    ec.wait         = wp;
+    ec.book         = def_spec;
+    ec.inv_cap      = args.inv_cap;
+    ec.notional_cap = args.notional_cap;
+    ec.throttle     = args.throttle;
+    eng = std::make_unique<engine::ShardedEngine>(ec);
+    for (const auto& [loc, sp] : specs) eng->set_spec(loc, sp);
+    // Each shard's log gets room for exactly its share of the N events (one
+    // pass over the locates; the hot loop then never allocates or drops).
+    std::vector<size_t> share(eng->shards(), 0);
+    if (use_bin) {
+      itch::Itch5Cursor c = bin.cursor();
+      itch::Event ev{};
+      for (size_t i = 0; i < N && c.next(ev); ++i) ++share[eng->shard_of(ev.locate)];
+    } else {
+      for (size_t i = 0; i < N; ++i) {
+        ++share[eng->shard_of(use_cache ? cache.at(first + i).locate : rep.events[i].locate)];
+      }
+    }
+    for (unsigned k = 0; k < eng->shards(); ++k) eng->reserve_log(k, share[k]);
+    eng->start();
+  }
+
+  bool guard_enabled = false;
+  std::vector<itch::Event> batch(static_cast<size_t>(std::max(args.batch, 0)));
+  std::vector<uint64_t> batch_in(batch.size()), batch_parse(batch.size());   // per event: ingress, parse ticks
+  const uint64_t t_run0 = timing::now_ns();
+
+  // --batch: decode up to K events, then apply them with lookahead
+  // prefetching (engine::apply_batch); signal, risk and encode still run per
+  // event, in order. st.lob covers each event's prefetch hints + update;
+  // an event's wait for the rest of its batch to decode counts as queueing.
+  for (size_t i = 0; !batch.empty() && i < N; ) {
+    if (!guard_enabled && processed >= static_cast<size_t>(args.warmup)) {
+      nomalloc::enable_guard();
+      guard_enabled = true;
+    }
+    size_t k = 0;
+    bool more = true;
+    for (; k < batch.size() && i < N; ++k, ++i) {
+      batch_in[k] = timing::now_ticks();
+      if (!next_event(i, batch[k])) { more = false; break; }
+      batch_parse[k] = timing::now_ticks() - batch_in[k];
+      st.parse.push(batch_parse[k]);
+    }
+    uint64_t t = timing::now_ticks();
+    perf::Sampler* ps = main_pc.sample() ? &main_pc : nullptr;   // for the next event
+    size_t j = 0;
+    engine::apply_batch(books, std::span<const itch::Event>(batch.data(), k),
+                        [&](const itch::Event& ev, const lob::Lob& book, const lob::Fill& fill) {
+      const uint64_t t_pick = t;
+      const uint64_t t_book = timing::now_ticks();
+      st.lob.push(t_book - t);
+      if (ps) ps->charge(pst.lob);
+      QuoteRec r{};
+      r.t_ingress = batch_in[j];
+      r.svc       = clamp_ticks(batch_parse[j]);
+      trace::Record* tr = nullptr;
+      if (tracer) {
+        trec = trace::Record{};
+        trec.mark[trace::Parse] = r.svc;
+        trec.mark[trace::Lob]   = clamp_ticks(t_book - r.t_ingress);
+        trec.best_bid = book.best_bid();
+        trec.best_ask = book.best_ask();
+        tr = &trec;
+      }
+      ++j;
+      signal(ev, book, fill, r);
+      t = timing::now_ticks();
+      st.sig.push(t - t_book);
+      if (ps) ps->charge(pst.sig);
+      if (tr) tr->mark[trace::Sig] = clamp_ticks(t - r.t_ingress);
+      t = risk_and_encode(r, t_pick, t, ps, tr);
+      ps = (j < k && main_pc.sample()) ? &main_pc : nullptr;
+      ++processed;
+    }, static_cast<size_t>(args.batch_ahead));
+    if (!more) break;
+  }
+
+  for (size_t i = 0; batch.empty() && i < N; ++i) {
+    if (!guard_enabled && processed >= static_cast<size_t>(args.warmup)) {
+      nomalloc::enable_guard();
+      guard_enabled = true;
+    }
+
+    if (eng) {
+      itch::Event ev{};
+      const uint64_t t_in = timing::now_ticks();
+      if (!next_event(i, ev)) break;
+      st.parse.push(timing::now_ticks() - t_in);
+      eng->dispatch(ev, t_in);
+      ++processed;
+      continue;
     }
 
-    { timing::ScopedTimer T(st.e2e);
-      if (allowed) {
-        write_line(fout, ev.ts_ns, static_cast<char>(ev.type), ev.order_id, ev.side,
-                   q.bid_px, q.bid_qty, pnl.inv, pnl.pnl);
+    // t_pick: this thread took the event up (ingress when it decodes too)
+    QuoteRec r{};
+    uint64_t t_pick = 0, t = 0;
+    perf::Sampler* ps = nullptr;
+    trace::Record* tr = nullptr;
+    if (tracer) {
+      trec = trace::Record{};
+      tr = &trec;
+    }
+    if (args.pipeline) {
+      if (!pop_quote(r)) break;
+      t_pick = t = timing::now_ticks();
+      st.handoff2.push(t - r.t_push);
+      if (main_pc.sample()) ps = &main_pc;
+      if (tr) {
+        tr->mark[trace::Sig] = clamp_ticks(r.t_push - r.t_ingress);
+        tr->flags = trace::kNoBook;
       }
+    } else {
+      itch::Event ev{};
+      if (args.stream) {
+        Handoff h;
+        if (!pop_next(h)) break;
+        t_pick = t = timing::now_ticks();
+        st.handoff.push(t - h.t_push);
+        if (main_pc.sample()) ps = &main_pc;
+        ev = h.ev;
+        r.t_ingress = h.t_ingress;
+        r.svc       = clamp_ticks(h.t_push - h.t_ingress);
+        if (tr) tr->mark[trace::Parse] = r.svc;
+      } else {
+        t_pick = r.t_ingress = timing::now_ticks();
+        if (main_pc.sample()) ps = &main_pc;
+        if (!next_event(i, ev)) break;
+        t = timing::now_ticks();
+        st.parse.push(t - t_pick);
+        if (ps) ps->charge(pst.parse);
+        if (tr) tr->mark[trace::Parse] = clamp_ticks(t - t_pick);
+      }
+      book_and_signal(ev, r, t, ps, tr);
     }
 
+    risk_and_encode(r, t_pick, t, ps, tr);
     ++processed;
   }
+  if (eng) eng->finish();
+  const uint64_t run_ns = timing::now_ns() - t_run0;
 
   if (guard_enabled) nomalloc::disable_guard();
+  if (eng) {
+    eng->for_each_decision([&](const engine::Decision& d) {
+      st.split(d.latency_ticks, d.service_ticks);
+      if (d.allowed) {
+        write_line(fout, d.ts_ns, d.type, d.order_id, d.side, d.q.bid_px, d.q.bid_qty, d.inv, d.pnl);
+      }
+    });
+  }
+  if (book_thread.joinable()) book_thread.join();
+  if (producer.joinable()) producer.join();
 
   std::fflush(fout);
   std::fclose(fout);
   delete[] outbuf;
 
-  timing::write_csv_latency(args.latency, st,
-                            static_cast<size_t>(args.warmup),
-                            processed);
-
-  // Build histograms from samples post-warmup
-  const size_t start = std::min(static_cast<size_t>(args.warmup), st.e2e.ns.size());
-  const size_t end   = std::min(processed, st.e2e.ns.size());
-  for (size_t i = start; i < end; ++i) {
-    H.parse.add_ns(st.parse.ns[i]);
-    H.lob.add_ns(st.lob.ns[i]);
-    H.sig.add_ns(st.sig.ns[i]);
-    H.risk.add_ns(st.risk.ns[i]);
-    H.e2e.add_ns(st.e2e.ns[i]);
-  }
-  histo::write_csv(args.histo, H);
-
-  const auto sum_e2e = timing::summarize(st.e2e.ns,
-                                         static_cast<size_t>(args.warmup),
-                                         processed);
-  std::printf("End-to-end latency (post-warmup): p50=%.2f us p99=%.2f us\n",
-              sum_e2e.p50_us, sum_e2e.p99_us);
+  st.to_ns();
+  if (clk.tsc) {
+    std::fprintf(stderr, "[clock] tsc %.3f GHz (invariant), timer overhead %.1f ns per sample\n",
+                 clk.ghz, clk.overhead_ns);
+  } else {
+    std::fprintf(stderr, "[clock] steady_clock%s, timer overhead %.1f ns per sample\n",
+                 args.clock == "tsc" ? " (no invariant tsc)" : "", clk.overhead_ns);
+  }
+  if (!args.latency.empty()) timing::write_csv_latency(args.latency, st);
+  if (tracer) {
+    std::string why;
+    if (!tracer->flush(args.trace, clk.ns_per_tick, &why)) {
+      std::fprintf(stderr, "trace: %s\n", why.c_str());
+    } else if (args.trace_slow_us > 0.0) {
+      std::fprintf(stderr, "[trace] %zu records, %llu of %llu events at or over %.2f us -> %s\n",
+                   tracer->records(), (unsigned long long)tracer->slow(),
+                   (unsigned long long)tracer->offered(), args.trace_slow_us, args.trace.c_str());
+    } else {
+      std::fprintf(stderr, "[trace] %zu records (1 in %d of %llu events, newest kept) -> %s\n",
+                   tracer->records(), args.trace_every, (unsigned long long)tracer->offered(),
+                   args.trace.c_str());
+    }
+  }
+  timing::write_csv_histo(args.histo, st);
+  std::vector<const lob::BookManager*> mgrs{&books};
+  if (eng) {
+    mgrs.clear();
+    for (unsigned k = 0; k < eng->shards(); ++k) mgrs.push_back(&eng->books(k));
+  }
+  size_t n_books = 0;
+  lob::Rejects rej;
+  for (const auto* m : mgrs) {
+    n_books += m->size();
+    for (size_t b = 0; b < m->size(); ++b) {
+      rej.price    += m->at(b).rejects().price;
+      rej.capacity += m->at(b).rejects().capacity;
+    }
+  }
+  if (rej.total() > 0) {
+    std::fprintf(stderr, "[books] WARNING: %llu order(s) rejected, books no longer match the feed "
+                 "(price outside ladder window: %llu, widen --book-levels; order pool full: %llu, "
+                 "raise --book-orders)\n",
+                 (unsigned long long)rej.total(), (unsigned long long)rej.price,
+                 (unsigned long long)rej.capacity);
+  }
+  if (n_books > 1 || dir.size() > 0) {
+    std::fprintf(stderr, "[books] %zu book(s) created, %zu symbol(s) in directory\n",
+                 n_books, dir.size());
+  }
+  if (!args.probe_stats.empty() && !write_probe_stats(args.probe_stats, mgrs)) {
+    std::perror("fopen(probe-stats)");
+  }
+
+  const auto sum_e2e = timing::summarize(st.e2e.hist);
+  const auto sum_svc = timing::summarize(st.service.hist);
+  const auto sum_q   = timing::summarize(st.queue.hist);
+  std::printf("End-to-end latency (post-warmup): p50=%.2f us p99=%.2f us p99.9=%.2f us p99.99=%.2f us\n",
+              sum_e2e.p50_us, sum_e2e.p99_us, sum_e2e.p999_us, sum_e2e.p9999_us);
+  std::printf("  of which service: p50=%.2f us p99=%.2f us  queueing: p50=%.2f us p99=%.2f us\n",
+              sum_svc.p50_us, sum_svc.p99_us, sum_q.p50_us, sum_q.p99_us);
+  if (eng) {
+    const engine::RiskTotals t = eng->totals();
+    std::printf("Sharded x%u: throughput=%.2f Mmsg/s  instruments=%u net_inv=%lld gross_inv=%lld quotes=%llu\n",
+                eng->shards(),
+                run_ns ? static_cast<double>(processed) * 1e3 / static_cast<double>(run_ns) : 0.0,
+                t.instruments, (long long)t.net_inv, (long long)t.gross_inv, (unsigned long long)t.quotes);
+    size_t dropped = 0;
+    for (unsigned k = 0; k < eng->shards(); ++k) {
+      std::fprintf(stderr, "[shard] %u events=%zu books=%zu\n", k, eng->shard_events(k), eng->books(k).size());
+      dropped += eng->log_dropped(k);
+    }
+    if (dropped > 0) {
+      std::fprintf(stderr, "[shard] WARNING: %zu decision(s) not logged (shard log full); %s is incomplete\n",
+                   dropped, args.results.c_str());
+    }
+  }
+  if (args.stream) {
+    const auto sum_parse = timing::summarize(st.parse.hist);
+    const auto sum_hand  = timing::summarize(st.handoff.hist);
+    std::printf("%s parse: p50=%.2f us p99=%.2f us  handoff: p50=%.2f us p99=%.2f us\n",
+                args.pipeline ? "Pipeline" : "Stream",
+                sum_parse.p50_us, sum_parse.p99_us, sum_hand.p50_us, sum_hand.p99_us);
+    if (args.pipeline) {
+      const auto sum_hand2 = timing::summarize(st.handoff2.hist);
+      std::printf("Pipeline handoff2 (book->risk): p50=%.2f us p99=%.2f us\n",
+                  sum_hand2.p50_us, sum_hand2.p99_us);
+    }
+    std::printf("%s throughput=%.2f Mmsg/s\n", args.pipeline ? "Pipeline" : "Stream",
+                run_ns ? static_cast<double>(processed) * 1e3 / static_cast<double>(run_ns) : 0.0);
+  }
+  if (main_pc.group().ok() || book_pc.group().ok()) {
+    report_perf(args.perf_csv, args.perf_sample, pst, main_pc.group(), book_pc.group());
+  }
+  if (csv.error()) {
+    std::fprintf(stderr, "replay load error: %s\n", csv.error_message().c_str());
+    return 3;
+  }
   return 0;
 }
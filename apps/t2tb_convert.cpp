@@ -0,0 +1,53 @@
+// One-time CSV -> .t2tb replay cache converter, and cache checker.
+//
+//   t2tb_convert in.csv out.t2tb [--threads N] [--stride N]
+//   t2tb_convert --verify cache.t2tb
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "libitch/itch.h"
+#include "libitch/t2tb.h"
+
+using namespace t2t;
+
+static void usage() {
+  std::fprintf(stderr,
+    "t2tb_convert in.csv out.t2tb [--threads N] [--stride N]\n"
+    "t2tb_convert --verify cache.t2tb\n");
+}
+
+int main(int argc, char** argv) {
+  std::string err;
+  if (argc == 3 && std::strcmp(argv[1], "--verify") == 0) {
+    itch::T2tbFile f;
+    if (!f.open(argv[2], &err) || !f.verify(&err)) {
+      std::fprintf(stderr, "%s\n", err.c_str());
+      return 3;
+    }
+    std::printf("%s: %zu events ok\n", argv[2], f.size());
+    return 0;
+  }
+  if (argc < 3) { usage(); return 2; }
+
+  unsigned threads = 1, stride = itch::t2tb::kIndexStride;
+  for (int i = 3; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = static_cast<unsigned>(std::atoi(argv[++i]));
+    else if (std::strcmp(argv[i], "--stride") == 0 && i + 1 < argc) stride = static_cast<unsigned>(std::atoi(argv[++i]));
+    else { usage(); return 2; }
+  }
+
+  itch::Replay rep;
+  if (!rep.load_csv_parallel(argv[1], 0, threads, &err)) {
+    std::fprintf(stderr, "replay load error: %s\n", err.c_str());
+    return 3;
+  }
+  if (!itch::t2tb::write(argv[2], rep.events, &err, stride)) {
+    std::fprintf(stderr, "%s\n", err.c_str());
+    return 4;
+  }
+  std::printf("%s: %zu events, %zu bytes/event\n", argv[2], rep.events.size(),
+              sizeof(itch::t2tb::PackedEvent));
+  return 0;
+}
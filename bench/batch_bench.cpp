@@ -0,0 +1,121 @@
+// Lookahead-prefetching batch apply (engine::apply_batch) vs the per-event
+// path on a large replay with a cold book: a generated feed keeps ~live
+// orders resting over a wide band of prices and cancels/executes random ones,
+// so most events miss in cache on the id map, the order node and the level.
+// Each run starts from a fresh (prefaulted) BookManager and applies the feed
+// in chunks of `batch` events, as t2t_main --batch does; the per-event row
+// is the book_for + apply loop t2t_main runs without --batch. A per-event
+// callback folds top of book into a checksum that must match across rows.
+//
+//   batch_bench [events] [live] [batch] [id_window]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "libengine/batch.h"
+#include "libutil/timing.h"
+
+using namespace t2t;
+
+namespace {
+
+std::vector<itch::Event> gen(size_t n, size_t live_target) {
+  std::mt19937 mt(23);
+  auto rng = [&] { return static_cast<uint32_t>(mt()); };
+  std::vector<itch::Event> ev;
+  ev.reserve(n);
+  std::vector<uint32_t> live;
+  live.reserve(live_target + 1);
+  uint32_t next = 1;
+  uint64_t ts = 0;
+  const int32_t mid = 50'000;
+  for (size_t i = 0; i < n; ++i) {
+    itch::Event e{};
+    e.ts_ns = ts += 1u + rng() % 50u;
+    const uint32_t r = rng() % 100u;
+    if (live.size() < live_target / 2 || (r < 50 && live.size() < live_target)) {
+      e.type = itch::EvType::Add;
+      e.order_id = next++;
+      e.side = (rng() & 1u) != 0;
+      e.px = mid + (e.side ? -1 : 1) * static_cast<int32_t>(1u + rng() % 5000u);
+      e.qty = static_cast<int32_t>(1u + rng() % 100u);
+      live.push_back(e.order_id);
+    } else {
+      const size_t k = rng() % live.size();
+      e.order_id = live[k];
+      if (r < 95) {
+        e.type = r < 85 ? itch::EvType::Cancel : itch::EvType::Exec;
+        live[k] = live.back();
+        live.pop_back();
+      } else {   // replace: same side is implied by the book
+        e.type = itch::EvType::Replace;
+        e.new_id = next++;
+        e.px = mid + ((rng() & 1u) ? -1 : 1) * static_cast<int32_t>(1u + rng() % 5000u);
+        e.qty = static_cast<int32_t>(1u + rng() % 100u);
+        live[k] = e.new_id;
+      }
+    }
+    ev.push_back(e);
+  }
+  return ev;
+}
+
+lob::BookSpec spec(size_t live, size_t id_window) {
+  lob::BookSpec sp;
+  sp.max_orders = live + live / 2;
+  sp.prefault = true;
+  sp.id_window = id_window;
+  return sp;
+}
+
+// ahead < 0: per-event path
+void run(const char* label, const std::vector<itch::Event>& feed, size_t live, size_t batch,
+         size_t id_window, int ahead) {
+  lob::BookManager books(spec(live, id_window));
+  engine::book_for(books, 0);   // create + prefault outside the timed loop
+  int64_t chk = 0;
+  auto fn = [&](const itch::Event&, const lob::Lob& b, const lob::Fill&) { chk += b.best_bid() - b.best_ask(); };
+  const uint64_t t0 = timing::now_ns();
+  if (ahead < 0) {
+    for (const auto& e : feed) {
+      lob::Lob& b = engine::book_for(books, e.locate);
+      lob::Fill f;
+      engine::apply(b, e, &f);
+      fn(e, b, f);
+    }
+  } else {
+    for (size_t i = 0; i < feed.size(); i += batch) {
+      const size_t k = std::min(batch, feed.size() - i);
+      engine::apply_batch(books, std::span<const itch::Event>(feed.data() + i, k), fn,
+                          static_cast<size_t>(ahead));
+    }
+  }
+  const uint64_t ns = timing::now_ns() - t0;
+  std::printf("%-10s ahead=%-3d %7.1f ns/event  live_end=%zu  chk=%lld\n", label, ahead < 0 ? 0 : ahead,
+              static_cast<double>(ns) / static_cast<double>(feed.size()), books.find(0)->live_orders(),
+              static_cast<long long>(chk));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t n      = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 4'000'000u;
+  const size_t live   = (argc > 2) ? static_cast<size_t>(std::atoll(argv[2])) : 1'000'000u;
+  const size_t batch  = (argc > 3) ? static_cast<size_t>(std::atoll(argv[3])) : 64u;
+  const size_t window = (argc > 4) ? static_cast<size_t>(std::atoll(argv[4])) : size_t{1} << 23;
+  if (n == 0 || live < 2 || batch == 0) {
+    std::fprintf(stderr, "events, live (>= 2) and batch must be positive\n");
+    return 2;
+  }
+  const auto feed = gen(n, live);
+  std::printf("events=%zu live~%zu batch=%zu\n", n, live, batch);
+  for (const size_t w : {size_t{0}, window}) {
+    std::printf("-- id map: %s\n", w ? "direct table + hash fallback" : "hash");
+    run("per-event", feed, live, batch, w, -1);
+    for (const int a : {0, 2, 4, 8, 16}) run("batch", feed, live, batch, w, a);
+  }
+  return 0;
+}
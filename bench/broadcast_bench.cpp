@@ -0,0 +1,140 @@
+// One producer fanning out to 1..8 pinned consumers:
+//   spsc_xN   : one SpscRing per consumer, the producer copies every event N times
+//   gating    : BroadcastRing, producer gated on the slowest consumer
+//   overwrite : BroadcastRing, producer never waits; lost events reported
+// Reports producer Mmsg/s (all consumers drained) and, for overwrite, the
+// share of events the consumers lost.
+//
+//   broadcast_bench [items] [max_consumers] [first_core]
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "libring/broadcast_ring.hpp"
+#include "libring/spsc_ring.hpp"
+#include "libutil/affinity.h"
+#include "libutil/timing.h"
+
+using namespace t2t;
+
+namespace {
+
+struct Msg { uint64_t seq; uint64_t payload[3]; };   // 32 bytes, like itch::Event
+
+constexpr size_t kCap = 4096;
+
+inline void backoff(unsigned& spins) {
+  if (++spins < 256) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+  } else {
+    spins = 0;
+    std::this_thread::yield();
+  }
+}
+
+unsigned g_hw = 1;
+int g_first_core = 0;
+void pin(unsigned k) { affinity::pin_to_core(static_cast<int>((static_cast<unsigned>(g_first_core) + k) % g_hw), nullptr); }
+
+struct Result { uint64_t ns; uint64_t lost; bool ok; };
+
+Result run_spsc(size_t n, unsigned k) {
+  std::vector<std::unique_ptr<ring::SpscRing<Msg>>> rings;
+  for (unsigned c = 0; c < k; ++c) rings.push_back(std::make_unique<ring::SpscRing<Msg>>(kCap));
+  std::vector<uint64_t> sums(k, 0);
+  std::atomic<bool> go{false};
+  std::vector<std::thread> th;
+  for (unsigned c = 0; c < k; ++c) {
+    th.emplace_back([&, c] {
+      pin(c + 1);
+      while (!go.load(std::memory_order_acquire)) {}
+      unsigned s = 0; Msg m{};
+      for (size_t i = 0; i < n; ++i) { while (!rings[c]->try_pop(m)) backoff(s); sums[c] += m.seq; }
+    });
+  }
+  pin(0);
+  const uint64_t t0 = timing::now_ns();
+  go.store(true, std::memory_order_release);
+  unsigned s = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const Msg m{i, {i, 0, 0}};
+    for (auto& r : rings) while (!r->try_push(m)) backoff(s);
+  }
+  for (auto& t : th) t.join();
+  const uint64_t ns = timing::now_ns() - t0;
+  bool ok = true;
+  for (uint64_t v : sums) ok &= (v == n * (n - 1) / 2);
+  return {ns, 0, ok};
+}
+
+Result run_broadcast(size_t n, unsigned k, ring::BroadcastRing<Msg>::Policy pol) {
+  using BR = ring::BroadcastRing<Msg>;
+  BR r(kCap, k, pol);
+  for (unsigned c = 0; c < k; ++c) r.add_consumer();
+  std::vector<uint64_t> lost(k, 0);
+  std::vector<char> ok(k, 1);
+  std::atomic<bool> go{false};
+  std::vector<std::thread> th;
+  for (unsigned c = 0; c < k; ++c) {
+    th.emplace_back([&, c] {
+      pin(c + 1);
+      while (!go.load(std::memory_order_acquire)) {}
+      const int id = static_cast<int>(c);
+      unsigned s = 0; Msg m{};
+      uint64_t expect = 0, sum = 0, got = 0;
+      while (r.cursor(id) < n) {
+        const auto rd = r.try_read(id, m);
+        if (rd == BR::Read::Empty) { backoff(s); continue; }
+        if (rd == BR::Read::Lagged) { expect = r.cursor(id); continue; }
+        ok[c] &= (m.seq == expect);
+        ++expect; ++got; sum += m.seq;
+      }
+      lost[c] = r.lost(id);
+      if (pol == BR::Policy::Gating) ok[c] &= (sum == n * (n - 1) / 2);
+      ok[c] &= (got + lost[c] == n);
+    });
+  }
+  pin(0);
+  const uint64_t t0 = timing::now_ns();
+  go.store(true, std::memory_order_release);
+  unsigned s = 0;
+  for (size_t i = 0; i < n;) {
+    if (r.try_publish(Msg{i, {i, 0, 0}})) ++i; else backoff(s);
+  }
+  for (auto& t : th) t.join();
+  const uint64_t ns = timing::now_ns() - t0;
+  uint64_t l = 0; bool all = true;
+  for (unsigned c = 0; c < k; ++c) { l += lost[c]; all &= ok[c] != 0; }
+  return {ns, l, all};
+}
+
+void print(const char* name, unsigned k, size_t n, const Result& r) {
+  std::printf("%-10s consumers=%u  %7.1f Mmsg/s  %6.2f ns/msg  lost=%5.1f%%  %s\n", name, k,
+              static_cast<double>(n) * 1e3 / static_cast<double>(r.ns),
+              static_cast<double>(r.ns) / static_cast<double>(n),
+              100.0 * static_cast<double>(r.lost) / static_cast<double>(n * k),
+              r.ok ? "ok" : "CHECK FAILED");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t   n     = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 5'000'000u;
+  const unsigned max_k = (argc > 2) ? static_cast<unsigned>(std::atoi(argv[2])) : 8u;
+  g_first_core         = (argc > 3) ? std::atoi(argv[3]) : 0;
+  g_hw = std::max(1u, std::thread::hardware_concurrency());
+  std::printf("items=%zu max_consumers=%u first_core=%d hardware_concurrency=%u\n",
+              n, max_k, g_first_core, g_hw);
+  for (unsigned k = 1; k <= max_k; k = (k < 2 ? k + 1 : k * 2)) {
+    print("spsc_xN",   k, n, run_spsc(n, k));
+    print("gating",    k, n, run_broadcast(n, k, ring::BroadcastRing<Msg>::Policy::Gating));
+    print("overwrite", k, n, run_broadcast(n, k, ring::BroadcastRing<Msg>::Policy::Overwrite));
+  }
+  return 0;
+}
@@ -0,0 +1,91 @@
+// Replay::load_csv_parallel thread sweep on a generated synthetic feed.
+// For each thread count prints wall time, speedup over one thread, GB/s and a
+// per-worker breakdown (chunk bytes, rows, count/parse ms), and checks the
+// result against the serial loader.
+//
+//   csv_parallel_bench [rows] [max_threads]
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libitch/itch.h"
+
+using namespace t2t;
+
+namespace {
+
+size_t write_feed(const std::string& path, size_t rows) {
+  FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) { std::perror("fopen"); std::exit(1); }
+  std::mt19937 mt(11);
+  auto rng = [&] { return static_cast<uint32_t>(mt()); };
+  std::fputs("ts_ns,type,order_id,side,px,qty\n", f);
+  uint64_t ts = 0; uint32_t id = 1;
+  for (size_t i = 0; i < rows; ++i) {
+    ts += 1u + rng() % 50u;
+    const uint32_t r = rng() % 100u;
+    const char t = r < 75 ? 'A' : (r < 90 ? 'C' : 'E');
+    const uint32_t oid = t == 'A' ? id++ : 1u + rng() % id;
+    std::fprintf(f, "%llu,%c,%u,%u,%u,%u\n", static_cast<unsigned long long>(ts), t, oid,
+                 rng() & 1u, 10'000u + rng() % 50u, t == 'C' ? 0u : 1u + rng() % 5u);
+  }
+  const long sz = std::ftell(f);
+  std::fclose(f);
+  return static_cast<size_t>(sz);
+}
+
+bool same(const std::vector<itch::Event>& a, const std::vector<itch::Event>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    const auto& x = a[i]; const auto& y = b[i];
+    if (x.ts_ns != y.ts_ns || x.type != y.type || x.order_id != y.order_id ||
+        x.side != y.side || x.px != y.px || x.qty != y.qty) return false;
+  }
+  return true;
+}
+
+double ms(uint64_t ns) { return static_cast<double>(ns) / 1e6; }
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t rows = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 5'000'000u;
+  const unsigned hw = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1u;
+  const unsigned max_t = (argc > 2) ? static_cast<unsigned>(std::atoi(argv[2])) : (hw < 2 ? 2u : hw);
+  const std::string path = "/tmp/t2t_csv_parallel_bench.csv";
+  const size_t bytes = write_feed(path, rows);
+  std::printf("rows=%zu bytes=%zu hardware_concurrency=%u\n", rows, bytes, hw);
+
+  std::string err;
+  itch::Replay ref;
+  if (!ref.load_csv(path, 0, &err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+
+  uint64_t base_ns = 0;
+  for (unsigned T = 1; T <= max_t; T = (T < 4 ? T + 1 : T * 2)) {
+    // best of 3 warm runs (output vector capacity is reused)
+    itch::Replay rep;
+    itch::Replay::LoadStats best;
+    best.total_ns = ~0ull;
+    for (int run = 0; run < 3; ++run) {
+      itch::Replay::LoadStats ls;
+      if (!rep.load_csv_parallel(path, 0, T, &err, &ls)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+      if (ls.total_ns < best.total_ns) best = ls;
+    }
+    if (T == 1) base_ns = best.total_ns;
+    const double s = static_cast<double>(best.total_ns) / 1e9;
+    std::printf("threads=%-3u %.3f s  %.2f GB/s  speedup=%.2fx  alloc=%.1f ms  identical=%s\n",
+                T, s, static_cast<double>(bytes) / s / 1e9,
+                static_cast<double>(base_ns) / static_cast<double>(best.total_ns),
+                ms(best.alloc_ns), same(ref.events, rep.events) ? "yes" : "NO");
+    for (size_t k = 0; k < best.workers.size(); ++k) {
+      const auto& w = best.workers[k];
+      std::printf("  worker %-3zu bytes=%-10zu rows=%-9zu count=%.1f ms parse=%.1f ms\n",
+                  k, w.bytes, w.rows, ms(w.count_ns), ms(w.parse_ns));
+    }
+  }
+  std::remove(path.c_str());
+  return 0;
+}
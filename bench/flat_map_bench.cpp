@@ -0,0 +1,91 @@
+// FlatMap (Robin Hood, backward-shift erase) vs the original Lob::FixedMap
+// under an order-book style add/cancel mix: every op inserts a new id and
+// cancels a live one (80% among the most recent, 20% anywhere), each cancel
+// being a get + erase as in Lob::cancel. Ids are dense, or strided to expose
+// hash clustering. `lost` counts gets that missed a live key.
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "bench/legacy_lob.h"
+#include "liblob/flat_map.h"
+#include "libutil/timing.h"
+
+using namespace t2t;
+
+namespace {
+
+struct Op { uint32_t put_id; uint32_t cancel_id; };
+
+std::vector<Op> gen(size_t n, size_t live_target, uint32_t stride, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<Op> ops; ops.reserve(n);
+  std::vector<uint32_t> live; live.reserve(live_target + 1);
+  uint32_t next = 1;
+  while (ops.size() < n) {
+    const uint32_t id = next++ * stride;
+    live.push_back(id);
+    uint32_t cid = 0;
+    if (live.size() > live_target) {
+      const size_t span = (rng() % 5u) ? std::min<size_t>(256, live.size()) : live.size();
+      const size_t k = live.size() - 1u - rng() % span;
+      cid = live[k]; live[k] = live.back(); live.pop_back();
+    }
+    ops.push_back({id, cid});
+  }
+  return ops;
+}
+
+template <class Put, class Get, class Erase>
+void run(const char* impl, const char* wl, const std::vector<Op>& ops, Put put, Get get, Erase erase) {
+  size_t lost = 0;
+  const uint64_t t0 = timing::now_ns();
+  for (const Op& op : ops) {
+    put(op.put_id, static_cast<int>(op.put_id & 0xffffu));
+    if (op.cancel_id) {
+      if (get(op.cancel_id) < 0) ++lost;
+      erase(op.cancel_id);
+    }
+  }
+  const uint64_t t1 = timing::now_ns();
+  std::printf("%-8s %-8s ops=%zu  %.1f ns/op  lost=%zu\n", wl, impl, ops.size(),
+              static_cast<double>(t1 - t0) / static_cast<double>(ops.size()), lost);
+}
+
+void print_stats(const lob::FlatMap<uint32_t, int>::ProbeStats& st) {
+  std::printf("         flatmap probe: size=%zu cap=%zu mean=%.3f max=%zu hist=[",
+              st.size, st.capacity, st.mean_probe, st.max_probe);
+  for (size_t d = 0; d < st.hist.size(); ++d) std::printf("%s%llu", d ? " " : "", (unsigned long long)st.hist[d]);
+  std::printf("]\n");
+}
+
+void compare(const char* wl, const std::vector<Op>& ops) {
+  constexpr size_t SLOTS = 1u << 20;
+  {
+    auto m = std::make_unique<bench::legacy::FixedMap<uint32_t>>(SLOTS, 0u);
+    run("fixedmap", wl, ops,
+        [&](uint32_t k, int v) { m->put(k, v); },
+        [&](uint32_t k) { return m->get(k); },
+        [&](uint32_t k) { m->erase(k); });
+  }
+  {
+    auto m = std::make_unique<lob::FlatMap<uint32_t, int>>(SLOTS / 2u, 0.5);
+    run("flatmap", wl, ops,
+        [&](uint32_t k, int v) { m->put(k, v); },
+        [&](uint32_t k) { return m->get(k, -1); },
+        [&](uint32_t k) { m->erase(k); });
+    print_stats(m->probe_stats());
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t n    = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 2'000'000u;
+  const size_t live = (argc > 2) ? static_cast<size_t>(std::atoll(argv[2])) : 50'000u;
+  compare("dense",   gen(n, live, 1, 7));
+  compare("stride4k", gen(n / 20u, live / 20u, 4096, 7));
+  return 0;
+}
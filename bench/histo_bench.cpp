@@ -0,0 +1,74 @@
+// Stage statistics: histo::LogHisto vs the original per-event vector +
+// nth_element summary and fixed-edge histogram (bench/legacy_histo.h).
+// Records `n` heavy-tailed latency samples (lognormal, median ~1 us,
+// p99.99 ~ hundreds of us) into each, then computes p50/p90/p99/p99.9/p99.99.
+// Reports ns per recorded sample, the summary time, bytes held and each
+// quantile next to the exact one from a sorted copy.
+//
+//   histo_bench [samples] [sub_bits]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "bench/legacy_histo.h"
+#include "libutil/histo.h"
+#include "libutil/timing.h"
+
+using namespace t2t;
+
+int main(int argc, char** argv) {
+  const size_t   n    = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 5'000'000u;
+  const unsigned bits = (argc > 2) ? static_cast<unsigned>(std::atoi(argv[2])) : histo::LogHisto::DEFAULT_SUB_BITS;
+  if (n < 10'000 || bits < 1 || bits > 16) {
+    std::fprintf(stderr, "samples must be >= 10000, sub_bits in [1, 16]\n");
+    return 2;
+  }
+  std::mt19937_64 mt(3);
+  std::lognormal_distribution<double> dist(7.0, 1.2);   // ns
+  std::vector<uint64_t> in(n);
+  for (auto& v : in) v = static_cast<uint64_t>(dist(mt));
+  const double qs[] = {0.50, 0.90, 0.99, 0.999, 0.9999};
+
+  // Legacy: one slot per event plus the fixed-edge histogram, as t2t_main
+  // recorded them; quantiles copy the vector each time.
+  std::vector<uint64_t> samples(n);
+  bench::legacy_histo::Histo fixed({1, 2, 5, 10, 20, 50, 80, 100, 200, 500, 1000});
+  uint64_t t0 = timing::now_ns();
+  for (size_t i = 0; i < n; ++i) samples[i] = in[i];
+  for (size_t i = 0; i < n; ++i) fixed.add_ns(samples[i]);
+  const uint64_t legacy_rec = timing::now_ns() - t0;
+  double legacy_q[5];
+  t0 = timing::now_ns();
+  for (int k = 0; k < 5; ++k) legacy_q[k] = bench::legacy_histo::quantile_us(samples, 0, n, qs[k]) * 1000.0;
+  const uint64_t legacy_sum = timing::now_ns() - t0;
+
+  histo::LogHisto h(bits);
+  t0 = timing::now_ns();
+  for (size_t i = 0; i < n; ++i) h.record(in[i]);
+  const uint64_t log_rec = timing::now_ns() - t0;
+  uint64_t log_q[5];
+  t0 = timing::now_ns();
+  for (int k = 0; k < 5; ++k) log_q[k] = h.quantile(qs[k]);
+  const uint64_t log_sum = timing::now_ns() - t0;
+
+  std::vector<uint64_t> sorted(in);
+  std::sort(sorted.begin(), sorted.end());
+  const double dn = static_cast<double>(n);
+  std::printf("samples=%zu sub_bits=%u buckets=%zu\n", n, bits, h.buckets());
+  std::printf("legacy  record %5.2f ns/sample  summary %8.3f ms  bytes %zu\n",
+              static_cast<double>(legacy_rec) / dn, static_cast<double>(legacy_sum) / 1e6,
+              samples.size() * sizeof(uint64_t) + fixed.counts.size() * sizeof(uint64_t));
+  std::printf("loghist record %5.2f ns/sample  summary %8.3f ms  bytes %zu\n",
+              static_cast<double>(log_rec) / dn, static_cast<double>(log_sum) / 1e6,
+              h.buckets() * sizeof(uint64_t));
+  for (int k = 0; k < 5; ++k) {
+    const double exact = static_cast<double>(sorted[static_cast<size_t>(std::ceil(qs[k] * dn)) - 1]);
+    std::printf("  p%-7g exact %9.0f ns  legacy %9.0f ns  loghist %9llu ns (%+.3f%%)\n", qs[k] * 100.0, exact,
+                legacy_q[k], static_cast<unsigned long long>(log_q[k]),
+                (static_cast<double>(log_q[k]) - exact) * 100.0 / exact);
+  }
+  return 0;
+}
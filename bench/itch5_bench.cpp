@@ -0,0 +1,75 @@
+// Binary ITCH 5.0 decode throughput: writes a synthetic capture (adds,
+// executes, cancels, deletes, replaces) in raw and length-prefixed framing,
+// mmaps it and walks it with Itch5Cursor. Reports Mmsg/s and GB/s.
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "libitch/itch5.h"
+#include "libutil/timing.h"
+
+using namespace t2t;
+using itch::EvType;
+
+namespace {
+
+std::vector<uint8_t> gen(size_t n, itch::itch5::Framing framing) {
+  std::mt19937 mt(7);
+  auto rng = [&] { return static_cast<uint32_t>(mt()); };
+  std::vector<uint8_t> buf; buf.reserve(n * 40u);
+  uint32_t next_id = 1;
+  uint64_t ts = 34'200'000'000'000ull; // 09:30
+  for (size_t i = 0; i < n; ++i) {
+    ts += 1u + rng() % 500u;
+    const uint32_t r = rng() % 100u;
+    const uint32_t live = next_id > 1000u ? next_id - 1u - rng() % 1000u : 1u;
+    itch::Event ev{ts, EvType::Add, 0, next_id, (rng() & 1u) != 0, 1'000'000 + static_cast<int32_t>(rng() % 2000u),
+                   static_cast<int32_t>(100u * (1u + rng() % 10u)), 0};
+    if (r < 50)      { ++next_id; }
+    else if (r < 65) { ev.type = EvType::Exec;    ev.order_id = live; }
+    else if (r < 70) { ev.type = EvType::Cancel;  ev.order_id = live; }
+    else if (r < 95) { ev.type = EvType::Cancel;  ev.order_id = live; ev.qty = 0; }
+    else             { ev.type = EvType::Replace; ev.order_id = live; ev.new_id = next_id++; }
+    itch::itch5::append(buf, ev, framing);
+  }
+  return buf;
+}
+
+void run(const char* name, itch::itch5::Framing framing, size_t n) {
+  const std::string path = std::string("/tmp/t2t_itch5_bench_") + name + ".bin";
+  {
+    const auto buf = gen(n, framing);
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) { std::perror("fopen"); std::exit(1); }
+    std::fwrite(buf.data(), 1, buf.size(), f);
+    std::fclose(f);
+  }
+  itch::Itch5File file; std::string err;
+  if (!file.open(path, framing, &err)) { std::fprintf(stderr, "%s\n", err.c_str()); std::exit(1); }
+
+  for (int pass = 0; pass < 2; ++pass) {   // pass 0 faults the mapping in
+    itch::Itch5Cursor c = file.cursor();
+    itch::Event ev{};
+    uint64_t chk = 0; size_t msgs = 0;
+    const uint64_t t0 = timing::now_ns();
+    while (c.next(ev)) { chk += ev.order_id ^ static_cast<uint32_t>(ev.qty); ++msgs; }
+    const uint64_t t1 = timing::now_ns();
+    const double s = static_cast<double>(t1 - t0) / 1e9;
+    std::printf("%-6s %s msgs=%zu bytes=%zu  %.1f Mmsg/s  %.2f GB/s  chk=%llu\n",
+                name, pass ? "warm" : "cold", msgs, file.size(),
+                static_cast<double>(msgs) / s / 1e6, static_cast<double>(file.size()) / s / 1e9,
+                static_cast<unsigned long long>(chk));
+  }
+  std::remove(path.c_str());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t n = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 10'000'000u;
+  run("raw", itch::itch5::Framing::Raw, n);
+  run("lenpfx", itch::itch5::Framing::LengthPrefixed, n);
+  return 0;
+}
@@ -0,0 +1,351 @@
+#pragma once
+// Frozen copy of the array-of-structs Lob (one 40-byte OrderNode per order,
+// int links) from before the hot/cold split. Benchmarks only: the reference
+// point lob_cache_bench measures the split layout against.
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "liblob/bitmap.h"
+#include "liblob/flat_map.h"
+
+namespace t2t::bench::legacy_aos {
+
+struct Order {
+  uint64_t ts;
+  uint32_t id;
+  int32_t  px;
+  int32_t  qty;
+  bool     is_buy;
+};
+struct Exec {
+  uint64_t ts;
+  uint32_t id;
+  int32_t  px;
+  int32_t  qty;
+};
+
+class Lob {
+public:
+  static constexpr std::size_t DEFAULT_MAX_ORDERS = 2'000'000;  // per side pool
+  static constexpr std::size_t DEFAULT_MAX_LEVELS = 1u << 16;    // per side ladder width (ticks)
+
+  // max_orders: live orders per side; max_levels: ladder width in ticks
+  // (<= LevelBitmap::MAX_BITS). Order pool and id map are reserved up front
+  // (no allocation after construction) but their pages are touched only as
+  // orders arrive, so construction is cheap and memory follows the
+  // high-water mark of live orders. prefault() touches them eagerly instead.
+  explicit Lob(std::size_t max_orders = DEFAULT_MAX_ORDERS,
+               std::size_t max_levels = DEFAULT_MAX_LEVELS);
+  void reset();      // O(live orders + occupied levels)
+  void prefault();   // touch every pool page now, off the hot path; no-op once used
+
+  std::size_t max_orders() const noexcept { return bid_.id2ord.max_items(); }
+  std::size_t max_levels() const noexcept { return bid_.levels.size(); }
+  std::size_t live_orders() const noexcept { return bid_.id2ord.size() + ask_.id2ord.size(); }
+
+  void add(const Order& o);       // price-time priority at each level
+  void cancel(uint32_t id);       // idempotent; safe if already gone
+  bool replace(uint32_t old_id, uint32_t new_id, int32_t px, int32_t qty); // same side, back of queue; false if old_id unknown
+  bool match_top(Exec& e);        // consume at top if crossed; 1 exec per call
+
+  int  best_bid() const;          // INT32_MIN if empty
+  int  best_ask() const;          // INT32_MAX if empty
+
+private:
+  // ------------ Internal structures ------------
+  static constexpr double ID_MAP_LOAD = 0.5;     // id2ord max load factor
+  struct OrderNode {
+    uint32_t id{0};
+    int32_t  px{0};
+    int32_t  qty{0};
+    uint64_t ts{0};
+    int      next{-1};   // FIFO queue (linked by index)
+    int      prev{-1};
+    bool     is_buy{true};
+    bool     active{false};
+  };
+
+  struct PriceLevel {
+    int32_t px{0};
+    int     head{-1};
+    int     tail{-1};
+    int     total_qty{0};
+    bool    active{false};
+  };
+
+  // Price ladder: levels[px - base_px] for px in [base_px, base_px + max_levels).
+  // The base re-centres (shifting levels) when a price falls outside the window.
+  struct Side {
+    std::vector<OrderNode> pool;  // reserved to max_orders; size = high-water mark
+    std::vector<PriceLevel> levels;
+    lob::LevelBitmap    occ;      // occupied ladder slots
+    lob::FlatMap<uint32_t, int> id2ord; // id -> order index
+    int64_t base_px{0};           // price of ladder slot 0
+    int best_level{-1};           // index of best (max for bid, min for ask)
+    bool is_buy{true};
+    int  free_head{-1};           // free list of released pool slots (below the high-water mark)
+    Side(bool buy, std::size_t max_orders, std::size_t max_levels);
+    int  width() const noexcept { return static_cast<int>(levels.size()); }
+    void reset();
+    void prefault();
+    int  alloc_node();            // free list, else next never-used slot
+    void free_node(int idx);      // return to free list
+  };
+
+  Side bid_, ask_;
+
+  int  ensure_level(Side& s, int32_t px);
+  bool recenter(Side& s, int32_t px);
+  void enqueue(Side& s, const Order& o);
+  void remove_idx(Side& s, int idx);
+  int  best_index(const Side& s) const;
+};
+
+
+// -------- Side impl --------
+inline Lob::Side::Side(bool buy, std::size_t max_orders, std::size_t max_levels)
+: levels(max_levels),
+  occ(max_levels),
+  id2ord(max_orders, ID_MAP_LOAD),
+  best_level(-1),
+  is_buy(buy),
+  free_head(-1) {
+  assert(max_levels >= 1 && max_levels <= lob::LevelBitmap::MAX_BITS);
+  pool.reserve(max_orders);
+}
+
+// Only live state is visited: each occupied level's FIFO (unmapping its
+// ids) and the level itself. Pool slots above the high-water mark were
+// never touched; the ones below are re-initialised by alloc_node().
+inline void Lob::Side::reset() {
+  for (int lvl = occ.lowest(); lvl >= 0; lvl = occ.lowest()) {
+    auto& L = levels[static_cast<size_t>(lvl)];
+    for (int i = L.head; i >= 0; i = pool[static_cast<size_t>(i)].next) {
+      id2ord.erase(pool[static_cast<size_t>(i)].id);
+    }
+    L = PriceLevel{};
+    occ.clear(static_cast<size_t>(lvl));
+  }
+  assert(id2ord.size() == 0);
+  pool.clear();
+  free_head = -1; base_px = 0; best_level = -1;
+}
+
+inline void Lob::Side::prefault() {
+  if (!pool.empty()) return;
+  pool.resize(pool.capacity());   // writes every slot; capacity is unchanged
+  pool.clear();
+  id2ord.prefault();
+}
+
+inline int Lob::Side::alloc_node() {
+  int idx = free_head;
+  if (idx < 0) {
+    assert(pool.size() < pool.capacity() && "order pool exhausted");
+    idx = static_cast<int>(pool.size());
+    pool.emplace_back();          // within the reservation: never reallocates
+    pool.back().active = true;
+    return idx;
+  }
+  const size_t sidx = static_cast<size_t>(idx);
+  free_head = pool[sidx].next;
+  pool[sidx].next = -1;
+  pool[sidx].prev = -1;
+  pool[sidx].active = true;
+  return idx;
+}
+
+inline void Lob::Side::free_node(int idx) {
+  if (idx < 0) return;
+  const size_t sidx = static_cast<size_t>(idx);
+  auto& n = pool[sidx];
+  n.active = false;
+  n.qty    = 0;
+  n.prev   = -1;
+  n.next   = free_head;
+  free_head = idx;
+}
+
+// -------- Lob impl --------
+inline Lob::Lob(std::size_t max_orders, std::size_t max_levels)
+: bid_(true, max_orders, max_levels), ask_(false, max_orders, max_levels) {}
+inline void Lob::reset() { bid_.reset(); ask_.reset(); }
+inline void Lob::prefault() { bid_.prefault(); ask_.prefault(); }
+
+inline int Lob::best_bid() const {
+  if (bid_.best_level < 0) return INT32_MIN;
+  return bid_.levels[static_cast<size_t>(bid_.best_level)].px;
+}
+inline int Lob::best_ask() const {
+  if (ask_.best_level < 0) return INT32_MAX;
+  return ask_.levels[static_cast<size_t>(ask_.best_level)].px;
+}
+
+inline int Lob::ensure_level(Side& s, int32_t px) {
+  int64_t off = static_cast<int64_t>(px) - s.base_px;
+  if (off < 0 || off >= s.width()) {
+    if (!recenter(s, px)) return -1;
+    off = static_cast<int64_t>(px) - s.base_px;
+  }
+  const int lvl = static_cast<int>(off);
+  auto& L = s.levels[static_cast<size_t>(lvl)];
+  if (L.active) return lvl;
+
+  L = PriceLevel{};
+  L.active = true; L.px = px; L.head = -1; L.tail = -1; L.total_qty = 0;
+  s.occ.set(static_cast<size_t>(lvl));
+  if (s.best_level < 0 || (s.is_buy ? (lvl > s.best_level) : (lvl < s.best_level))) {
+    s.best_level = lvl;
+  }
+  return lvl;
+}
+
+// Move the ladder window so px (and every live level) fits, centred on the
+// occupied span. O(max_levels) but only on a drift of the whole book.
+inline bool Lob::recenter(Side& s, int32_t px) {
+  const int lo_i = s.occ.lowest();
+  if (lo_i < 0) {
+    s.base_px = static_cast<int64_t>(px) - s.width() / 2;
+    return true;
+  }
+  const int hi_i = s.occ.highest();
+  const int64_t lo = std::min<int64_t>(s.base_px + lo_i, px);
+  const int64_t hi = std::max<int64_t>(s.base_px + hi_i, px);
+  if (hi - lo >= s.width()) {
+    assert(false && "price outside ladder window");
+    return false;
+  }
+  const int64_t new_base = lo - (s.width() - 1 - (hi - lo)) / 2;
+  const int64_t shift = s.base_px - new_base; // old slot i moves to i + shift
+
+  auto move_one = [&](int i) {
+    const size_t from = static_cast<size_t>(i);
+    const size_t to   = static_cast<size_t>(i + shift);
+    s.levels[to] = s.levels[from];
+    s.levels[from] = PriceLevel{};
+  };
+  // Walk in the direction that never overwrites a not-yet-moved level.
+  if (shift > 0) { for (int i = hi_i; i >= lo_i; --i) if (s.levels[static_cast<size_t>(i)].active) move_one(i); }
+  else           { for (int i = lo_i; i <= hi_i; ++i) if (s.levels[static_cast<size_t>(i)].active) move_one(i); }
+
+  s.occ.reset();
+  for (int64_t i = lo_i + shift; i <= hi_i + shift; ++i) {
+    if (s.levels[static_cast<size_t>(i)].active) s.occ.set(static_cast<size_t>(i));
+  }
+  s.base_px = new_base;
+  if (s.best_level >= 0) s.best_level = static_cast<int>(s.best_level + shift);
+  return true;
+}
+
+inline void Lob::enqueue(Side& s, const Order& o) {
+  if (s.id2ord.size() >= s.id2ord.max_items()) {
+    assert(false && "order capacity exhausted");
+    return;
+  }
+  const int lvl = ensure_level(s, o.px);
+  if (lvl < 0) return;
+  const size_t slvl = static_cast<size_t>(lvl);
+  const int idx = s.alloc_node();
+  const size_t sidx = static_cast<size_t>(idx);
+
+  s.id2ord.put(o.id, idx);
+
+  auto& n = s.pool[sidx];
+  n.id=o.id; n.px=o.px; n.qty=o.qty; n.ts=o.ts; n.is_buy=o.is_buy;
+
+  auto& L = s.levels[slvl];
+  n.prev = L.tail;
+  n.next = -1;
+  if (L.tail >= 0) {
+    s.pool[static_cast<size_t>(L.tail)].next = idx;
+  } else {
+    L.head = idx;
+  }
+  L.tail = idx; L.total_qty += o.qty;
+}
+
+inline void Lob::remove_idx(Side& s, int idx) {
+  if (idx < 0) return;
+  const size_t sidx = static_cast<size_t>(idx);
+  auto& n = s.pool[sidx]; if (!n.active) return;
+
+  const int lvl_idx = static_cast<int>(static_cast<int64_t>(n.px) - s.base_px);
+  auto& L = s.levels[static_cast<size_t>(lvl_idx)];
+
+  if (n.prev >= 0) s.pool[static_cast<size_t>(n.prev)].next = n.next; else L.head = n.next;
+  if (n.next >= 0) s.pool[static_cast<size_t>(n.next)].prev = n.prev; else L.tail = n.prev;
+
+  L.total_qty -= n.qty;
+  s.id2ord.erase(n.id);
+  s.free_node(idx);
+
+  if (L.total_qty <= 0) {
+    // deactivate level; next best is one bitmap query
+    L = PriceLevel{};
+    s.occ.clear(static_cast<size_t>(lvl_idx));
+    if (s.best_level == lvl_idx) {
+      s.best_level = s.is_buy ? s.occ.highest() : s.occ.lowest();
+    }
+  }
+}
+
+inline void Lob::add(const Order& o) {
+  Side& s = o.is_buy ? bid_ : ask_;
+  enqueue(s, o);
+}
+
+inline void Lob::cancel(uint32_t id) {
+  int idx = bid_.id2ord.get(id, -1);
+  if (idx >= 0) { remove_idx(bid_, idx); return; }
+  idx = ask_.id2ord.get(id, -1);
+  if (idx >= 0) { remove_idx(ask_, idx); return; }
+  // idempotent if not found
+}
+
+inline bool Lob::replace(uint32_t old_id, uint32_t new_id, int32_t px, int32_t qty) {
+  Side* s = &bid_;
+  int idx = bid_.id2ord.get(old_id, -1);
+  if (idx < 0) { s = &ask_; idx = ask_.id2ord.get(old_id, -1); }
+  if (idx < 0) return false;
+  const Order o{s->pool[static_cast<size_t>(idx)].ts, new_id, px, qty, s->is_buy};
+  remove_idx(*s, idx);
+  enqueue(*s, o);
+  return true;
+}
+
+inline int Lob::best_index(const Side& s) const { return s.best_level; }
+
+inline bool Lob::match_top(Exec& e) {
+  const int bi = best_index(bid_), ai = best_index(ask_);
+  if (bi < 0 || ai < 0) return false;
+  auto& B = bid_.levels[static_cast<size_t>(bi)];
+  auto& A = ask_.levels[static_cast<size_t>(ai)];
+  if (!B.active || !A.active) return false;
+  if (B.px < A.px) return false;  // not crossed
+
+  const int bidx = B.head, aidx = A.head;
+  if (bidx < 0 || aidx < 0) return false;
+
+  auto& b = bid_.pool[static_cast<size_t>(bidx)];
+  auto& a = ask_.pool[static_cast<size_t>(aidx)];
+
+  const int32_t qty = (b.qty < a.qty) ? b.qty : a.qty;
+  const int32_t px  = (b.ts <= a.ts) ? a.px : b.px;
+
+  e.ts = (b.ts < a.ts ? a.ts : b.ts);
+  e.id = (b.ts < a.ts ? b.id : a.id);
+  e.qty = qty;
+  e.px  = px;
+
+  b.qty -= qty; a.qty -= qty;
+  B.total_qty -= qty; A.total_qty -= qty;
+
+  if (b.qty == 0) remove_idx(bid_, bidx);
+  if (a.qty == 0) remove_idx(ask_, aidx);
+  return true;
+}
+
+} // namespace t2t::bench::legacy_aos
@@ -0,0 +1,67 @@
+#pragma once
+// Frozen copy of the original std::ifstream + std::getline CSV loader.
+// Benchmarks only: the reference point for the mmap/SIMD Replay::load_csv.
+#include <charconv>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "libitch/itch.h"
+
+namespace t2t::bench::legacy {
+
+inline bool load_csv_getline(const std::string& path, std::size_t max_msgs,
+                             std::vector<itch::Event>& events, std::string* err) {
+  using itch::Event; using itch::EvType;
+  auto u64 = [](const char* p, std::size_t n, uint64_t& o) { return std::from_chars(p, p + n, o).ec == std::errc(); };
+  auto u32 = [](const char* p, std::size_t n, uint32_t& o) { return std::from_chars(p, p + n, o).ec == std::errc(); };
+  auto i32 = [](const char* p, std::size_t n, int32_t& o)  { return std::from_chars(p, p + n, o).ec == std::errc(); };
+  auto b01 = [](const char* p, std::size_t n, bool& o) {
+    if (n == 1 && (p[0] == '0' || p[0] == '1')) { o = (p[0] == '1'); return true; }
+    if (n == 1 && (p[0] == 'B' || p[0] == 'b')) { o = true;  return true; }
+    if (n == 1 && (p[0] == 'S' || p[0] == 's')) { o = false; return true; }
+    return false;
+  };
+
+  std::ifstream ifs(path);
+  if (!ifs) { if (err) *err = "cannot open: " + path; return false; }
+  events.clear();
+  events.reserve(max_msgs ? max_msgs : 1'000'000);
+
+  std::string line;
+  if (std::getline(ifs, line)) {
+    if (line.rfind("ts_ns,", 0) != 0) { ifs.clear(); ifs.seekg(0); }
+  } else {
+    return true;
+  }
+  while (std::getline(ifs, line)) {
+    if (max_msgs && events.size() >= max_msgs) break;
+    const char* s = line.c_str();
+    const char* e = s + line.size();
+    const char* p = s;
+    int col = 0;
+    Event ev{};
+    bool ok = true;
+    while (ok && p <= e) {
+      const char* q = p;
+      while (q < e && *q != ',') ++q;
+      const std::size_t len = static_cast<std::size_t>(q - p);
+      switch (col) {
+        case 0: ok = u64(p, len, ev.ts_ns); break;
+        case 1: ev.type = static_cast<EvType>(len ? p[0] : 'A'); break;
+        case 2: ok = u32(p, len, ev.order_id); break;
+        case 3: ok = b01(p, len, ev.side); break;
+        case 4: ok = i32(p, len, ev.px); break;
+        case 5: ok = i32(p, len, ev.qty); break;
+        default: break;
+      }
+      ++col;
+      p = (q < e) ? (q + 1) : (e + 1);
+    }
+    if (!ok || col < 6) { if (err) *err = "parse error: " + line; return false; }
+    events.push_back(ev);
+  }
+  return true;
+}
+
+} // namespace t2t::bench::legacy
@@ -0,0 +1,37 @@
+#pragma once
+// Frozen copy of the original stage statistics: a per-event sample vector
+// summarised by copying it for every quantile (nth_element), and the
+// fixed-microsecond-edge histogram with a linear edge walk. Benchmarks only:
+// the reference point histo::LogHisto is measured against.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace t2t::bench::legacy_histo {
+
+struct Histo {
+  std::vector<uint32_t> edges_us;
+  std::vector<uint64_t> counts;
+  explicit Histo(std::vector<uint32_t> edges) : edges_us(std::move(edges)), counts(edges_us.size(), 0) {}
+  inline void add_ns(uint64_t ns) noexcept {
+    uint32_t us = (uint32_t)(ns / 1000u);
+    size_t i = 0;
+    for (; i < edges_us.size(); ++i) { if (us <= edges_us[i]) { counts[i]++; return; } }
+    if (!counts.empty()) counts.back()++;
+  }
+};
+
+inline double quantile_us(std::vector<uint64_t> v, size_t warmup, size_t total, double q) {
+  size_t start = std::min(warmup, v.size());
+  size_t end   = std::min(total, v.size());
+  if (end <= start + 1) return 0.0;
+  auto first = v.begin() + (ptrdiff_t)start;
+  auto last  = v.begin() + (ptrdiff_t)end;
+  auto kth   = first + (ptrdiff_t)(static_cast<double>(end - start - 1) * q);
+  std::nth_element(first, kth, last);
+  uint64_t ns = *kth;
+  return static_cast<double>(ns) / 1000.0;
+}
+
+} // namespace t2t::bench::legacy_histo
@@ -0,0 +1,146 @@
+#pragma once
+// Frozen copy of the original hash-plus-scan Lob (px2lvl hash map, linear
+// free-level search, full rescan on best-level removal). Benchmarks only:
+// the reference point the price-ladder Lob and FlatMap are measured against.
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace t2t::bench::legacy {
+
+struct Order {
+  uint64_t ts;
+  uint32_t id;
+  int32_t  px;
+  int32_t  qty;
+  bool     is_buy;
+};
+
+template <typename K>
+struct FixedMap {  // XOR hash, linear probe, erase without shift
+  struct Node { K key; int val; };
+  std::vector<Node> tab;
+  K empty_key;
+  FixedMap(size_t pow2, K empty) : tab(pow2), empty_key(empty) {
+    for (auto& n : tab) { n.key = empty_key; n.val = -1; }
+  }
+  int get(const K& k) const {
+    size_t m = tab.size()-1, h = (size_t)1469598103934665603ull ^ (size_t)k;
+    for (size_t p=0;p<tab.size();++p) { auto& n = tab[(h+p)&m]; if (n.key==k) return n.val; if (n.key==empty_key) return -1; }
+    return -1;
+  }
+  void put(const K& k, int v) {
+    size_t m = tab.size()-1, h = (size_t)1469598103934665603ull ^ (size_t)k;
+    for (size_t p=0;p<tab.size();++p) { auto& n = tab[(h+p)&m]; if (n.key==empty_key || n.key==k) { n.key=k; n.val=v; return; } }
+  }
+  void erase(const K& k) {
+    size_t m = tab.size()-1, h = (size_t)1469598103934665603ull ^ (size_t)k;
+    for (size_t p=0;p<tab.size();++p) { auto& n = tab[(h+p)&m]; if (n.key==k) { n.key=empty_key; n.val=-1; return; } if (n.key==empty_key) return; }
+  }
+};
+
+class Lob {
+public:
+  Lob() : bid_(true), ask_(false) {}
+
+  void add(const Order& o) { enqueue(o.is_buy ? bid_ : ask_, o); }
+  void cancel(uint32_t id) {
+    int idx = bid_.id2ord.get(id);
+    if (idx >= 0) { remove_idx(bid_, idx); return; }
+    idx = ask_.id2ord.get(id);
+    if (idx >= 0) { remove_idx(ask_, idx); return; }
+  }
+  int best_bid() const { return bid_.best_level < 0 ? INT32_MIN : bid_.levels[static_cast<size_t>(bid_.best_level)].px; }
+  int best_ask() const { return ask_.best_level < 0 ? INT32_MAX : ask_.levels[static_cast<size_t>(ask_.best_level)].px; }
+
+private:
+  static constexpr int MAX_ORDERS = 2'000'000;
+  static constexpr int MAX_LEVELS = 8192;
+
+  struct OrderNode {
+    uint32_t id{0}; int32_t px{0}; int32_t qty{0}; uint64_t ts{0};
+    int next{-1}, prev{-1}, level{-1};
+    bool is_buy{true}, active{false};
+  };
+  struct PriceLevel { int32_t px{0}; int head{-1}, tail{-1}, total_qty{0}; bool active{false}; };
+
+  struct Side {
+    std::vector<OrderNode> pool;
+    std::vector<PriceLevel> levels;
+    FixedMap<int32_t>  px2lvl;
+    FixedMap<uint32_t> id2ord;
+    int best_level{-1};
+    bool is_buy{true};
+    int free_head{0};
+    explicit Side(bool buy)
+    : pool(static_cast<size_t>(MAX_ORDERS)), levels(static_cast<size_t>(MAX_LEVELS)),
+      px2lvl(16384u, INT32_MIN), id2ord(1u << 20, 0u), is_buy(buy) {
+      for (size_t i = 0; i < pool.size(); ++i) pool[i].next = (i + 1u < pool.size()) ? static_cast<int>(i + 1u) : -1;
+    }
+  };
+
+  Side bid_, ask_;
+
+  static int ensure_level(Side& s, int32_t px) {
+    int lvl = s.px2lvl.get(px);
+    if (lvl >= 0) return lvl;
+    for (size_t i = 0; i < static_cast<size_t>(MAX_LEVELS); ++i) {
+      auto& L = s.levels[i];
+      if (!L.active) {
+        L = PriceLevel{}; L.active = true; L.px = px;
+        s.px2lvl.put(px, static_cast<int>(i));
+        if (s.best_level < 0) s.best_level = static_cast<int>(i);
+        else {
+          const int bp = s.levels[static_cast<size_t>(s.best_level)].px;
+          if (s.is_buy ? (px > bp) : (px < bp)) s.best_level = static_cast<int>(i);
+        }
+        return static_cast<int>(i);
+      }
+    }
+    assert(false && "no free price level");
+    return -1;
+  }
+
+  static void enqueue(Side& s, const Order& o) {
+    const int lvl = ensure_level(s, o.px);
+    const int idx = s.free_head;
+    auto& n = s.pool[static_cast<size_t>(idx)];
+    s.free_head = n.next;
+    n.active = true; n.id = o.id; n.px = o.px; n.qty = o.qty; n.ts = o.ts; n.is_buy = o.is_buy; n.level = lvl;
+    auto& L = s.levels[static_cast<size_t>(lvl)];
+    n.prev = L.tail; n.next = -1;
+    if (L.tail >= 0) s.pool[static_cast<size_t>(L.tail)].next = idx; else L.head = idx;
+    L.tail = idx; L.total_qty += o.qty;
+    s.id2ord.put(o.id, idx);
+  }
+
+  static void remove_idx(Side& s, int idx) {
+    auto& n = s.pool[static_cast<size_t>(idx)]; if (!n.active) return;
+    const int lvl_idx = n.level;
+    auto& L = s.levels[static_cast<size_t>(lvl_idx)];
+    if (n.prev >= 0) s.pool[static_cast<size_t>(n.prev)].next = n.next; else L.head = n.next;
+    if (n.next >= 0) s.pool[static_cast<size_t>(n.next)].prev = n.prev; else L.tail = n.prev;
+    L.total_qty -= n.qty;
+    s.id2ord.erase(n.id);
+    n.active = false; n.level = -1; n.qty = 0; n.prev = -1; n.next = s.free_head; s.free_head = idx;
+    if (L.total_qty <= 0) {
+      s.px2lvl.erase(L.px);
+      L = PriceLevel{};
+      if (s.best_level == lvl_idx) {
+        s.best_level = -1;
+        for (size_t i = 0; i < static_cast<size_t>(MAX_LEVELS); ++i) {
+          if (!s.levels[i].active) continue;
+          if (s.best_level < 0) s.best_level = static_cast<int>(i);
+          else {
+            const int cur = s.levels[static_cast<size_t>(s.best_level)].px;
+            if (s.is_buy ? (s.levels[i].px > cur) : (s.levels[i].px < cur)) s.best_level = static_cast<int>(i);
+          }
+        }
+      }
+    }
+  }
+};
+
+} // namespace t2t::bench::legacy
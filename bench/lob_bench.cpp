@@ -0,0 +1,111 @@
+// Price-ladder Lob vs the original hash-plus-scan Lob on two workloads:
+//   tob_churn : improve the best price then cancel it (best level empties every op)
+//   random    : drifting mid, adds within ±20 ticks, random cancels (~10k live)
+// "ladder+ids" is the same Lob with the direct-indexed order-id table.
+// Reports ns/op and a top-of-book checksum (must match between layouts).
+// Books are prefaulted before timing; "lifecycle" times construction,
+// prefault and reset() with a few live orders at the default capacity.
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "bench/legacy_lob.h"
+#include "liblob/lob.h"
+#include "libutil/timing.h"
+
+using namespace t2t;
+
+namespace {
+
+struct Op { bool add; uint32_t id; int32_t px; int32_t qty; bool buy; };
+
+std::vector<Op> gen_tob_churn(size_t n) {
+  std::vector<Op> ops; ops.reserve(n + 512);
+  uint32_t id = 1;
+  for (int i = 0; i < 200; ++i) {
+    ops.push_back({true, id++, 9999 - i, 1, true});
+    ops.push_back({true, id++, 10001 + i, 1, false});
+  }
+  for (size_t i = 0; ops.size() < n; ++i) {
+    const bool buy = (i & 1u) == 0;
+    ops.push_back({true, id, 10000, 1, buy});
+    ops.push_back({false, id, 0, 0, buy});
+    ++id;
+  }
+  return ops;
+}
+
+std::vector<Op> gen_random(size_t n, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::vector<Op> ops; ops.reserve(n);
+  std::vector<uint32_t> live; live.reserve(n);
+  uint32_t id = 1;
+  int32_t mid = 10'000;
+  while (ops.size() < n) {
+    mid += static_cast<int32_t>(rng() % 3u) - 1;
+    const bool buy = (rng() & 1u) != 0;
+    const int32_t off = static_cast<int32_t>(rng() % 21u);
+    ops.push_back({true, id, buy ? mid - off : mid + 1 + off, 1 + static_cast<int32_t>(rng() % 5u), buy});
+    live.push_back(id++);
+    if (live.size() > 10'000 || (rng() % 2u) == 0) {
+      const size_t k = rng() % live.size();
+      ops.push_back({false, live[k], 0, 0, false});
+      live[k] = live.back(); live.pop_back();
+    }
+  }
+  return ops;
+}
+
+template <class Book, class Ord, class... Ctor>
+void run(const char* impl, const char* wl, const std::vector<Op>& ops, Ctor... ctor) {
+  auto book = std::make_unique<Book>(ctor...);
+  if constexpr (requires { book->prefault(); }) book->prefault();
+  int64_t chk = 0;
+  const uint64_t t0 = timing::now_ns();
+  for (const Op& op : ops) {
+    if (op.add) book->add(Ord{0, op.id, op.px, op.qty, op.buy});
+    else        book->cancel(op.id);
+    chk += book->best_bid() - book->best_ask();
+  }
+  const uint64_t t1 = timing::now_ns();
+  std::printf("%-10s %-10s ops=%zu  %.1f ns/op  chk=%lld\n", wl, impl, ops.size(),
+              static_cast<double>(t1 - t0) / static_cast<double>(ops.size()),
+              static_cast<long long>(chk));
+}
+
+double ms(uint64_t ns) { return static_cast<double>(ns) / 1e6; }
+
+void lifecycle(size_t live) {
+  const uint64_t t0 = timing::now_ns();
+  auto lazy = std::make_unique<lob::Lob>();
+  const uint64_t t1 = timing::now_ns();
+  auto eager = std::make_unique<lob::Lob>();
+  eager->prefault();
+  const uint64_t t2 = timing::now_ns();
+  for (uint32_t i = 0; i < live; ++i) lazy->add({0, i + 1, 10'000 + static_cast<int32_t>(i % 64), 1, (i & 1u) != 0});
+  const uint64_t t3 = timing::now_ns();
+  lazy->reset();
+  const uint64_t t4 = timing::now_ns();
+  std::printf("lifecycle  max_orders=%zu  ctor=%.2f ms  ctor+prefault=%.2f ms  reset(live=%zu)=%.3f ms\n",
+              lazy->max_orders(), ms(t1 - t0), ms(t2 - t1), live, ms(t4 - t3));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t n = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 1'000'000u;
+  const auto churn = gen_tob_churn(n);
+  const auto rnd   = gen_random(n, 7);
+  const size_t kOrders = lob::Lob::DEFAULT_MAX_ORDERS, kLevels = lob::Lob::DEFAULT_MAX_LEVELS;
+  const size_t kWindow = size_t{1} << 22;   // ids; covers the live span of both workloads
+  run<bench::legacy::Lob, bench::legacy::Order>("hashscan", "tob_churn", churn);
+  run<lob::Lob,           lob::Order>          ("ladder",   "tob_churn", churn);
+  run<lob::Lob,           lob::Order>          ("ladder+ids", "tob_churn", churn, kOrders, kLevels, kWindow);
+  run<bench::legacy::Lob, bench::legacy::Order>("hashscan", "random",    rnd);
+  run<lob::Lob,           lob::Order>          ("ladder",   "random",    rnd);
+  run<lob::Lob,           lob::Order>          ("ladder+ids", "random",  rnd, kOrders, kLevels, kWindow);
+  lifecycle(1000);
+  return 0;
+}
@@ -0,0 +1,145 @@
+// Order-storage cache behaviour: hot/cold split Lob vs the frozen AoS Lob on
+// a deep book. Fills each side with `live` orders over `levels` price levels
+// (long FIFOs), then runs random cancels of live orders, each followed by an
+// add that keeps the book depth constant, and drains the crossed top with
+// match_top every 64 ops. Cancels land on random pool slots, so the run is
+// dominated by misses on order storage and the id map.
+//
+// Reports ns/op and, where the kernel exposes them, per-op L1D read misses
+// and last-level cache misses (perf::Group, user space only). Without
+// hardware counters (most VMs) only time and bytes per order are printed.
+// The layouts alternate for `reps` rounds; the best round of each is shown.
+//
+//   lob_cache_bench [ops] [live_per_side] [levels] [reps]
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/legacy_aos_lob.h"
+#include "liblob/lob.h"
+#include "libutil/perf_counters.h"
+#include "libutil/timing.h"
+
+using namespace t2t;
+
+namespace {
+
+struct Op { uint32_t cancel_id; uint32_t add_id; int32_t px; int32_t qty; bool buy; };
+
+struct Workload {
+  std::vector<Op> fill;   // cancel_id == 0
+  std::vector<Op> ops;
+};
+
+// Both sides hold `live` orders; bids at [mid - levels, mid), asks at
+// [mid, mid + levels). Every op cancels a random live order and adds one on
+// the same side; one add in 64 crosses the spread (price mid on the other
+// side) so match_top has something to take.
+Workload gen(size_t n, size_t live, int32_t levels) {
+  std::mt19937 mt(11);
+  auto rng = [&] { return static_cast<uint32_t>(mt()); };
+  const int32_t mid = 100'000;
+  Workload w;
+  std::vector<uint32_t> ids[2];
+  uint32_t next = 1;
+  for (size_t i = 0; i < 2 * live; ++i) {
+    const bool buy = (i & 1u) == 0;
+    const int32_t off = static_cast<int32_t>(rng() % static_cast<uint32_t>(levels));
+    w.fill.push_back({0, next, buy ? mid - 1 - off : mid + off, 1 + static_cast<int32_t>(rng() % 9u), buy});
+    ids[buy ? 0 : 1].push_back(next++);
+  }
+  w.ops.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    const bool buy = (rng() & 1u) != 0;
+    auto& side = ids[buy ? 0 : 1];
+    const size_t k = rng() % side.size();
+    const int32_t off = static_cast<int32_t>(rng() % static_cast<uint32_t>(levels));
+    const bool cross = (i % 64u) == 63u;
+    const int32_t px = cross ? (buy ? mid : mid - 1) : (buy ? mid - 1 - off : mid + off);
+    w.ops.push_back({side[k], next, px, 1 + static_cast<int32_t>(rng() % 9u), buy});
+    side[k] = next++;
+  }
+  return w;
+}
+
+bool cache_counters(const perf::Group& pc) { return pc.has(perf::L1dMiss) && pc.has(perf::LlcMiss); }
+
+struct Result {
+  double ns_op{0.0}, l1d_op{0.0}, llc_op{0.0};
+  bool   counters{false};
+  int64_t chk{0};
+};
+
+template <class Book, class Ord, class Ex>
+Result run(const Workload& w, const perf::Group& pc) {
+  auto book = std::make_unique<Book>();
+  book->prefault();
+  for (const Op& op : w.fill) book->add(Ord{0, op.add_id, op.px, op.qty, op.buy});
+
+  int64_t chk = 0;
+  uint64_t ts = 1;
+  perf::Snapshot c0, c1;
+  pc.read(c0);
+  const uint64_t t0 = timing::now_ns();
+  for (size_t i = 0; i < w.ops.size(); ++i) {
+    const Op& op = w.ops[i];
+    book->cancel(op.cancel_id);
+    book->add(Ord{ts++, op.add_id, op.px, op.qty, op.buy});
+    if ((i & 63u) == 63u) {
+      Ex e{};
+      while (book->match_top(e)) chk += e.qty;
+    }
+    chk += book->best_bid() - book->best_ask();
+  }
+  const uint64_t t1 = timing::now_ns();
+  pc.read(c1);
+
+  const double n = static_cast<double>(w.ops.size());
+  return Result{static_cast<double>(t1 - t0) / n,
+                static_cast<double>(c1.v[perf::L1dMiss] - c0.v[perf::L1dMiss]) / n,
+                static_cast<double>(c1.v[perf::LlcMiss] - c0.v[perf::LlcMiss]) / n, cache_counters(pc), chk};
+}
+
+void keep_best(Result& best, const Result& r) {
+  if (best.ns_op == 0.0 || r.ns_op < best.ns_op) { best.ns_op = r.ns_op; best.chk = r.chk; }
+  if (r.counters && (!best.counters || r.l1d_op < best.l1d_op)) { best.l1d_op = r.l1d_op; best.llc_op = r.llc_op; }
+  best.counters = best.counters || r.counters;
+}
+
+void print(const char* impl, size_t ops, size_t order_bytes, const Result& r) {
+  std::printf("%-6s ops=%zu  %.1f ns/op  order=%zu B", impl, ops, r.ns_op, order_bytes);
+  if (r.counters) std::printf("  L1D-miss/op=%.2f  LLC-miss/op=%.3f", r.l1d_op, r.llc_op);
+  std::printf("  chk=%lld\n", static_cast<long long>(r.chk));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t  n      = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 2'000'000u;
+  const size_t  live   = (argc > 2) ? static_cast<size_t>(std::atoll(argv[2])) : 500'000u;
+  const int32_t levels = (argc > 3) ? std::atoi(argv[3]) : 2000;
+  const int     reps   = (argc > 4) ? std::atoi(argv[4]) : 3;
+  if (live == 0 || live > lob::Lob::DEFAULT_MAX_ORDERS / 2 || levels <= 0 || levels > 30'000) {
+    std::fprintf(stderr, "live_per_side must be in [1, 1000000], levels in [1, 30000]\n");
+    return 2;
+  }
+  const Workload w = gen(n, live, levels);
+  perf::Group pc;
+  std::string why;
+  if (pc.open(&why) && !cache_counters(pc)) why = "no L1D/LLC miss events on this PMU";
+  std::printf("live/side=%zu levels/side=%d  hw counters: %s%s\n", live, levels,
+              cache_counters(pc) ? "L1D read miss, LLC miss" : "unavailable (timing only): ",
+              cache_counters(pc) ? "" : why.c_str());
+  Result aos, split;
+  for (int r = 0; r < reps; ++r) {
+    keep_best(aos,   run<bench::legacy_aos::Lob, bench::legacy_aos::Order, bench::legacy_aos::Exec>(w, pc));
+    keep_best(split, run<lob::Lob, lob::Order, lob::Exec>(w, pc));
+  }
+  // Bytes per live order in the pool: AoS node vs hot link + cold id + ts.
+  print("aos",   w.ops.size(), 40, aos);
+  print("split", w.ops.size(), 16 + 4 + 8, split);
+  return 0;
+}
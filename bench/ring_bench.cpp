@@ -0,0 +1,201 @@
+// SpscRing two-thread benchmarks, producer and consumer pinned with
+// affinity::pin_to_core:
+//   throughput : stream N items; ns/item for the original ring, single
+//                try_push/try_pop, try_push_n/try_pop_n batches and
+//                reserve/commit + peek/release spans
+//   ping-pong  : bounce a message (or a batch) over two rings; round-trip ns
+//
+//   ring_bench [items] [producer_core] [consumer_core] [batch]
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "bench/legacy_ring.h"
+#include "libring/spsc_ring.hpp"
+#include "libutil/affinity.h"
+#include "libutil/timing.h"
+
+using namespace t2t;
+
+namespace {
+
+struct Msg { uint64_t seq; uint64_t payload[3]; };   // 32 bytes, like itch::Event
+
+constexpr size_t kCap = 4096;
+
+// Spin briefly, then yield so the benchmark still progresses when both
+// threads share a core.
+inline void backoff(unsigned& spins) {
+  if (++spins < 256) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+  } else {
+    spins = 0;
+    std::this_thread::yield();
+  }
+}
+
+void pin(int core) {
+  if (core >= 0) affinity::pin_to_core(core, nullptr);
+}
+
+// Runs prod() on a pinned thread and cons() on the calling (pinned) thread;
+// returns wall ns.
+template <class P, class C>
+uint64_t run_pair(int pcore, int ccore, P&& prod, C&& cons) {
+  std::atomic<bool> go{false};
+  std::thread tp([&] { pin(pcore); while (!go.load(std::memory_order_acquire)) {} prod(); });
+  pin(ccore);
+  const uint64_t t0 = timing::now_ns();
+  go.store(true, std::memory_order_release);
+  cons();
+  tp.join();
+  return timing::now_ns() - t0;
+}
+
+struct Result { const char* name; uint64_t ns; uint64_t check; size_t per_round{1}; };
+
+template <class Ring>
+Result tp_single(const char* name, size_t n, int pc, int cc) {
+  Ring r(kCap);
+  uint64_t sum = 0;
+  const uint64_t ns = run_pair(pc, cc,
+    [&] { unsigned s = 0; for (size_t i = 0; i < n; ++i) { Msg m{i, {i, 0, 0}}; while (!r.try_push(m)) backoff(s); } },
+    [&] { unsigned s = 0; Msg m{}; for (size_t i = 0; i < n; ++i) { while (!r.try_pop(m)) backoff(s); sum += m.seq; } });
+  return {name, ns, sum};
+}
+
+Result tp_batch(size_t n, size_t batch, int pc, int cc) {
+  ring::SpscRing<Msg> r(kCap);
+  uint64_t sum = 0;
+  const uint64_t ns = run_pair(pc, cc,
+    [&] {
+      std::vector<Msg> buf(batch);
+      unsigned s = 0;
+      for (size_t i = 0; i < n;) {
+        const size_t k = std::min(batch, n - i);
+        for (size_t j = 0; j < k; ++j) buf[j] = Msg{i + j, {i + j, 0, 0}};
+        size_t done = 0;
+        while (done < k) { const size_t m = r.try_push_n(buf.data() + done, k - done); done += m; if (!m) backoff(s); }
+        i += k;
+      }
+    },
+    [&] {
+      std::vector<Msg> buf(batch);
+      unsigned s = 0;
+      for (size_t got = 0; got < n;) {
+        const size_t m = r.try_pop_n(buf.data(), batch);
+        if (!m) { backoff(s); continue; }
+        for (size_t j = 0; j < m; ++j) sum += buf[j].seq;
+        got += m;
+      }
+    });
+  return {"batch_n", ns, sum};
+}
+
+Result tp_span(size_t n, size_t batch, int pc, int cc) {
+  ring::SpscRing<Msg> r(kCap);
+  uint64_t sum = 0;
+  const uint64_t ns = run_pair(pc, cc,
+    [&] {
+      unsigned s = 0;
+      for (size_t i = 0; i < n;) {
+        auto sp = r.reserve(std::min(batch, n - i));
+        if (sp.empty()) { backoff(s); continue; }
+        for (size_t j = 0; j < sp.size(); ++j) sp[j] = Msg{i + j, {i + j, 0, 0}};
+        r.commit(sp.size());
+        i += sp.size();
+      }
+    },
+    [&] {
+      unsigned s = 0;
+      for (size_t got = 0; got < n;) {
+        auto sp = r.peek(batch);
+        if (sp.empty()) { backoff(s); continue; }
+        for (const Msg& m : sp) sum += m.seq;
+        r.release(sp.size());
+        got += sp.size();
+      }
+    });
+  return {"span", ns, sum};
+}
+
+// Round trip: A sends `batch` messages, B echoes them back, A waits for all.
+template <class Ring, bool Batched>
+Result ping_pong(const char* name, size_t rounds, size_t batch, int pc, int cc) {
+  Ring ab(kCap), ba(kCap);
+  uint64_t sum = 0;
+  const uint64_t ns = run_pair(pc, cc,
+    [&] {  // echo side
+      std::vector<Msg> buf(batch);
+      unsigned s = 0;
+      for (size_t r = 0; r < rounds; ++r) {
+        if constexpr (Batched) {
+          size_t got = 0;
+          while (got < batch) { const size_t m = ab.try_pop_n(buf.data() + got, batch - got); got += m; if (!m) backoff(s); }
+          size_t put = 0;
+          while (put < batch) { const size_t m = ba.try_push_n(buf.data() + put, batch - put); put += m; if (!m) backoff(s); }
+        } else {
+          for (size_t j = 0; j < batch; ++j) { while (!ab.try_pop(buf[j])) backoff(s); }
+          for (size_t j = 0; j < batch; ++j) { while (!ba.try_push(buf[j])) backoff(s); }
+        }
+      }
+    },
+    [&] {  // initiating side
+      std::vector<Msg> buf(batch);
+      unsigned s = 0;
+      for (size_t r = 0; r < rounds; ++r) {
+        for (size_t j = 0; j < batch; ++j) buf[j] = Msg{r * batch + j, {0, 0, 0}};
+        if constexpr (Batched) {
+          size_t put = 0;
+          while (put < batch) { const size_t m = ab.try_push_n(buf.data() + put, batch - put); put += m; if (!m) backoff(s); }
+          size_t got = 0;
+          while (got < batch) { const size_t m = ba.try_pop_n(buf.data() + got, batch - got); got += m; if (!m) backoff(s); }
+        } else {
+          for (size_t j = 0; j < batch; ++j) { while (!ab.try_push(buf[j])) backoff(s); }
+          for (size_t j = 0; j < batch; ++j) { while (!ba.try_pop(buf[j])) backoff(s); }
+        }
+        for (size_t j = 0; j < batch; ++j) sum += buf[j].seq;
+      }
+    });
+  return {name, ns, sum, batch};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t n     = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 10'000'000u;
+  const int    pc    = (argc > 2) ? std::atoi(argv[2]) : 0;
+  const int    cc    = (argc > 3) ? std::atoi(argv[3]) : 1;
+  const size_t batch = (argc > 4) ? static_cast<size_t>(std::atoll(argv[4])) : 32u;
+  std::printf("items=%zu producer_core=%d consumer_core=%d batch=%zu hardware_concurrency=%u\n",
+              n, pc, cc, batch, std::thread::hardware_concurrency());
+  const uint64_t expect = n * (n - 1) / 2;
+
+  std::printf("-- throughput (ns/item)\n");
+  for (const Result& r : {tp_single<bench::legacy::SpscRing<Msg>>("legacy", n, pc, cc),
+                          tp_single<ring::SpscRing<Msg>>("single", n, pc, cc),
+                          tp_batch(n, batch, pc, cc),
+                          tp_span(n, batch, pc, cc)}) {
+    std::printf("%-8s %7.2f ns/item  %7.1f Mitems/s  %s\n", r.name,
+                static_cast<double>(r.ns) / static_cast<double>(n),
+                static_cast<double>(n) * 1e3 / static_cast<double>(r.ns),
+                r.check == expect ? "ok" : "CHECKSUM MISMATCH");
+  }
+
+  const size_t rounds = std::max<size_t>(1, n / 100);
+  std::printf("-- ping-pong (%zu round trips)\n", rounds);
+  for (const Result& r : {ping_pong<bench::legacy::SpscRing<Msg>, false>("legacy", rounds, 1, pc, cc),
+                          ping_pong<ring::SpscRing<Msg>, false>("single", rounds, 1, pc, cc),
+                          ping_pong<ring::SpscRing<Msg>, false>("single_x", rounds, batch, pc, cc),
+                          ping_pong<ring::SpscRing<Msg>, true>("batch_n", rounds, batch, pc, cc)}) {
+    const size_t b = r.per_round;
+    std::printf("%-8s x%-4zu %9.1f ns/round-trip  %7.2f ns/item\n", r.name, b,
+                static_cast<double>(r.ns) / static_cast<double>(rounds),
+                static_cast<double>(r.ns) / static_cast<double>(rounds * b));
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+// engine::ShardedEngine shard sweep on a generated multi-symbol feed.
+// The dispatcher runs on the main thread (pinned to first_core); shard k's
+// worker is pinned to first_core + 1 + k (mod cores). For each shard count
+// prints aggregate msg/s, speedup over one shard, dispatch->decided latency
+// percentiles and the per-shard event split, and checks that the merged
+// decisions are identical to the one-shard run.
+//
+//   shard_bench [events] [symbols] [max_shards] [first_core]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "libengine/sharded.h"
+#include "libutil/affinity.h"
+
+using namespace t2t;
+
+namespace {
+
+// Per-symbol add/cancel/exec mix over that symbol's live orders; ids are
+// unique across symbols. Live orders per symbol stay under max_live.
+std::vector<itch::Event> gen(size_t n, unsigned symbols, size_t max_live) {
+  std::mt19937 mt(17);
+  auto rng = [&] { return static_cast<uint32_t>(mt()); };
+  std::vector<std::vector<uint32_t>> live(symbols);
+  std::vector<itch::Event> ev;
+  ev.reserve(n);
+  uint32_t next_id = 1;
+  uint64_t ts = 0;
+  for (size_t i = 0; i < n; ++i) {
+    ts += 1u + rng() % 20u;
+    const uint16_t sym = static_cast<uint16_t>(rng() % symbols);
+    auto& lv = live[sym];
+    const int32_t mid = 10'000 + 100 * static_cast<int32_t>(sym);
+    const uint32_t r = rng() % 100u;
+    itch::Event e{};
+    e.ts_ns = ts;
+    e.locate = sym;
+    if (lv.empty() || (r < 50 && lv.size() < max_live)) {
+      e.type = itch::EvType::Add;
+      e.order_id = next_id++;
+      e.side = (rng() & 1u) != 0;
+      e.px = mid + (e.side ? -1 : 1) * static_cast<int32_t>(1u + rng() % 50u);
+      e.qty = static_cast<int32_t>(1u + rng() % 10u);
+      lv.push_back(e.order_id);
+    } else {
+      const size_t k = rng() % lv.size();
+      e.type = r < 85 ? itch::EvType::Cancel : itch::EvType::Exec;
+      e.order_id = lv[k];
+      e.side = (rng() & 1u) != 0;
+      e.px = mid;
+      e.qty = e.type == itch::EvType::Exec ? static_cast<int32_t>(1u + rng() % 10u) : 0;
+      lv[k] = lv.back();
+      lv.pop_back();
+    }
+    ev.push_back(e);
+  }
+  return ev;
+}
+
+uint64_t mix(uint64_t h, uint64_t v) {
+  h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+  return h;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t   n       = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 2'000'000u;
+  const unsigned symbols = (argc > 2) ? static_cast<unsigned>(std::atoi(argv[2])) : 256u;
+  const unsigned hw      = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1u;
+  const unsigned max_s   = (argc > 3) ? static_cast<unsigned>(std::atoi(argv[3])) : std::max(2u, hw - 1u);
+  const int      core0   = (argc > 4) ? std::atoi(argv[4]) : 0;
+  if (symbols == 0 || symbols > engine::ShardedEngine::MAX_LOCATES) {
+    std::fprintf(stderr, "symbols must be in [1, 65536]\n");
+    return 2;
+  }
+
+  const auto feed = gen(n, symbols, 2000);
+  std::printf("events=%zu symbols=%u hardware_concurrency=%u\n", n, symbols, hw);
+  std::string info;
+  affinity::pin_to_core(core0, &info);
+
+  double base = 0.0;
+  uint64_t ref_hash = 0;
+  for (unsigned S = 1; S <= max_s; S = (S < 4 ? S + 1 : S * 2)) {
+    engine::Config cfg;
+    cfg.shards = S;
+    for (unsigned k = 0; k < S; ++k) cfg.cores.push_back(static_cast<int>((static_cast<unsigned>(core0) + 1u + k) % hw));
+    cfg.book = lob::BookSpec{4096, 2048};
+    cfg.log_capacity = n;
+    engine::ShardedEngine eng(cfg);
+    eng.start();
+
+    const uint64_t t0 = timing::now_ns();
+    for (const auto& e : feed) eng.dispatch(e);
+    eng.finish();
+    const uint64_t ns = timing::now_ns() - t0;
+
+    std::vector<uint64_t> lat;
+    lat.reserve(n);
+    uint64_t h = 0;
+    eng.for_each_decision([&](const engine::Decision& d) {
+      lat.push_back(tsc::to_ns(d.latency_ticks));
+      h = mix(h, d.seq);
+      h = mix(h, static_cast<uint64_t>(d.allowed));
+      h = mix(h, static_cast<uint32_t>(d.q.bid_px));
+      h = mix(h, static_cast<uint32_t>(d.q.ask_px));
+      h = mix(h, static_cast<uint32_t>(d.inv));
+    });
+    if (S == 1) ref_hash = h;
+    std::sort(lat.begin(), lat.end());
+    auto pct = [&](double q) {
+      return lat.empty() ? 0.0 : static_cast<double>(lat[static_cast<size_t>(q * static_cast<double>(lat.size() - 1))]) / 1e3;
+    };
+
+    const double mps = static_cast<double>(n) * 1e3 / static_cast<double>(ns);
+    if (S == 1) base = mps;
+    const engine::RiskTotals t = eng.totals();
+    std::printf("shards=%-3u %8.2f Mmsg/s  speedup=%.2fx  lat p50=%.2f us p99=%.2f us  books=%u quotes=%llu  identical=%s\n",
+                S, mps, base > 0.0 ? mps / base : 0.0, pct(0.50), pct(0.99), t.instruments,
+                static_cast<unsigned long long>(t.quotes), h == ref_hash ? "yes" : "NO");
+    std::printf("           split:");
+    for (unsigned k = 0; k < S; ++k) std::printf(" %zu", eng.shard_events(k));
+    std::printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,83 @@
+// Aggressive-order sweep: Lob::add_and_match (all fills in one pass into a
+// caller buffer) vs the add + match_top loop, for marketable orders that
+// clear 1..100 ask levels. Each level holds `per_level` resting orders; the
+// swept levels are refilled (untimed) before every sweep, and the aggressor
+// is sized to take exactly `depth` levels plus one share that rests.
+// Reports ns per sweep and per fill; filled shares must match (match_top
+// prices fills differently, so prices are not compared).
+//
+//   sweep_bench [sweeps] [per_level]
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "liblob/lob.h"
+#include "libutil/timing.h"
+
+using namespace t2t;
+
+namespace {
+
+constexpr int32_t BASE_PX = 10'000;
+constexpr int32_t QTY     = 3;
+
+struct Result { double ns_sweep{0.0}; double ns_fill{0.0}; int64_t chk{0}; };
+
+// Refill levels [BASE_PX, BASE_PX + depth) with per_level asks each and
+// clear the aggressor's resting remainder from the previous sweep.
+void refill(lob::Lob& book, int depth, int per_level, uint32_t& next_id, uint32_t prev_aggr) {
+  book.cancel(prev_aggr);
+  for (int l = 0; l < depth; ++l)
+    for (int k = 0; k < per_level; ++k)
+      book.add({0, next_id++, BASE_PX + l, QTY, false});
+}
+
+template <bool Sweep>
+Result run(size_t sweeps, int depth, int per_level) {
+  lob::Lob book(static_cast<size_t>(depth * per_level) + 16, 1024);
+  book.prefault();
+  std::vector<lob::Exec> fills(static_cast<size_t>(depth * per_level) + 1);
+  const int32_t qty = depth * per_level * QTY + 1;
+  uint32_t next_id = 1, aggr = 0;
+  uint64_t ns = 0, nfills = 0;
+  int64_t chk = 0;
+  for (size_t i = 0; i < sweeps; ++i) {
+    refill(book, depth, per_level, next_id, aggr);
+    aggr = next_id++;
+    const lob::Order o{i + 1, aggr, BASE_PX + depth, qty, true};
+    const uint64_t t0 = timing::now_ns();
+    if constexpr (Sweep) {
+      const lob::Sweep r = book.add_and_match(o, fills);
+      nfills += r.fills;
+      for (size_t f = 0; f < r.fills; ++f) chk += fills[f].qty;
+    } else {
+      book.add(o);
+      lob::Exec e{};
+      while (book.match_top(e)) { ++nfills; chk += e.qty; }
+    }
+    ns += timing::now_ns() - t0;
+  }
+  return Result{static_cast<double>(ns) / static_cast<double>(sweeps),
+                static_cast<double>(ns) / static_cast<double>(nfills ? nfills : 1), chk};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t sweeps    = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 20'000u;
+  const int    per_level = (argc > 2) ? std::atoi(argv[2]) : 4;
+  if (sweeps == 0 || per_level <= 0 || per_level > 1000) {
+    std::fprintf(stderr, "sweeps must be positive, per_level in [1, 1000]\n");
+    return 2;
+  }
+  std::printf("sweeps=%zu orders/level=%d\n", sweeps, per_level);
+  for (const int depth : {1, 2, 5, 10, 20, 50, 100}) {
+    const Result loop  = run<false>(sweeps, depth, per_level);
+    const Result sweep = run<true>(sweeps, depth, per_level);
+    std::printf("levels=%-3d  match_top loop %8.1f ns/sweep %5.1f ns/fill  |  add_and_match %8.1f ns/sweep "
+                "%5.1f ns/fill  chk=%s\n",
+                depth, loop.ns_sweep, loop.ns_fill, sweep.ns_sweep, sweep.ns_fill,
+                loop.chk == sweep.chk ? "ok" : "MISMATCH");
+  }
+  return 0;
+}
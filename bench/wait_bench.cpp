@@ -0,0 +1,88 @@
+// Consumer wait policies: wake-up latency vs CPU burn. The producer publishes
+// a timestamp, then idles for `gap_us`; the consumer waits on the ring with
+// the policy under test and records publish -> wake latency. CPU burn is the
+// consumer thread's CPU time over wall time (100% = one core spinning).
+//
+//   wait_bench [msgs] [gap_us] [producer_core] [consumer_core]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "libring/spsc_ring.hpp"
+#include "libring/wait_strategy.hpp"
+#include "libutil/affinity.h"
+#include "libutil/timing.h"
+
+using namespace t2t;
+
+namespace {
+
+uint64_t thread_cpu_ns() {
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+double pct(std::vector<uint64_t>& v, double q) {
+  if (v.empty()) return 0.0;
+  auto k = v.begin() + static_cast<std::ptrdiff_t>(static_cast<double>(v.size() - 1) * q);
+  std::nth_element(v.begin(), k, v.end());
+  return static_cast<double>(*k) / 1000.0;
+}
+
+template <class W>
+void run(const char* name, W& w, size_t msgs, unsigned gap_us, int pc, int cc) {
+  ring::SpscRing<uint64_t> q(1024);
+  std::vector<uint64_t> lat(msgs);
+  std::atomic<bool> go{false};
+
+  std::thread prod([&] {
+    if (pc >= 0) affinity::pin_to_core(pc, nullptr);
+    while (!go.load(std::memory_order_acquire)) {}
+    for (size_t i = 0; i < msgs; ++i) {
+      std::this_thread::sleep_for(std::chrono::microseconds(gap_us));
+      while (!q.try_push(timing::now_ns())) {}
+      w.notify();
+    }
+  });
+
+  if (cc >= 0) affinity::pin_to_core(cc, nullptr);
+  const uint64_t wall0 = timing::now_ns(), cpu0 = thread_cpu_ns();
+  go.store(true, std::memory_order_release);
+  for (size_t i = 0; i < msgs; ++i) {
+    uint64_t t = 0;
+    w.wait([&] { return q.try_pop(t); });
+    lat[i] = timing::now_ns() - t;
+  }
+  const uint64_t cpu = thread_cpu_ns() - cpu0, wall = timing::now_ns() - wall0;
+  prod.join();
+
+  std::printf("%-6s p50=%8.2f us p99=%8.2f us p99.9=%8.2f us max=%9.2f us  cpu=%5.1f%%\n", name,
+              pct(lat, 0.50), pct(lat, 0.99), pct(lat, 0.999), pct(lat, 1.0),
+              100.0 * static_cast<double>(cpu) / static_cast<double>(wall));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const size_t   msgs = (argc > 1) ? static_cast<size_t>(std::atoll(argv[1])) : 20'000u;
+  const unsigned gap  = (argc > 2) ? static_cast<unsigned>(std::atoi(argv[2])) : 50u;
+  const int      pc   = (argc > 3) ? std::atoi(argv[3]) : 0;
+  const int      cc   = (argc > 4) ? std::atoi(argv[4]) : 1;
+  std::printf("msgs=%zu gap=%u us producer_core=%d consumer_core=%d hardware_concurrency=%u\n",
+              msgs, gap, pc, cc, std::thread::hardware_concurrency());
+
+  // Compile-time policies
+  { ring::BusySpin  w;  run("spin",  w, msgs, gap, pc, cc); }
+  { ring::PauseSpin w;  run("pause", w, msgs, gap, pc, cc); }
+  { ring::SpinYield w;  run("yield", w, msgs, gap, pc, cc); }
+  { ring::SpinPark  w;  run("park",  w, msgs, gap, pc, cc); }
+  // Run-time dispatch (same park policy behind a switch)
+  { ring::Waiter    w(ring::WaitPolicy::SpinPark); run("park*", w, msgs, gap, pc, cc); }
+  return 0;
+}
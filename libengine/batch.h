@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include "libitch/itch.h"
+#include "liblob/book_manager.h"
+#include "libutil/nomalloc.h"
+
+// Applying decoded events to their books, one at a time or in batches with
+// lookahead prefetching.
+//
+// A cancel on a cold book is a chain of dependent misses: id-map slot, then
+// the order's pool node, then its FIFO neighbours and price level. With the
+// whole batch in hand, apply_batch() starts that chain for later events
+// while the current one is applied: event j + 3*ahead gets its id-map slot
+// prefetched, j + 2*ahead its node (the slot is cached by then), and
+// j + ahead its neighbours and level. Each stage only reads what the
+// previous one pulled in. Events are still applied, and the callback still
+// runs, strictly one at a time in order.
+namespace t2t::engine {
+
+// One book update. Exec and Reduce shrink the order in place (it keeps its
+// queue position) and remove it once nothing is left. false if the book
+// refused an add or replace (counted in Lob::rejects()); unknown ids are
+// not refusals. fill, if given, gets what an Exec took off the book, with
+// the resting order's side; the price is the event's if it carries one
+// (ITCH C prints at its own price), else the resting order's (ITCH E).
+// It is zero for every other event and for an unknown id.
+inline bool apply(lob::Lob& book, const itch::Event& ev, lob::Fill* fill = nullptr) noexcept {
+  if (fill) *fill = lob::Fill{};
+  switch (ev.type) {
+    case itch::EvType::Add:     return book.add({ev.ts_ns, ev.order_id, ev.px, ev.qty, ev.side});
+    case itch::EvType::Cancel:  book.cancel(ev.order_id); break;
+    case itch::EvType::Exec:
+      if (book.execute(ev.order_id, ev.qty, fill) > 0 && fill && ev.px != 0) fill->px = ev.px;
+      break;
+    case itch::EvType::Reduce:  book.reduce(ev.order_id, ev.qty); break;
+    case itch::EvType::Replace: {
+      const uint64_t before = book.rejects().total();
+      book.replace(ev.order_id, ev.new_id, ev.px, ev.qty);
+      return book.rejects().total() == before;
+    }
+  }
+  return true;
+}
+
+// Book for ev's instrument, created on first use outside the no-malloc guard.
+inline lob::Lob& book_for(lob::BookManager& books, uint16_t locate) {
+  if (lob::Lob* b = books.find(locate)) [[likely]] return *b;
+  nomalloc::ScopedAllow allow;
+  return books.book(locate);
+}
+
+// Stage s (0 = id slot, 1 = node, 2 = neighbours + level) of the lookahead
+// for one event. Books not created yet are skipped.
+inline void prefetch(const lob::BookManager& books, const itch::Event& ev, int stage) noexcept {
+  const lob::Lob* b = books.find(ev.locate);
+  if (!b) return;
+  if (ev.type == itch::EvType::Add) {
+    if (stage == 0) b->prefetch_id(ev.order_id);
+    else if (stage == 2) b->prefetch_level(ev.px, ev.side);
+    return;
+  }
+  if (stage == 0)      b->prefetch_id(ev.order_id);
+  else if (stage == 1) b->prefetch_order(ev.order_id);
+  else                 b->prefetch_links(ev.order_id);
+  if (ev.type == itch::EvType::Replace && stage == 2) b->prefetch_id(ev.new_id);
+}
+
+// Applies evs in order; fn(const itch::Event&, lob::Lob&, const lob::Fill&)
+// runs after each event's book update (the Fill as apply() reports it). ahead = 0 applies without prefetching.
+template <class Fn>
+void apply_batch(lob::BookManager& books, std::span<const itch::Event> evs, Fn&& fn,
+                 std::size_t ahead = 4) {
+  const std::size_t n = evs.size();
+  if (ahead > 0) {   // warm the pipeline for the first events
+    for (std::size_t j = 0; j < n && j < 3 * ahead; ++j) {
+      prefetch(books, evs[j], 0);
+      if (j < 2 * ahead) prefetch(books, evs[j], 1);
+      if (j < ahead)     prefetch(books, evs[j], 2);
+    }
+  }
+  for (std::size_t j = 0; j < n; ++j) {
+    if (ahead > 0) {
+      if (j + 3 * ahead < n) prefetch(books, evs[j + 3 * ahead], 0);
+      if (j + 2 * ahead < n) prefetch(books, evs[j + 2 * ahead], 1);
+      if (j + ahead < n)     prefetch(books, evs[j + ahead], 2);
+    }
+    lob::Lob& book = book_for(books, evs[j].locate);
+    lob::Fill fill;
+    apply(book, evs[j], &fill);
+    fn(evs[j], book, fill);
+  }
+}
+
+} // namespace t2t::engine
@@ -0,0 +1,146 @@
+#include "sharded.h"
+#include "batch.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "libutil/affinity.h"
+#include "libutil/nomalloc.h"
+
+namespace t2t::engine {
+
+ShardedEngine::Shard::Shard(const Config& cfg)
+: ring(cfg.ring_size),
+  data_wait(cfg.wait),
+  space_wait(cfg.wait),
+  books(cfg.book),
+  log_limit(cfg.log_capacity) {
+  log.reserve(log_limit);
+}
+
+ShardedEngine::ShardedEngine(const Config& cfg)
+: cfg_(cfg), route_(MAX_LOCATES) {
+  const unsigned n = cfg_.shards ? cfg_.shards : 1u;
+  shards_.reserve(n);
+  for (unsigned k = 0; k < n; ++k) shards_.push_back(std::make_unique<Shard>(cfg_));
+  for (std::size_t loc = 0; loc < MAX_LOCATES; ++loc) route_[loc] = static_cast<uint16_t>(loc % n);
+}
+
+ShardedEngine::~ShardedEngine() { finish(); }
+
+void ShardedEngine::set_spec(uint16_t locate, const lob::BookSpec& spec) {
+  shards_[route_[locate]]->books.set_spec(locate, spec);
+}
+
+void ShardedEngine::start() {
+  for (unsigned k = 0; k < shards_.size(); ++k) {
+    shards_[k]->th = std::thread([this, k] { run(k); });
+  }
+  while (ready_.load(std::memory_order_acquire) < shards_.size()) std::this_thread::yield();
+}
+
+void ShardedEngine::finish() {
+  done_.store(true, std::memory_order_release);
+  for (auto& s : shards_) s->data_wait.notify();
+  for (auto& s : shards_) if (s->th.joinable()) s->th.join();
+}
+
+// Cold path: first event for an instrument in this shard.
+ShardedEngine::Instrument& ShardedEngine::create(Shard& s, uint16_t locate) {
+  nomalloc::ScopedAllow allow;
+  s.books.book(locate);
+  Instrument& in = s.instr.emplace_back();
+  in.rg.configure(cfg_.inv_cap, cfg_.notional_cap, cfg_.throttle);
+  s.pub.instruments.store(static_cast<uint32_t>(s.instr.size()), std::memory_order_relaxed);
+  return in;
+}
+
+// Book + MM quote + risk gate for one event; same decisions as the
+// single-threaded heuristic path in t2t_main, per instrument. t_mark is when
+// this worker became free for the event (popped, or the previous event
+// decided) and advances to this event's decided mark.
+void ShardedEngine::on_event(Shard& s, const Routed& r, uint64_t& t_mark) {
+  const itch::Event& ev = r.ev;
+  const uint32_t idx = s.books.index_of(ev.locate);
+  Instrument& in = (idx != lob::BookManager::NONE) ? s.instr[idx] : create(s, ev.locate);
+  lob::Lob& book = *s.books.find(ev.locate);
+
+  const int     inv0 = in.pnl.inv;
+  const double  pnl0 = in.pnl.pnl;
+  lob::Fill fill;
+  apply(book, ev, &fill);
+  if (ev.type == itch::EvType::Cancel || ev.type == itch::EvType::Reduce) {
+    in.mm.on_cancel();
+  } else if (ev.type == itch::EvType::Exec) {
+    in.mm.on_exec();
+    if (fill.qty > 0) in.pnl.on_exec(fill.px, fill.qty, !fill.is_buy);
+  }
+  if (in.pnl.inv != inv0) {
+    s.net_inv   += in.pnl.inv - inv0;
+    s.gross_inv += std::abs(in.pnl.inv) - std::abs(inv0);
+    s.pnl       += in.pnl.pnl - pnl0;
+  }
+
+  const sig::Quote q = in.mm.quote(book, cfg_.q_alpha, cfg_.skew, in.pnl.inv, cfg_.inv_cap);
+  const bool allowed = !killed_.load(std::memory_order_relaxed) &&
+                       in.rg.allow(q, in.pnl.inv, cfg_.inv_cap, cfg_.notional_cap, ev.ts_ns);
+  s.quotes += allowed ? 1u : 0u;
+  ++s.processed;
+
+  const uint64_t t_done = timing::now_ticks();
+  if (s.log.size() < s.log_limit) {
+    s.log.push_back(Decision{r.seq, ev.ts_ns, t_done - r.t_ingress,
+                             (r.t_dispatch - r.t_ingress) + (t_done - t_mark), in.pnl.pnl, q,
+                             ev.order_id, in.pnl.inv, ev.locate, static_cast<char>(ev.type),
+                             ev.side, allowed});
+  }
+  t_mark = t_done;
+}
+
+void ShardedEngine::publish(Shard& s) noexcept {
+  s.pub.net_inv.store(s.net_inv, std::memory_order_relaxed);
+  s.pub.gross_inv.store(s.gross_inv, std::memory_order_relaxed);
+  s.pub.pnl.store(s.pnl, std::memory_order_relaxed);
+  s.pub.quotes.store(s.quotes, std::memory_order_relaxed);
+  s.pub.events.store(s.processed, std::memory_order_release);
+}
+
+void ShardedEngine::run(unsigned k) {
+  Shard& s = *shards_[k];
+  if (k < cfg_.cores.size() && cfg_.cores[k] >= 0) {
+    std::string info;
+    affinity::pin_to_core(cfg_.cores[k], &info);
+    std::fprintf(stderr, "[pin] shard %u %s\n", k, info.c_str());
+  }
+  ready_.fetch_add(1, std::memory_order_release);
+
+  Routed batch[BATCH];
+  for (;;) {
+    std::size_t n = 0;
+    s.data_wait.wait([&] {
+      n = s.ring.try_pop_n(batch, BATCH);
+      return n > 0 || done_.load(std::memory_order_acquire);
+    });
+    if (n == 0) n = s.ring.try_pop_n(batch, BATCH);   // anything pushed before done
+    if (n == 0) break;
+    s.space_wait.notify();
+    uint64_t t_mark = timing::now_ticks();
+    for (std::size_t i = 0; i < n; ++i) on_event(s, batch[i], t_mark);
+    publish(s);
+  }
+  publish(s);
+}
+
+RiskTotals ShardedEngine::totals() const noexcept {
+  RiskTotals t;
+  for (const auto& s : shards_) {
+    t.events      += s->pub.events.load(std::memory_order_acquire);
+    t.net_inv     += s->pub.net_inv.load(std::memory_order_relaxed);
+    t.gross_inv   += s->pub.gross_inv.load(std::memory_order_relaxed);
+    t.pnl         += s->pub.pnl.load(std::memory_order_relaxed);
+    t.quotes      += s->pub.quotes.load(std::memory_order_relaxed);
+    t.instruments += s->pub.instruments.load(std::memory_order_relaxed);
+  }
+  return t;
+}
+
+} // namespace t2t::engine
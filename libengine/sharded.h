@@ -0,0 +1,190 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "libitch/itch.h"
+#include "liblob/book_manager.h"
+#include "libring/spsc_ring.hpp"
+#include "libring/wait_strategy.hpp"
+#include "libsig/mm.h"
+#include "librisk/risk.h"
+#include "libutil/timing.h"
+
+// Symbol-sharded engine: one dispatcher thread (the caller) routes decoded
+// events by locate to N worker threads over per-shard SPSC rings. A worker
+// owns every piece of state for its instruments (book, MM signal, risk gate,
+// P&L), one set per instrument, so nothing on the hot path is shared and a
+// symbol's decisions do not depend on which other symbols share its shard.
+//
+//   ShardedEngine eng(cfg);
+//   eng.start();                       // spawn + pin workers
+//   for (...) eng.dispatch(ev);        // caller = dispatcher
+//   eng.finish();                      // drain + join
+//   eng.for_each_decision(fn);         // every event, in dispatch order
+//
+// Workers publish running totals to a per-shard, cache-line-sized slot after
+// each batch; totals() sums them for an asynchronous aggregate risk view, and
+// kill() stops all quoting from any thread.
+namespace t2t::engine {
+
+struct Config {
+  unsigned         shards{1};
+  std::vector<int> cores;              // worker k pinned to cores[k] if present
+  std::size_t      ring_size{4096};    // per shard, power of two
+  ring::WaitPolicy wait{ring::WaitPolicy::SpinYield};
+  lob::BookSpec    book{};             // default per-instrument book sizing
+  int              inv_cap{100};
+  double           notional_cap{1e12};
+  int              throttle{200};      // quotes per ms, per instrument
+  double           q_alpha{0.01};      // MM spread widening with |inv|
+  double           skew{2.0};          // MM price skew with inv
+  std::size_t      log_capacity{0};    // decisions kept per shard (0 = none); see reserve_log()
+};
+
+// What risk + encode decided for one event (one per event when logging).
+struct Decision {
+  uint64_t   seq;            // dispatch order
+  uint64_t   ts_ns;
+  uint64_t   latency_ticks;  // ingress -> decided; tsc::to_ns() for ns
+  uint64_t   service_ticks;  // of which decode + worker time (the rest is queueing)
+  double     pnl;
+  sig::Quote q;
+  uint32_t   order_id;
+  int32_t    inv;
+  uint16_t   locate;
+  char       type;
+  bool       side;
+  bool       allowed;
+};
+
+// Aggregate risk view (sum over shards; each shard's part is at most one
+// batch old).
+struct RiskTotals {
+  int64_t  net_inv{0};     // sum of instrument inventories
+  int64_t  gross_inv{0};   // sum of |inventory|
+  double   pnl{0.0};
+  uint64_t events{0};
+  uint64_t quotes{0};      // decisions the risk gate allowed
+  uint32_t instruments{0};
+};
+
+class ShardedEngine {
+public:
+  static constexpr std::size_t MAX_LOCATES = lob::BookManager::MAX_LOCATES;
+  static constexpr std::size_t BATCH = 64;   // worker pop batch
+
+  explicit ShardedEngine(const Config& cfg);
+  ~ShardedEngine();
+  ShardedEngine(const ShardedEngine&)            = delete;
+  ShardedEngine& operator=(const ShardedEngine&) = delete;
+
+  // Before start(): routing (default locate % shards) and book sizing.
+  void set_shard(uint16_t locate, unsigned shard) { route_[locate] = static_cast<uint16_t>(shard % shards_.size()); }
+  void set_spec(uint16_t locate, const lob::BookSpec& spec);
+  // Shard k logs up to n decisions instead of Config::log_capacity, e.g.
+  // its exact share of a feed counted through shard_of(). A full log stops
+  // recording; log_dropped() says how many decisions that lost.
+  void reserve_log(unsigned k, std::size_t n) {
+    shards_[k]->log_limit = n;
+    shards_[k]->log.reserve(n);
+  }
+
+  void start();
+  // Dispatcher thread only. Blocks (per the wait policy) while the shard's
+  // ring is full. t_ingress (timing::now_ticks) is when the feed handler
+  // first saw ev, before decoding; without it the event enters at dispatch.
+  void dispatch(const itch::Event& ev, uint64_t t_ingress) noexcept {
+    Shard& s = *shards_[route_[ev.locate]];
+    const Routed r{ev, seq_++, t_ingress, timing::now_ticks()};
+    s.space_wait.wait([&] { return s.ring.try_push(r); });
+    s.data_wait.notify();
+  }
+  void dispatch(const itch::Event& ev) noexcept { dispatch(ev, timing::now_ticks()); }
+  // Signal end of input, let workers drain, join them.
+  void finish();
+
+  void kill() noexcept { killed_.store(true, std::memory_order_relaxed); }
+  RiskTotals totals() const noexcept;
+
+  unsigned    shards() const noexcept { return static_cast<unsigned>(shards_.size()); }
+  unsigned    shard_of(uint16_t locate) const noexcept { return route_[locate]; }
+  uint64_t    dispatched() const noexcept { return seq_; }
+  std::size_t shard_events(unsigned k) const noexcept { return shards_[k]->processed; }
+  std::size_t log_dropped(unsigned k) const noexcept {   // after finish()
+    return shards_[k]->processed - shards_[k]->log.size();
+  }
+  const lob::BookManager& books(unsigned k) const noexcept { return shards_[k]->books; }
+
+  // After finish(): fn(const Decision&) for every logged decision, merged
+  // across shards in dispatch order. Identical for any shard count.
+  template <class Fn> void for_each_decision(Fn&& fn) const;
+
+private:
+  struct Routed {
+    itch::Event ev;
+    uint64_t    seq;
+    uint64_t    t_ingress;    // ticks
+    uint64_t    t_dispatch;
+  };
+  struct Instrument {
+    sig::MM    mm;
+    risk::Risk rg;
+    risk::PnL  pnl;
+  };
+  struct alignas(64) Published {
+    std::atomic<int64_t>  net_inv{0}, gross_inv{0};
+    std::atomic<double>   pnl{0.0};
+    std::atomic<uint64_t> events{0}, quotes{0};
+    std::atomic<uint32_t> instruments{0};
+  };
+  struct alignas(64) Shard {
+    explicit Shard(const Config& cfg);
+    ring::SpscRing<Routed>  ring;
+    ring::Waiter            data_wait, space_wait;
+    lob::BookManager        books;
+    std::vector<Instrument> instr;   // parallel to books (creation index)
+    std::vector<Decision>   log;     // reserved to log_limit; never grows past it
+    std::size_t log_limit{0};        // Config::log_capacity or reserve_log()
+    int64_t  net_inv{0}, gross_inv{0};
+    double   pnl{0.0};
+    uint64_t quotes{0};
+    std::size_t processed{0};
+    Published pub;
+    std::thread th;
+  };
+
+  void run(unsigned k);
+  void on_event(Shard& s, const Routed& r, uint64_t& t_mark);
+  void publish(Shard& s) noexcept;
+  Instrument& create(Shard& s, uint16_t locate);
+
+  Config cfg_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::vector<uint16_t> route_;       // locate -> shard
+  uint64_t seq_{0};                   // dispatcher-owned
+  std::atomic<bool> done_{false};
+  std::atomic<bool> killed_{false};
+  std::atomic<unsigned> ready_{0};
+};
+
+template <class Fn>
+void ShardedEngine::for_each_decision(Fn&& fn) const {
+  // k-way merge on seq; each shard's log is already in seq order.
+  std::vector<std::size_t> pos(shards_.size(), 0);
+  for (;;) {
+    const Decision* best = nullptr;
+    std::size_t bk = 0;
+    for (std::size_t k = 0; k < shards_.size(); ++k) {
+      const auto& log = shards_[k]->log;
+      if (pos[k] < log.size() && (!best || log[pos[k]].seq < best->seq)) { best = &log[pos[k]]; bk = k; }
+    }
+    if (!best) return;
+    fn(*best);
+    ++pos[bk];
+  }
+}
+
+} // namespace t2t::engine
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "csv_scan.h"
+#include "itch.h"
+#include "mapped_file.h"
+
+namespace t2t::itch {
+
+// Row-at-a-time reader over a mapped CSV replay: same parser, header
+// handling and error text as Replay::load_csv, without materialising the
+// event vector (streaming mode). next() never allocates.
+class CsvCursor {
+public:
+  // Returns true on success; false fills *err with message.
+  bool open(const std::string& path, std::string* err);
+
+  // Next row, or false at end of data or on the first bad row.
+  bool next(Event& ev) noexcept;
+  bool error() const noexcept { return bad_ != nullptr; }
+  // "parse error: <line>" for the bad row (empty if none).
+  std::string error_message() const;
+
+  // Lines left from the current position (upper bound on rows).
+  std::size_t count_rows() const noexcept;
+
+private:
+  MappedFile        map_;
+  const char*       p_{nullptr};
+  const char*       end_{nullptr};
+  const char*       bad_{nullptr};
+  csv::DelimScanner sc_;
+  bool              locate_col_{false};
+};
+
+} // namespace t2t::itch
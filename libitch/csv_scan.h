@@ -0,0 +1,144 @@
+#pragma once
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__AVX2__) || defined(__SSE2__)
+  #include <immintrin.h>
+#endif
+
+// Building blocks for the mmap CSV loader: 64-byte delimiter bitmasks
+// (AVX2 / SSE2 / scalar) and a SWAR fixed-width digit parser that falls back
+// to std::from_chars for anything it does not handle, so results and errors
+// match the from_chars path exactly.
+namespace t2t::itch::csv {
+
+// Bit i set iff p[i] == a || p[i] == b, for p[0..63] (all readable).
+inline uint64_t match_mask64(const char* p, char a, char b) noexcept {
+#if defined(__AVX2__)
+  const __m256i va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b);
+  const __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  const __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+  const uint32_t m0 = static_cast<uint32_t>(_mm256_movemask_epi8(
+      _mm256_or_si256(_mm256_cmpeq_epi8(x0, va), _mm256_cmpeq_epi8(x0, vb))));
+  const uint32_t m1 = static_cast<uint32_t>(_mm256_movemask_epi8(
+      _mm256_or_si256(_mm256_cmpeq_epi8(x1, va), _mm256_cmpeq_epi8(x1, vb))));
+  return static_cast<uint64_t>(m0) | (static_cast<uint64_t>(m1) << 32);
+#elif defined(__SSE2__)
+  const __m128i va = _mm_set1_epi8(a), vb = _mm_set1_epi8(b);
+  uint64_t m = 0;
+  for (int k = 0; k < 4; ++k) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+    const uint32_t mk = static_cast<uint32_t>(_mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(x, va), _mm_cmpeq_epi8(x, vb))));
+    m |= static_cast<uint64_t>(mk) << (16 * k);
+  }
+  return m;
+#else
+  uint64_t m = 0;
+  for (unsigned i = 0; i < 64; ++i) m |= static_cast<uint64_t>(p[i] == a || p[i] == b) << i;
+  return m;
+#endif
+}
+
+// Same for a partial block of n < 64 bytes.
+inline uint64_t match_mask_tail(const char* p, std::size_t n, char a, char b) noexcept {
+  uint64_t m = 0;
+  for (std::size_t i = 0; i < n; ++i) m |= static_cast<uint64_t>(p[i] == a || p[i] == b) << i;
+  return m;
+}
+
+// Yields the position of every ',' and '\n' in [begin, end) in order,
+// one 64-byte compare per block and one tzcnt per delimiter.
+class DelimScanner {
+public:
+  DelimScanner() noexcept = default;
+  DelimScanner(const char* begin, const char* end) noexcept
+  : base_(begin), n_(static_cast<std::size_t>(end - begin)) { load(); }
+
+  // Next delimiter, or end once the range is exhausted.
+  inline const char* next() noexcept {
+    while (mask_ == 0) {
+      if (off_ + 64u >= n_) return base_ + n_;
+      off_ += 64u;
+      load();
+    }
+    const std::size_t i = off_ + static_cast<std::size_t>(std::countr_zero(mask_));
+    mask_ &= mask_ - 1u;
+    return base_ + i;
+  }
+
+private:
+  const char* base_{nullptr};
+  std::size_t n_{0};
+  std::size_t off_{0};
+  uint64_t    mask_{0};
+
+  inline void load() noexcept {
+    const std::size_t left = n_ - off_;
+    mask_ = left >= 64u ? match_mask64(base_ + off_, ',', '\n')
+                        : match_mask_tail(base_ + off_, left, ',', '\n');
+  }
+};
+
+// Number of lines in [p, end): newlines, plus one for an unterminated tail.
+inline std::size_t count_lines(const char* p, const char* end) noexcept {
+  const std::size_t n = static_cast<std::size_t>(end - p);
+  std::size_t lines = 0, i = 0;
+  for (; i + 64u <= n; i += 64u) lines += static_cast<std::size_t>(std::popcount(match_mask64(p + i, '\n', '\n')));
+  lines += static_cast<std::size_t>(std::popcount(match_mask_tail(p + i, n - i, '\n', '\n')));
+  if (n > 0 && end[-1] != '\n') ++lines;
+  return lines;
+}
+
+// ---- fixed-width digits (SWAR) ----
+
+inline bool all_digits8(uint64_t v) noexcept {
+  return ((v & 0xF0F0F0F0F0F0F0F0ull) |
+          (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+// Eight ASCII digits, p[0] most significant (little-endian load).
+inline uint32_t digits8(uint64_t v) noexcept {
+  v = ((v & 0x0F0F0F0F0F0F0F0Full) * 2561u) >> 8;
+  v = ((v & 0x00FF00FF00FF00FFull) * 6553601u) >> 16;
+  return static_cast<uint32_t>(((v & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32);
+}
+// 1..8 digits at p; needs p[0..7] readable. Short fields are left-padded
+// with '0' bytes so the 8-digit kernel applies unchanged.
+inline bool small_digits(const char* p, std::size_t len, uint64_t& out) noexcept {
+  uint64_t v; std::memcpy(&v, p, 8);
+  if (len < 8u) {
+    const unsigned sh = static_cast<unsigned>(8u * (8u - len));
+    v = (v << sh) | (0x3030303030303030ull >> (64u - sh));
+  }
+  if (!all_digits8(v)) return false;
+  out = digits8(v);
+  return true;
+}
+// 1..16 plain digits in [p, p+len) with p+8 <= limit; false if any non-digit.
+inline bool fast_digits(const char* p, std::size_t len, const char* limit, uint64_t& out) noexcept {
+  if (len == 0 || len > 16u || p + 8 > limit) return false;
+  if (len <= 8u) return small_digits(p, len, out);
+  uint64_t hi, lo;
+  if (!small_digits(p, len - 8u, hi) || !small_digits(p + len - 8u, 8u, lo)) return false;
+  out = hi * 100'000'000ull + lo;
+  return true;
+}
+
+inline bool parse_u64(const char* p, std::size_t len, const char* limit, uint64_t& out) noexcept {
+  if (fast_digits(p, len, limit, out)) return true;
+  return std::from_chars(p, p + len, out).ec == std::errc();
+}
+inline bool parse_u32(const char* p, std::size_t len, const char* limit, uint32_t& out) noexcept {
+  uint64_t v;
+  if (len <= 9u && fast_digits(p, len, limit, v)) { out = static_cast<uint32_t>(v); return true; }
+  return std::from_chars(p, p + len, out).ec == std::errc();
+}
+inline bool parse_i32(const char* p, std::size_t len, const char* limit, int32_t& out) noexcept {
+  uint64_t v;
+  if (len <= 9u && fast_digits(p, len, limit, v)) { out = static_cast<int32_t>(v); return true; }
+  return std::from_chars(p, p + len, out).ec == std::errc();
+}
+
+} // namespace t2t::itch::csv
@@ -1,7 +1,13 @@
 #include "itch.h"
+#include "csv_cursor.h"
+#include "csv_scan.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <fstream>
-#include <charconv>
 #include <string>
+#include <thread>
 
 namespace t2t::itch {
 
@@ -12,73 +18,212 @@ static inline bool parse_bool01bs(const char* p, std::size_t len, bool& out) {
   return false;
 }
 
-static inline bool parse_u64(const char* p, std::size_t len, uint64_t& out) {
-  auto res = std::from_chars(p, p+len, out);
-  return res.ec == std::errc();
+// Parse the row starting at p (p < end) into ev and advance p past its
+// newline. Same semantics as the original getline + from_chars loop: blank or
+// short lines are errors, columns past the sixth are ignored. The six columns
+// are parsed straight-line; any failure rejects the row and leaves p at the
+// start of the bad line. A 'U' (replace) row is an error: without a new_id
+// column it would re-key the order to id 0. With locate_col (header ends in ",locate") a
+// seventh column holding the instrument's locate code (0..65535) is required.
+static inline bool parse_row(const char*& p, const char* end, csv::DelimScanner& sc, Event& ev,
+                             bool locate_col) {
+  auto at_eol = [end](const char* d) { return d == end || *d == '\n'; };
+  auto flen   = [](const char* b, const char* e) { return static_cast<std::size_t>(e - b); };
+  ev = Event{};
+
+  const char* d0 = sc.next();
+  if (!csv::parse_u64(p, flen(p, d0), end, ev.ts_ns) || at_eol(d0)) return false;
+  const char* d1 = sc.next();
+  ev.type = static_cast<EvType>(d1 > d0 + 1 ? d0[1] : 'A');
+  if (at_eol(d1) || ev.type == EvType::Replace) return false;
+  const char* d2 = sc.next();
+  if (!csv::parse_u32(d1 + 1, flen(d1 + 1, d2), end, ev.order_id) || at_eol(d2)) return false;
+  const char* d3 = sc.next();
+  if (!parse_bool01bs(d2 + 1, flen(d2 + 1, d3), ev.side) || at_eol(d3)) return false;
+  const char* d4 = sc.next();
+  if (!csv::parse_i32(d3 + 1, flen(d3 + 1, d4), end, ev.px) || at_eol(d4)) return false;
+  const char* d5 = sc.next();
+  if (!csv::parse_i32(d4 + 1, flen(d4 + 1, d5), end, ev.qty)) return false;
+  if (locate_col) {
+    if (at_eol(d5)) return false;
+    const char* d6 = sc.next();
+    uint32_t loc;
+    if (!csv::parse_u32(d5 + 1, flen(d5 + 1, d6), end, loc) || loc > UINT16_MAX) return false;
+    ev.locate = static_cast<uint16_t>(loc);
+    d5 = d6;
+  }
+  while (!at_eol(d5)) d5 = sc.next();   // ignore extra columns
+  p = (d5 == end) ? end : d5 + 1;
+  return true;
+}
+
+static std::string parse_error(const char* line, const char* end) {
+  const void* nl = std::memchr(line, '\n', static_cast<std::size_t>(end - line));
+  const char* le = nl ? static_cast<const char*>(nl) : end;
+  return "parse error: " + std::string(line, static_cast<std::size_t>(le - line));
+}
+
+// Parse up to max_rows rows in [p, end) into out[0..); the row cap is checked
+// before each row is parsed. *n_out is the number of rows written (rows
+// before the error).
+static bool parse_rows(const char* p, const char* end, std::size_t max_rows, bool locate_col,
+                       Event* out, std::size_t* n_out, std::string* err) {
+  csv::DelimScanner sc(p, end);
+  std::size_t n = 0;
+  while (p < end && n < max_rows) {
+    if (!parse_row(p, end, sc, out[n], locate_col)) {
+      *n_out = n;
+      if (err) *err = parse_error(p, end);
+      return false;
+    }
+    ++n;
+  }
+  *n_out = n;
+  return true;
 }
-static inline bool parse_u32(const char* p, std::size_t len, uint32_t& out) {
-  auto res = std::from_chars(p, p+len, out);
-  return res.ec == std::errc();
+
+// Skip the header line if present; *locate_col is set when the header names
+// the optional seventh "locate" column.
+static const char* skip_header(const char* p, const char* end, bool* locate_col) {
+  static constexpr char kLocateHdr[] = "ts_ns,type,order_id,side,px,qty,locate";
+  static constexpr std::size_t kLocateLen = sizeof(kLocateHdr) - 1;
+  *locate_col = false;
+  const void* nl = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+  const char* le = nl ? static_cast<const char*>(nl) : end;
+  if (le - p >= 6 && std::memcmp(p, "ts_ns,", 6) == 0) {
+    const std::size_t n = static_cast<std::size_t>(le - p);
+    *locate_col = n >= kLocateLen && std::memcmp(p, kLocateHdr, kLocateLen) == 0 &&
+                  (n == kLocateLen || p[kLocateLen] == '\r' || p[kLocateLen] == ',');
+    return nl ? le + 1 : end;
+  }
+  return p;
 }
-static inline bool parse_i32(const char* p, std::size_t len, int32_t& out) {
-  auto res = std::from_chars(p, p+len, out);
-  return res.ec == std::errc();
+
+bool CsvCursor::open(const std::string& path, std::string* err) {
+  if (!map_.open(path, nullptr)) { if (err) *err = "cannot open: " + path; return false; }
+  p_   = map_.chars();
+  end_ = p_ + map_.size();
+  locate_col_ = false;
+  if (p_ != end_) p_ = skip_header(p_, end_, &locate_col_);
+  sc_  = csv::DelimScanner(p_, end_);
+  bad_ = nullptr;
+  return true;
+}
+
+bool CsvCursor::next(Event& ev) noexcept {
+  if (p_ >= end_ || bad_) return false;
+  if (parse_row(p_, end_, sc_, ev, locate_col_)) return true;
+  bad_ = p_;
+  return false;
+}
+
+std::size_t CsvCursor::count_rows() const noexcept { return csv::count_lines(p_, end_); }
+
+std::string CsvCursor::error_message() const {
+  return bad_ ? parse_error(bad_, end_) : std::string();
+}
+
+static uint64_t steady_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Run fn(k) for k in [0, n): workers 1..n-1 on their own threads, worker 0 on
+// the caller. n == 1 never spawns.
+template <class Fn>
+static void run_workers(unsigned n, Fn&& fn) {
+  std::vector<std::thread> th;
+  th.reserve(n > 0 ? n - 1 : 0);
+  for (unsigned k = 1; k < n; ++k) th.emplace_back([&fn, k] { fn(k); });
+  fn(0u);
+  for (auto& t : th) t.join();
 }
 
 bool Replay::load_csv(const std::string& path, std::size_t max_msgs, std::string* err) {
-  std::ifstream ifs(path);
-  if (!ifs) { if (err) *err = "cannot open: " + path; return false; }
+  return load_csv_parallel(path, max_msgs, 1, err, nullptr);
+}
+
+// Two passes over newline-aligned chunks. Every data line is exactly one row
+// (or an error), so counting lines per chunk gives each chunk its global row
+// offset; the second pass parses each chunk straight into its slice of
+// events, capped at max_msgs. The first chunk (in file order) that fails
+// decides the error and where events is truncated, exactly as a serial scan.
+bool Replay::load_csv_parallel(const std::string& path, std::size_t max_msgs, unsigned threads,
+                               std::string* err, LoadStats* stats) {
+  const uint64_t t_begin = steady_ns();
+  if (stats) *stats = LoadStats{};
+  MappedFile f;
+  if (!f.open(path, nullptr, /*populate=*/true)) { if (err) *err = "cannot open: " + path; return false; }
 
   events.clear();
-  events.reserve(max_msgs ? max_msgs : 1'000'000);
-
-  std::string line;
-  // Peek first line; if it doesn't start with header, rewind.
-  if (std::getline(ifs, line)) {
-    if (line.rfind("ts_ns,", 0) != 0) {
-      ifs.clear();
-      ifs.seekg(0);
-    }
-  } else {
-    return true;
+  const char* p   = f.chars();
+  const char* end = p + f.size();
+  if (p == end) return true;
+
+  bool locate_col;
+  p = skip_header(p, end, &locate_col);
+
+  // Cut points: each chunk starts at the beginning of a line. Tiny files may
+  // produce empty chunks, which are harmless.
+  const unsigned T = threads ? threads : 1u;
+  const std::size_t bytes = static_cast<std::size_t>(end - p);
+  std::vector<const char*> cut(T + 1);
+  cut[0] = p; cut[T] = end;
+  for (unsigned k = 1; k < T; ++k) {
+    const char* c = p + bytes / T * k;
+    if (c < cut[k - 1]) c = cut[k - 1];
+    if (c == p || c == end) { cut[k] = c; continue; }
+    const void* q = std::memchr(c - 1, '\n', static_cast<std::size_t>(end - (c - 1)));
+    cut[k] = q ? static_cast<const char*>(q) + 1 : end;
   }
 
-  while (std::getline(ifs, line)) {
-    if (max_msgs && events.size() >= max_msgs) break;
-
-    const char* s = line.c_str();
-    const char* e = s + line.size();
-    const char* p = s;
-    int col = 0;
-    Event ev{};
-
-    while (p <= e) {
-      const char* q = p;
-      while (q < e && *q != ',') ++q;
-      std::size_t len = static_cast<std::size_t>(q - p);
-
-      switch (col) {
-        case 0: if (!parse_u64(p, len, ev.ts_ns))                goto bad; break;
-        case 1: ev.type = static_cast<EvType>(len ? p[0] : 'A');        break;
-        case 2: if (!parse_u32(p, len, ev.order_id))             goto bad; break;
-        case 3: if (!parse_bool01bs(p, len, ev.side))            goto bad; break;
-        case 4: if (!parse_i32(p, len, ev.px))                   goto bad; break;
-        case 5: if (!parse_i32(p, len, ev.qty))                  goto bad; break;
-        default: break;
-      }
-      ++col;
-      p = (q < e) ? (q + 1) : (e + 1);
+  std::vector<LoadStats::Worker> ws(T);
+  std::vector<std::size_t> lines(T), start(T), got(T);
+  std::vector<std::string> errs(T);
+  std::vector<char> ok(T, 1);
+
+  run_workers(T, [&](unsigned k) {
+    const uint64_t t0 = steady_ns();
+    lines[k] = csv::count_lines(cut[k], cut[k + 1]);
+    ws[k].bytes = static_cast<std::size_t>(cut[k + 1] - cut[k]);
+    ws[k].count_ns = steady_ns() - t0;
+  });
+
+  std::size_t total = 0;
+  for (unsigned k = 0; k < T; ++k) { start[k] = total; total += lines[k]; }
+  if (max_msgs && total > max_msgs) total = max_msgs;
+
+  const uint64_t t_alloc = steady_ns();
+  events.resize(total);
+  const uint64_t alloc_ns = steady_ns() - t_alloc;
+
+  run_workers(T, [&](unsigned k) {
+    const uint64_t t0 = steady_ns();
+    got[k] = 0;
+    if (start[k] < total) {
+      const std::size_t want = std::min(lines[k], total - start[k]);
+      ok[k] = parse_rows(cut[k], cut[k + 1], want, locate_col, events.data() + start[k], &got[k],
+                         err ? &errs[k] : nullptr) ? 1 : 0;
     }
+    ws[k].rows = got[k];
+    ws[k].parse_ns = steady_ns() - t0;
+  });
 
-    if (col < 6) goto bad;
-    events.push_back(ev);
-    continue;
+  bool result = true;
+  for (unsigned k = 0; k < T; ++k) {
+    if (ok[k]) continue;
+    events.resize(start[k] + got[k]);
+    if (err) *err = std::move(errs[k]);
+    result = false;
+    break;
+  }
 
-  bad:
-    if (err) *err = "parse error: " + line;
-    return false;
+  if (stats) {
+    stats->workers = std::move(ws);
+    stats->alloc_ns = alloc_ns;
+    stats->total_ns = steady_ns() - t_begin;
   }
-  return true;
+  return result;
 }
 
 bool write_output_csv(const std::string& path, const std::vector<char>& buf) {
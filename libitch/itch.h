@@ -5,29 +5,54 @@
 
 namespace t2t::itch {
 
-// Event type: Add / Cancel / Exec (synthetic ITCH-like)
-enum class EvType : uint8_t { Add = 'A', Cancel = 'C', Exec = 'E' };
+// Event type: Add / Cancel / Exec / Reduce (synthetic ITCH-like 'A'/'C'/'E'/'X')
+// + Replace (ITCH 5.0 'U', binary feeds only). Cancel deletes the whole
+// order; Exec and Reduce take qty shares off it (a fill, a partial cancel).
+enum class EvType : uint8_t { Add = 'A', Cancel = 'C', Exec = 'E', Reduce = 'X', Replace = 'U' };
 
 // One normalized event row.
 struct Event {
   uint64_t ts_ns;    // nanoseconds since start (from CSV)
-  EvType   type;     // 'A'/'C'/'E'
+  EvType   type;     // 'A'/'C'/'E'/'X'/'U'
+  uint16_t locate;   // instrument (ITCH stock locate); 0 for single-symbol feeds
   uint32_t order_id; // synthetic id
   bool     side;     // true=buy, false=sell
   int32_t  px;       // integer ticks
   int32_t  qty;      // quantity (positive)
+  uint32_t new_id;   // Replace only: id of the replacing order (order_id = original)
 };
 
 // A deterministic, allocation-light replay loader (CSV → std::vector<Event>).
 struct Replay {
   std::vector<Event> events; // pre-parsed rows
 
-  // Parse a CSV with header: ts_ns,type,order_id,side,px,qty
+  // Parse a CSV with header: ts_ns,type,order_id,side,px,qty[,locate]
+  // - locate (instrument) is read only when the header names it; else 0
   // - side accepts: 1/0, B/S, b/s
-  // - type accepts: A/C/E
+  // - type accepts: A/C/E/X (empty = A); U is a parse error, as a replace
+  //   needs a new_id and the CSV has no column for it
   // - max_msgs==0 means no hard cap
   // Returns true on success; false fills *err with message.
   bool load_csv(const std::string& path, std::size_t max_msgs, std::string* err);
+
+  // Per-call timing of a parallel load (wall clock, ns).
+  struct LoadStats {
+    struct Worker {
+      std::size_t bytes{0};    // chunk size
+      std::size_t rows{0};     // rows parsed into this worker's slice
+      uint64_t    count_ns{0}; // pass 1: newline count
+      uint64_t    parse_ns{0}; // pass 2: parse into slice
+    };
+    std::vector<Worker> workers;
+    uint64_t alloc_ns{0};      // sizing the output vector (serial)
+    uint64_t total_ns{0};      // whole call including mmap
+  };
+
+  // Same result as load_csv (events, max_msgs, first error), but the file is
+  // split into `threads` newline-aligned chunks parsed concurrently, each
+  // into its own slice of events. threads<=1 runs on the calling thread.
+  bool load_csv_parallel(const std::string& path, std::size_t max_msgs, unsigned threads,
+                         std::string* err, LoadStats* stats = nullptr);
 };
 
 // Utility: write a byte buffer to a file (used later for encoded outputs).
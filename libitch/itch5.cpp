@@ -0,0 +1,183 @@
+#include "itch5.h"
+#include <array>
+
+namespace t2t::itch {
+
+namespace itch5 {
+
+static constexpr std::array<uint16_t, 256> make_len_table() {
+  std::array<uint16_t, 256> t{};
+  t['S'] = 12; t['R'] = 39; t['H'] = 25; t['Y'] = 20; t['L'] = 26;
+  t['V'] = 35; t['W'] = 12; t['K'] = 28; t['J'] = 35; t['h'] = 21;
+  t['A'] = 36; t['F'] = 40; t['E'] = 31; t['C'] = 36; t['X'] = 23;
+  t['D'] = 19; t['U'] = 35; t['P'] = 44; t['Q'] = 40; t['B'] = 19;
+  t['I'] = 50; t['N'] = 20; t['O'] = 48;
+  return t;
+}
+static constexpr std::array<uint16_t, 256> kLen = make_len_table();
+
+uint16_t msg_len(uint8_t type) noexcept { return kLen[type]; }
+
+// Common header: type(1) locate(2) tracking(2) timestamp(6); body at 11.
+static constexpr std::size_t HDR = 11;
+
+bool decode(const uint8_t* m, std::size_t len, Event& ev) noexcept {
+  const uint8_t t = m[0];
+  if (len < kLen[t] || kLen[t] == 0) return false;
+  switch (t) {
+    case 'A': case 'F':
+      ev.type = EvType::Add;
+      ev.order_id = static_cast<uint32_t>(be64(m + HDR));
+      ev.side = (m[19] == 'B');
+      ev.qty = static_cast<int32_t>(be32(m + 20));
+      ev.px  = static_cast<int32_t>(be32(m + 32));
+      ev.new_id = 0;
+      break;
+    case 'E': case 'C':
+      ev.type = EvType::Exec;
+      ev.order_id = static_cast<uint32_t>(be64(m + HDR));
+      ev.side = false;
+      ev.qty = static_cast<int32_t>(be32(m + 19));
+      ev.px  = (t == 'C') ? static_cast<int32_t>(be32(m + 32)) : 0;
+      ev.new_id = 0;
+      break;
+    case 'X': case 'D':
+      ev.type = (t == 'X') ? EvType::Reduce : EvType::Cancel;
+      ev.order_id = static_cast<uint32_t>(be64(m + HDR));
+      ev.side = false;
+      ev.qty = (t == 'X') ? static_cast<int32_t>(be32(m + 19)) : 0;
+      ev.px  = 0;
+      ev.new_id = 0;
+      break;
+    case 'U':
+      ev.type = EvType::Replace;
+      ev.order_id = static_cast<uint32_t>(be64(m + HDR));
+      ev.new_id   = static_cast<uint32_t>(be64(m + 19));
+      ev.side = false;
+      ev.qty = static_cast<int32_t>(be32(m + 27));
+      ev.px  = static_cast<int32_t>(be32(m + 31));
+      break;
+    default:
+      return false;
+  }
+  ev.locate = be16(m + 1);
+  ev.ts_ns = be48(m + 5);
+  return true;
+}
+
+bool decode_directory(const uint8_t* m, std::size_t len, uint16_t& locate, char (&symbol)[9]) noexcept {
+  if (len < kLen['R'] || m[0] != 'R') return false;
+  locate = be16(m + 1);
+  std::size_t n = 8;
+  while (n > 0 && m[HDR + n - 1] == ' ') --n;
+  std::memcpy(symbol, m + HDR, n);
+  symbol[n] = '\0';
+  return true;
+}
+
+static inline void put16(uint8_t* p, uint16_t v) noexcept { v = __builtin_bswap16(v); std::memcpy(p, &v, 2); }
+static inline void put32(uint8_t* p, uint32_t v) noexcept { v = __builtin_bswap32(v); std::memcpy(p, &v, 4); }
+static inline void put64(uint8_t* p, uint64_t v) noexcept { v = __builtin_bswap64(v); std::memcpy(p, &v, 8); }
+static inline void put48(uint8_t* p, uint64_t v) noexcept {
+  put16(p, static_cast<uint16_t>(v >> 32)); put32(p + 2, static_cast<uint32_t>(v));
+}
+
+std::size_t encode(const Event& ev, uint8_t* m) noexcept {
+  uint8_t t = 0;
+  switch (ev.type) {
+    case EvType::Add:     t = 'A'; break;
+    case EvType::Exec:    t = 'E'; break;
+    case EvType::Cancel:  t = 'D'; break;
+    case EvType::Reduce:  t = 'X'; break;
+    case EvType::Replace: t = 'U'; break;
+    default: return 0;
+  }
+  const std::size_t len = kLen[t];
+  std::memset(m, 0, len);
+  m[0] = t;
+  put16(m + 1, ev.locate);
+  put48(m + 5, ev.ts_ns);
+  put64(m + HDR, ev.order_id);
+  switch (t) {
+    case 'A':
+      m[19] = ev.side ? 'B' : 'S';
+      put32(m + 20, static_cast<uint32_t>(ev.qty));
+      std::memcpy(m + 24, "T2T     ", 8);
+      put32(m + 32, static_cast<uint32_t>(ev.px));
+      break;
+    case 'E': put32(m + 19, static_cast<uint32_t>(ev.qty)); break;
+    case 'X': put32(m + 19, static_cast<uint32_t>(ev.qty)); break;
+    case 'U':
+      put64(m + 19, ev.new_id);
+      put32(m + 27, static_cast<uint32_t>(ev.qty));
+      put32(m + 31, static_cast<uint32_t>(ev.px));
+      break;
+    default: break;
+  }
+  return len;
+}
+
+void append(std::vector<uint8_t>& buf, const Event& ev, Framing framing) {
+  uint8_t m[64];
+  const std::size_t len = encode(ev, m);
+  if (!len) return;
+  if (framing == Framing::LengthPrefixed) {
+    uint8_t hdr[2];
+    put16(hdr, static_cast<uint16_t>(len));
+    buf.insert(buf.end(), hdr, hdr + 2);
+  }
+  buf.insert(buf.end(), m, m + len);
+}
+
+} // namespace itch5
+
+// -------- Itch5Cursor --------
+bool Itch5Cursor::next_msg(const uint8_t*& msg, std::size_t& len) noexcept {
+  const std::size_t left = static_cast<std::size_t>(end_ - p_);
+  if (left == 0) return false;
+  if (framing_ == itch5::Framing::LengthPrefixed) {
+    if (left < 2) { error_ = true; return false; }
+    len = itch5::be16(p_);
+    if (len == 0 || left - 2u < len) { error_ = true; return false; }
+    msg = p_ + 2;
+    p_ += 2u + len;
+  } else {
+    len = itch5::msg_len(p_[0]);
+    if (len == 0 || left < len) { error_ = true; return false; }
+    msg = p_;
+    p_ += len;
+  }
+  return true;
+}
+
+bool Itch5Cursor::next(Event& ev) noexcept {
+  const uint8_t* m; std::size_t len;
+  while (next_msg(m, len)) {
+    if (itch5::decode(m, len, ev)) return true;
+  }
+  return false;
+}
+
+// -------- Itch5File --------
+bool Itch5File::open(const std::string& path, itch5::Framing framing, std::string* err) {
+  if (!map_.open(path, err)) return false;
+  if (framing == itch5::Framing::Auto) {
+    framing = (size() > 0 && data()[0] == 0) ? itch5::Framing::LengthPrefixed : itch5::Framing::Raw;
+  }
+  framing_ = framing;
+  return true;
+}
+
+std::size_t Itch5File::count_events() const noexcept {
+  Itch5Cursor c = cursor();
+  const uint8_t* m; std::size_t len; std::size_t n = 0;
+  while (c.next_msg(m, len)) {
+    switch (m[0]) {
+      case 'A': case 'F': case 'E': case 'C': case 'X': case 'D': case 'U': ++n; break;
+      default: break;
+    }
+  }
+  return n;
+}
+
+} // namespace t2t::itch
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "itch.h"
+#include "mapped_file.h"
+
+// NASDAQ TotalView-ITCH 5.0 binary feed: zero-copy decoding over an mmap'd
+// capture. Messages are decoded on the fly from the mapped bytes; nothing is
+// copied into a std::vector<Event>.
+namespace t2t::itch {
+
+namespace itch5 {
+
+enum class Framing : uint8_t {
+  Auto,            // LengthPrefixed if the file starts with a 0x00 byte, else Raw
+  Raw,             // back-to-back messages, length implied by the type byte
+  LengthPrefixed,  // 2-byte big-endian length before each message (BinaryFILE)
+};
+
+// Big-endian field loads straight from the mapped bytes.
+inline uint16_t be16(const uint8_t* p) noexcept { uint16_t v; std::memcpy(&v, p, 2); return __builtin_bswap16(v); }
+inline uint32_t be32(const uint8_t* p) noexcept { uint32_t v; std::memcpy(&v, p, 4); return __builtin_bswap32(v); }
+inline uint64_t be64(const uint8_t* p) noexcept { uint64_t v; std::memcpy(&v, p, 8); return __builtin_bswap64(v); }
+inline uint64_t be48(const uint8_t* p) noexcept {
+  return (static_cast<uint64_t>(be16(p)) << 32) | static_cast<uint64_t>(be32(p + 2));
+}
+
+// Wire length of a message by type byte (framing excluded); 0 if unknown.
+uint16_t msg_len(uint8_t type) noexcept;
+
+// Decode one order-book message (A/F/E/C/X/D/U) into an Event. Returns false
+// for every other message type or if len is too short.
+//   A/F -> Add      (px = price in 1/10000 units, side from 'B'/'S')
+//   E/C -> Exec     (qty = executed shares; px = exec price for C, 0 for E;
+//                    E/C carry no side, so side=false)
+//   X   -> Reduce   (qty = cancelled shares, partial)
+//   D   -> Cancel   (qty = 0, whole order)
+//   U   -> Replace  (order_id = original ref, new_id = new ref, px, qty)
+// ts_ns is the 48-bit nanoseconds-since-midnight stamp, locate the header's
+// stock locate; 64-bit order references are truncated to Event's 32-bit ids.
+bool decode(const uint8_t* msg, std::size_t len, Event& ev) noexcept;
+
+// Decode a Stock Directory ('R') message: locate code and the 8-byte stock
+// symbol with its space padding stripped. False for any other message.
+bool decode_directory(const uint8_t* msg, std::size_t len, uint16_t& locate, char (&symbol)[9]) noexcept;
+
+// Encode an Event as the matching ITCH 5.0 message (inverse of decode():
+// Add->A, Exec->E, Reduce->X, Cancel->D, Replace->U). Returns bytes
+// written into out (>= 36 bytes), 0 if the type has no ITCH form.
+std::size_t encode(const Event& ev, uint8_t* out) noexcept;
+// Append encode(ev) to buf with the given framing (Raw or LengthPrefixed).
+void append(std::vector<uint8_t>& buf, const Event& ev, Framing framing);
+
+} // namespace itch5
+
+// Walks messages in place over [p, p+n).
+class Itch5Cursor {
+public:
+  Itch5Cursor() = default;
+  Itch5Cursor(const uint8_t* p, std::size_t n, itch5::Framing framing) noexcept
+  : p_(p), end_(p + n), framing_(framing) {}
+
+  // Next message (pointing at its type byte) or false at end of data.
+  bool next_msg(const uint8_t*& msg, std::size_t& len) noexcept;
+  // Next order-book event, skipping messages decode() ignores.
+  bool next(Event& ev) noexcept;
+
+  // True if the walk stopped on a truncated or (raw framing) unknown message.
+  bool error() const noexcept { return error_; }
+  std::size_t remaining() const noexcept { return static_cast<std::size_t>(end_ - p_); }
+
+private:
+  const uint8_t* p_{nullptr};
+  const uint8_t* end_{nullptr};
+  itch5::Framing framing_{itch5::Framing::Raw};
+  bool error_{false};
+};
+
+// Read-only mapping of an ITCH 5.0 capture.
+class Itch5File {
+public:
+  // Returns true on success; false fills *err with message.
+  bool open(const std::string& path, itch5::Framing framing, std::string* err);
+  void close() { map_.close(); }
+
+  const uint8_t* data()    const noexcept { return map_.data(); }
+  std::size_t    size()    const noexcept { return map_.size(); }
+  itch5::Framing framing() const noexcept { return framing_; }
+  Itch5Cursor    cursor()  const noexcept { return Itch5Cursor(data(), size(), framing_); }
+
+  // Number of order-book events (one pass over the mapping, no decode).
+  std::size_t count_events() const noexcept;
+
+private:
+  MappedFile     map_;
+  itch5::Framing framing_{itch5::Framing::Raw};
+};
+
+} // namespace t2t::itch
@@ -0,0 +1,43 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace t2t::itch {
+
+MappedFile::~MappedFile() { close(); }
+
+void MappedFile::close() {
+  if (data_ && size_) ::munmap(const_cast<uint8_t*>(data_), size_);
+  data_ = nullptr; size_ = 0;
+}
+
+bool MappedFile::open(const std::string& path, std::string* err, bool populate) {
+  close();
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) { if (err) *err = "cannot open: " + path; return false; }
+  struct stat st{};
+  if (::fstat(fd, &st) != 0) { ::close(fd); if (err) *err = "cannot stat: " + path; return false; }
+  const std::size_t n = static_cast<std::size_t>(st.st_size);
+  if (n > 0) {
+    int flags = MAP_PRIVATE;
+#if defined(MAP_POPULATE)
+    if (populate) flags |= MAP_POPULATE;   // pre-fault in one kernel call instead of per-page faults
+#endif
+    void* p = ::mmap(nullptr, n, PROT_READ, flags, fd, 0);
+    if (p == MAP_FAILED) {
+      ::close(fd);
+      if (err) *err = "cannot mmap: " + path;
+      return false;
+    }
+    if (!populate) ::madvise(p, n, MADV_SEQUENTIAL);
+    data_ = static_cast<const uint8_t*>(p);
+    size_ = n;
+  }
+  ::close(fd);
+  return true;
+}
+
+} // namespace t2t::itch
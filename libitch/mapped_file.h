@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace t2t::itch {
+
+// Read-only mmap of a whole file (POSIX). Empty files map to (nullptr, 0).
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+  MappedFile(const MappedFile&)            = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  // Returns true on success; false fills *err with message. populate
+  // faults the whole file in during open (MAP_POPULATE), for callers that
+  // read all of it up front anyway. Otherwise pages come in on first touch
+  // with sequential read-ahead, so open stays O(1) and a streaming reader
+  // holds only the window it is in.
+  bool open(const std::string& path, std::string* err, bool populate = false);
+  void close();
+
+  const uint8_t* data()  const noexcept { return data_; }
+  const char*    chars() const noexcept { return reinterpret_cast<const char*>(data_); }
+  std::size_t    size()  const noexcept { return size_; }
+
+private:
+  const uint8_t* data_{nullptr};
+  std::size_t    size_{0};
+};
+
+} // namespace t2t::itch
@@ -0,0 +1,85 @@
+#include "symbols.h"
+#include <charconv>
+#include <fstream>
+#include <string_view>
+
+namespace t2t::itch {
+
+void SymbolDirectory::set(const SymbolInfo& s) {
+  if (by_locate_.empty()) by_locate_.assign(MAX_LOCATES, -1);
+  int32_t& slot = by_locate_[s.locate];
+  if (slot >= 0) { entries_[static_cast<std::size_t>(slot)] = s; return; }
+  slot = static_cast<int32_t>(entries_.size());
+  entries_.push_back(s);
+}
+
+// Split one line on ',' (at most 4 fields); trailing '\r' dropped.
+static std::size_t split_fields(const std::string& line, std::string_view (&f)[4]) {
+  std::string_view s(line);
+  if (!s.empty() && s.back() == '\r') s.remove_suffix(1);
+  std::size_t n = 0;
+  while (n < 4) {
+    const std::size_t c = s.find(',');
+    f[n++] = s.substr(0, c);
+    if (c == std::string_view::npos) break;
+    s.remove_prefix(c + 1);
+  }
+  return n;
+}
+
+// Whole field must be a number.
+template <class T>
+static bool parse_num(std::string_view s, T& out) {
+  const char* e = s.data() + s.size();
+  const auto r = std::from_chars(s.data(), e, out);
+  return !s.empty() && r.ec == std::errc() && r.ptr == e;
+}
+
+bool SymbolDirectory::load_csv(const std::string& path, std::string* err) {
+  std::ifstream in(path);
+  if (!in) { if (err) *err = "cannot open: " + path; return false; }
+  std::string line;
+  bool first = true;
+  while (std::getline(in, line)) {
+    const bool header = first && line.rfind("locate,", 0) == 0;
+    first = false;
+    if (header || line.empty() || line == "\r") continue;
+
+    std::string_view f[4];
+    const std::size_t n = split_fields(line, f);
+    SymbolInfo s;
+    uint32_t loc = 0;
+    bool ok = n >= 2 && parse_num(f[0], loc) && loc < MAX_LOCATES && !f[1].empty();
+    if (ok && n >= 3) ok = parse_num(f[2], s.max_orders);
+    if (ok && n >= 4) ok = parse_num(f[3], s.max_levels);
+    if (!ok) { if (err) *err = "symbols: parse error: " + line; return false; }
+    s.locate = static_cast<uint16_t>(loc);
+    if (find(s.locate)) { if (err) *err = "symbols: duplicate locate: " + line; return false; }
+    s.symbol.assign(f[1]);
+    set(s);
+  }
+  return true;
+}
+
+std::size_t SymbolDirectory::load_itch5(const Itch5File& f) {
+  Itch5Cursor c = f.cursor();
+  const uint8_t* m; std::size_t len;
+  std::size_t added = 0;
+  while (c.next_msg(m, len)) {
+    uint16_t loc; char sym[9];
+    if (itch5::decode_directory(m, len, loc, sym)) {
+      if (find(loc)) continue;
+      SymbolInfo s;
+      s.locate = loc;
+      s.symbol = sym;
+      set(s);
+      ++added;
+      continue;
+    }
+    Event ev;
+    if (itch5::decode(m, len, ev)) break;
+  }
+  return added;
+}
+
+} // namespace t2t::itch
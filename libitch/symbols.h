@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "itch5.h"
+
+// Instrument directory: locate code -> symbol and per-instrument book sizing.
+// Loaded once at startup (cold path); lookups by locate are a table index.
+namespace t2t::itch {
+
+struct SymbolInfo {
+  uint16_t    locate{0};
+  std::string symbol;
+  std::size_t max_orders{0};   // live orders per side; 0 = caller's default
+  std::size_t max_levels{0};   // ladder width in ticks; 0 = caller's default
+};
+
+class SymbolDirectory {
+public:
+  static constexpr std::size_t MAX_LOCATES = 1u << 16;
+
+  // CSV rows: locate,symbol[,max_orders[,max_levels]]. An optional header
+  // line starting with "locate," is skipped; blank lines are ignored. A
+  // locate listed twice is an error. Returns true on success; false fills
+  // *err with message.
+  bool load_csv(const std::string& path, std::string* err);
+
+  // Stock Directory ('R') messages of an ITCH 5.0 capture. Locates already
+  // present (e.g. from load_csv) are kept as they are. The walk stops at the
+  // first order-book message: a session's directory precedes its orders.
+  // Returns the number of symbols added.
+  std::size_t load_itch5(const Itch5File& f);
+
+  // Insert or overwrite the entry for s.locate.
+  void set(const SymbolInfo& s);
+
+  const SymbolInfo* find(uint16_t locate) const noexcept {
+    if (by_locate_.empty() || by_locate_[locate] < 0) return nullptr;
+    return &entries_[static_cast<std::size_t>(by_locate_[locate])];
+  }
+  std::size_t size() const noexcept { return entries_.size(); }
+  const std::vector<SymbolInfo>& entries() const noexcept { return entries_; }
+
+private:
+  std::vector<SymbolInfo> entries_;    // load order
+  std::vector<int32_t>    by_locate_;  // MAX_LOCATES slots, -1 = absent (sized on first set)
+};
+
+} // namespace t2t::itch
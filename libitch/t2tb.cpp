@@ -0,0 +1,126 @@
+#include "t2tb.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace t2t::itch {
+namespace t2tb {
+
+static uint64_t header_hash(const Header& h) {
+  return hash_words(&h, offsetof(Header, header_hash));
+}
+
+bool write(const std::string& path, const std::vector<Event>& events, std::string* err,
+           uint32_t index_stride) {
+  if (index_stride == 0) index_stride = kIndexStride;
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    if (events[i].new_id != 0) {
+      if (err) *err = "t2tb: event " + std::to_string(i) + " has a new_id the cache cannot store";
+      return false;
+    }
+  }
+  FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) { if (err) *err = "cannot open: " + path; return false; }
+
+  Header h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version      = kVersion;
+  h.record_size  = sizeof(PackedEvent);
+  h.index_stride = index_stride;
+  h.count        = events.size();
+  h.index_count  = (events.size() + index_stride - 1) / index_stride;
+  h.index_offset = sizeof(Header) + events.size() * sizeof(PackedEvent);
+
+  bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1;   // placeholder, rewritten below
+
+  // Records in fixed-size batches; the index is built on the way.
+  std::vector<PackedEvent> buf;
+  std::vector<uint64_t> index;
+  buf.reserve(4096);
+  index.reserve(h.index_count);
+  uint64_t rh = 0x9E3779B97F4A7C15ull, run_max = 0;
+  for (std::size_t i = 0; ok && i < events.size(); ++i) {
+    buf.push_back(pack(events[i]));
+    run_max = std::max(run_max, events[i].ts_ns);
+    if ((i + 1) % index_stride == 0 || i + 1 == events.size()) index.push_back(run_max);
+    if (buf.size() == 4096 || i + 1 == events.size()) {
+      rh = hash_words(buf.data(), buf.size() * sizeof(PackedEvent), rh);
+      ok = std::fwrite(buf.data(), sizeof(PackedEvent), buf.size(), f) == buf.size();
+      buf.clear();
+    }
+  }
+  if (ok && !index.empty()) ok = std::fwrite(index.data(), sizeof(uint64_t), index.size(), f) == index.size();
+
+  h.records_hash = rh;
+  h.index_hash   = hash_words(index.data(), index.size() * sizeof(uint64_t));
+  h.header_hash  = header_hash(h);
+  ok = ok && std::fseek(f, 0, SEEK_SET) == 0 && std::fwrite(&h, sizeof(h), 1, f) == 1;
+  ok = (std::fclose(f) == 0) && ok;
+  if (!ok && err) *err = "write failed: " + path;
+  return ok;
+}
+
+bool sniff(const std::string& path) {
+  FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) return false;
+  char m[4] = {};
+  const bool ok = std::fread(m, 1, 4, f) == 4 && std::memcmp(m, kMagic, 4) == 0;
+  std::fclose(f);
+  return ok;
+}
+
+} // namespace t2tb
+
+bool T2tbFile::open(const std::string& path, std::string* err) {
+  close();
+  if (!map_.open(path, err)) return false;
+  auto fail = [&](const char* what) {
+    if (err) *err = std::string(what) + ": " + path;
+    close();
+    return false;
+  };
+
+  t2tb::Header h;
+  if (map_.size() < sizeof(h)) return fail("not a t2tb file");
+  std::memcpy(&h, map_.data(), sizeof(h));
+  if (std::memcmp(h.magic, t2tb::kMagic, 4) != 0) return fail("not a t2tb file");
+  if (h.version != t2tb::kVersion || h.record_size != sizeof(t2tb::PackedEvent))
+    return fail("unsupported t2tb version");
+  if (t2tb::header_hash(h) != h.header_hash) return fail("t2tb header checksum mismatch");
+  if (h.index_stride == 0 ||
+      h.index_count != (h.count + h.index_stride - 1) / h.index_stride ||
+      h.index_offset != sizeof(h) + h.count * sizeof(t2tb::PackedEvent) ||
+      map_.size() != h.index_offset + h.index_count * sizeof(uint64_t))
+    return fail("truncated t2tb file");
+
+  const auto* idx = reinterpret_cast<const uint64_t*>(map_.data() + h.index_offset);
+  if (t2tb::hash_words(idx, h.index_count * sizeof(uint64_t)) != h.index_hash)
+    return fail("t2tb index checksum mismatch");
+
+  rec_          = reinterpret_cast<const t2tb::PackedEvent*>(map_.data() + sizeof(h));
+  index_        = idx;
+  count_        = static_cast<std::size_t>(h.count);
+  index_count_  = static_cast<std::size_t>(h.index_count);
+  stride_       = h.index_stride;
+  records_hash_ = h.records_hash;
+  return true;
+}
+
+bool T2tbFile::verify(std::string* err) const {
+  if (t2tb::hash_words(rec_, count_ * sizeof(t2tb::PackedEvent)) == records_hash_) return true;
+  if (err) *err = "t2tb record checksum mismatch";
+  return false;
+}
+
+std::size_t T2tbFile::seek_time(uint64_t ts) const noexcept {
+  // index_[k] is the running max through block k, so the first block whose
+  // entry reaches ts holds the first event with ts_ns >= ts.
+  const std::size_t k = static_cast<std::size_t>(
+      std::lower_bound(index_, index_ + index_count_, ts) - index_);
+  if (k == index_count_) return count_;
+  std::size_t i = k * stride_;
+  const std::size_t e = std::min(count_, i + stride_);
+  while (i < e && rec_[i].ts_ns < ts) ++i;
+  return i;
+}
+
+} // namespace t2t::itch
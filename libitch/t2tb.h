@@ -0,0 +1,114 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "itch.h"
+#include "mapped_file.h"
+
+// .t2tb: packed binary replay cache. A CSV replay is converted once
+// (apps/t2tb_convert) and then mapped read-only: open() checks the header and
+// index only, so startup does not depend on file size, and a run can start
+// at any event offset or timestamp without touching the prefix.
+//
+// Layout (little-endian, native struct layout):
+//   Header                         64 bytes
+//   PackedEvent[count]             24 bytes each
+//   uint64_t index[index_count]    running max ts_ns at the end of each
+//                                  block of index_stride events
+namespace t2t::itch {
+
+namespace t2tb {
+
+constexpr char     kMagic[4]    = {'T', '2', 'T', 'B'};
+constexpr uint32_t kVersion     = 1;
+constexpr uint32_t kIndexStride = 1024;
+
+// One event in 24 bytes (Event is 32 with padding). Lossless for everything
+// the CSV loader produces; new_id is not stored (CSV rows never set it).
+struct PackedEvent {
+  uint64_t ts_ns;
+  uint32_t order_id;
+  int32_t  px;
+  int32_t  qty;
+  uint8_t  type;
+  uint8_t  side;
+  uint16_t locate;
+};
+static_assert(sizeof(PackedEvent) == 24, "t2tb record layout");
+
+struct Header {
+  char     magic[4];
+  uint32_t version;
+  uint32_t record_size;   // sizeof(PackedEvent)
+  uint32_t index_stride;  // events per index entry
+  uint64_t count;         // events
+  uint64_t index_count;   // ceil(count / index_stride)
+  uint64_t index_offset;  // bytes from start of file
+  uint64_t records_hash;  // hash_words over the records
+  uint64_t index_hash;    // hash_words over the index
+  uint64_t header_hash;   // hash_words over the bytes above
+};
+static_assert(sizeof(Header) == 64, "t2tb header layout");
+
+inline PackedEvent pack(const Event& e) noexcept {
+  return PackedEvent{e.ts_ns, e.order_id, e.px, e.qty, static_cast<uint8_t>(e.type),
+                     static_cast<uint8_t>(e.side ? 1 : 0), e.locate};
+}
+
+inline Event unpack(const PackedEvent& r) noexcept {
+  return Event{r.ts_ns, static_cast<EvType>(r.type), r.locate, r.order_id, r.side != 0, r.px, r.qty, 0};
+}
+
+// 64-bit hash over n bytes (n a multiple of 8), one multiply-xor per word.
+inline uint64_t hash_words(const void* p, std::size_t n, uint64_t h = 0x9E3779B97F4A7C15ull) noexcept {
+  const auto* b = static_cast<const uint8_t*>(p);
+  for (std::size_t i = 0; i + 8 <= n; i += 8) {
+    uint64_t w; std::memcpy(&w, b + i, 8);
+    h = (h ^ w) * 0xff51afd7ed558ccdull;
+    h ^= h >> 32;
+  }
+  return h;
+}
+
+// Write events as a .t2tb cache. Fails (with *err) on I/O errors or on an
+// event the packed record cannot represent (non-zero new_id).
+bool write(const std::string& path, const std::vector<Event>& events, std::string* err,
+           uint32_t index_stride = kIndexStride);
+
+// True if the file starts with the .t2tb magic.
+bool sniff(const std::string& path);
+
+} // namespace t2tb
+
+// Read-only mapping of a .t2tb cache.
+class T2tbFile {
+public:
+  // Maps the file and validates header, sizes and index checksum (not the
+  // records; see verify()). Returns true on success; false fills *err.
+  bool open(const std::string& path, std::string* err);
+  void close() { map_.close(); rec_ = nullptr; index_ = nullptr; count_ = index_count_ = 0; }
+
+  // Full pass over the records against the stored checksum.
+  bool verify(std::string* err) const;
+
+  std::size_t size() const noexcept { return count_; }
+  const t2tb::PackedEvent* records() const noexcept { return rec_; }
+  Event at(std::size_t i) const noexcept { return t2tb::unpack(rec_[i]); }
+
+  // Index of the first event with ts_ns >= ts (size() if none). Binary search
+  // over the sparse index, then a scan of at most one block.
+  std::size_t seek_time(uint64_t ts) const noexcept;
+
+private:
+  MappedFile               map_;
+  const t2tb::PackedEvent* rec_{nullptr};
+  const uint64_t*          index_{nullptr};
+  std::size_t              count_{0};
+  std::size_t              index_count_{0};
+  std::size_t              stride_{t2tb::kIndexStride};
+  uint64_t                 records_hash_{0};
+};
+
+} // namespace t2t::itch
@@ -0,0 +1,69 @@
+#pragma once
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace t2t::lob {
+
+// Three-level occupancy bitmap (up to 64^3 = 262144 slots).
+// set/clear touch at most three words; lowest/highest are one tzcnt/lzcnt
+// per level, so best-price lookup never scans.
+class LevelBitmap {
+public:
+  static constexpr std::size_t MAX_BITS = 64u * 64u * 64u;
+
+  explicit LevelBitmap(std::size_t nbits)
+  : l0_((nbits + 63u) / 64u, 0), l1_((l0_.size() + 63u) / 64u, 0) {
+    assert(nbits <= MAX_BITS);
+  }
+
+  inline void reset() noexcept {
+    for (auto& w : l0_) w = 0;
+    for (auto& w : l1_) w = 0;
+    l2_ = 0;
+  }
+
+  inline bool test(std::size_t i) const noexcept { return (l0_[i >> 6] >> (i & 63u)) & 1u; }
+  inline bool empty() const noexcept { return l2_ == 0; }
+
+  inline void set(std::size_t i) noexcept {
+    const std::size_t w = i >> 6, w1 = w >> 6;
+    l0_[w]  |= bit(i);
+    l1_[w1] |= bit(w);
+    l2_     |= bit(w1);
+  }
+
+  inline void clear(std::size_t i) noexcept {
+    const std::size_t w = i >> 6, w1 = w >> 6;
+    if ((l0_[w] &= ~bit(i)) != 0) return;
+    if ((l1_[w1] &= ~bit(w)) != 0) return;
+    l2_ &= ~bit(w1);
+  }
+
+  // Lowest / highest set index, or -1 if empty.
+  inline int lowest() const noexcept {
+    if (!l2_) return -1;
+    const std::size_t j = ctz(l2_);
+    const std::size_t k = (j << 6) + ctz(l1_[j]);
+    return static_cast<int>((k << 6) + ctz(l0_[k]));
+  }
+  inline int highest() const noexcept {
+    if (!l2_) return -1;
+    const std::size_t j = msb(l2_);
+    const std::size_t k = (j << 6) + msb(l1_[j]);
+    return static_cast<int>((k << 6) + msb(l0_[k]));
+  }
+
+private:
+  std::vector<uint64_t> l0_;
+  std::vector<uint64_t> l1_;
+  uint64_t l2_{0};
+
+  static constexpr uint64_t bit(std::size_t i) noexcept { return uint64_t{1} << (i & 63u); }
+  static inline std::size_t ctz(uint64_t w) noexcept { return static_cast<std::size_t>(std::countr_zero(w)); }
+  static inline std::size_t msb(uint64_t w) noexcept { return 63u - static_cast<std::size_t>(std::countl_zero(w)); }
+};
+
+} // namespace t2t::lob
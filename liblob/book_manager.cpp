@@ -0,0 +1,27 @@
+#include "book_manager.h"
+
+namespace t2t::lob {
+
+BookManager::BookManager(BookSpec default_spec)
+: default_spec_(default_spec), slot_(MAX_LOCATES, NONE) {}
+
+void BookManager::set_spec(uint16_t locate, BookSpec spec) {
+  if (specs_.empty()) specs_.assign(MAX_LOCATES, default_spec_);
+  specs_[locate] = spec;
+}
+
+// Out of line: the hot path only ever takes the [[likely]] branch of book().
+[[gnu::noinline]] Lob& BookManager::create(uint16_t locate) {
+  const BookSpec& sp = specs_.empty() ? default_spec_ : specs_[locate];
+  books_.emplace_back(sp.max_orders, sp.max_levels, sp.id_window);
+  if (sp.prefault) books_.back().prefault();
+  locates_.push_back(locate);
+  slot_[locate] = static_cast<uint32_t>(books_.size() - 1);
+  return books_.back();
+}
+
+void BookManager::reset() {
+  for (auto& b : books_) b.reset();
+}
+
+} // namespace t2t::lob
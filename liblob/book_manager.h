@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "liblob/lob.h"
+
+namespace t2t::lob {
+
+// Pool sizes for one instrument's book.
+struct BookSpec {
+  std::size_t max_orders{Lob::DEFAULT_MAX_ORDERS};
+  std::size_t max_levels{Lob::DEFAULT_MAX_LEVELS};
+  bool        prefault{false};   // touch the pools at creation (busy names)
+  std::size_t id_window{0};      // direct id table span (Lob), 0 = hash maps only
+};
+
+// Owns one Lob per instrument, keyed by the 16-bit ITCH locate code. Books
+// live in one flat vector; a locate-indexed slot table maps event -> book
+// with two loads and no hashing. Books are created on first use, sized by
+// the spec registered for their locate (or the default), so memory follows
+// the instruments that actually trade.
+class BookManager {
+public:
+  static constexpr std::size_t MAX_LOCATES = 1u << 16;
+  static constexpr uint32_t    NONE = UINT32_MAX;
+
+  explicit BookManager(BookSpec default_spec = {});
+
+  // Sizing for a locate's book; only affects books not yet created.
+  void set_spec(uint16_t locate, BookSpec spec);
+  // Pre-size the book vector so creating up to n books never reallocates.
+  void reserve(std::size_t n) { books_.reserve(n); }
+
+  // Existing book or nullptr (never allocates).
+  Lob* find(uint16_t locate) noexcept {
+    const uint32_t s = slot_[locate];
+    return s != NONE ? &books_[s] : nullptr;
+  }
+  const Lob* find(uint16_t locate) const noexcept {
+    const uint32_t s = slot_[locate];
+    return s != NONE ? &books_[s] : nullptr;
+  }
+  // Book for locate, created on first use (allocates its pools then).
+  // References stay valid until the next creation beyond reserve().
+  Lob& book(uint16_t locate) {
+    const uint32_t s = slot_[locate];
+    if (s != NONE) [[likely]] return books_[s];
+    return create(locate);
+  }
+
+  void reset();   // reset every created book (pools kept)
+
+  std::size_t size() const noexcept { return books_.size(); }
+  // i-th created book and its locate, in creation order.
+  Lob&       at(std::size_t i) noexcept { return books_[i]; }
+  const Lob& at(std::size_t i) const noexcept { return books_[i]; }
+  uint16_t   locate_at(std::size_t i) const noexcept { return locates_[i]; }
+  // Creation index of locate's book (for parallel per-instrument state), or NONE.
+  uint32_t   index_of(uint16_t locate) const noexcept { return slot_[locate]; }
+
+private:
+  Lob& create(uint16_t locate);
+
+  BookSpec              default_spec_;
+  std::vector<BookSpec> specs_;     // MAX_LOCATES entries once any set_spec() (else default)
+  std::vector<uint32_t> slot_;      // locate -> index into books_, NONE if absent
+  std::vector<Lob>      books_;
+  std::vector<uint16_t> locates_;   // books_[i] belongs to locates_[i]
+};
+
+} // namespace t2t::lob
@@ -0,0 +1,149 @@
+#pragma once
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace t2t::lob {
+
+// Open-addressing hash map for integer keys: Robin Hood probing with
+// backward-shift deletion (no tombstones). The home slot is fmix64(k >> 4)
+// with the low 4 bits of k kept: a run of dense exchange ids shares one
+// 16-slot group (cache/TLB friendly) while the groups spread over the table.
+// Capacity is fixed at construction: max_items / max_load rounded up to a
+// power of two; put() refuses to go past max_items instead of degrading.
+// The table is calloc'd (all-zero == empty), so a large map costs no page
+// touches until it is used; prefault() touches it up front.
+template <typename K, typename V>
+class FlatMap {
+  struct Slot { K key; V val; uint32_t dist; }; // dist = probe length + 1, 0 = empty
+  static_assert(std::is_trivially_copyable_v<Slot>, "zero-filled slots must be valid empties");
+  struct Free { void operator()(Slot* p) const noexcept { std::free(p); } };
+
+public:
+  struct ProbeStats {
+    std::size_t size{0}, capacity{0}, max_probe{0};
+    double      mean_probe{0.0};
+    std::vector<uint64_t> hist;   // hist[d] = entries at probe distance d
+  };
+
+  explicit FlatMap(std::size_t max_items, double max_load = 0.5)
+  : max_items_(max_items) {
+    assert(max_load > 0.0 && max_load < 1.0);
+    const std::size_t want = static_cast<std::size_t>(std::ceil(static_cast<double>(max_items) / max_load));
+    std::size_t cap = 16;
+    while (cap < want) cap <<= 1;
+    tab_.reset(static_cast<Slot*>(std::calloc(cap, sizeof(Slot))));
+    assert(tab_ && "FlatMap: out of memory");
+    cap_  = cap;
+    mask_ = cap - 1u;
+  }
+
+  // O(capacity); erase the live keys instead when there are few of them.
+  inline void clear() { std::memset(static_cast<void*>(tab_.get()), 0, cap_ * sizeof(Slot)); size_ = 0; }
+  // Touch every page now (off the hot path) rather than on first use.
+  inline void prefault() { if (size_ == 0) clear(); }
+
+  inline std::size_t size()      const noexcept { return size_; }
+  inline std::size_t capacity()  const noexcept { return cap_; }
+  inline std::size_t max_items() const noexcept { return max_items_; }
+
+  static inline uint64_t mix(uint64_t h) noexcept {
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+  }
+  static constexpr unsigned GROUP_BITS = 4;
+  inline std::size_t home(const K& k) const noexcept {
+    const uint64_t u = static_cast<uint64_t>(k);
+    const uint64_t g = mix(u >> GROUP_BITS) << GROUP_BITS;
+    return static_cast<std::size_t>(g | (u & ((1u << GROUP_BITS) - 1u))) & mask_;
+  }
+
+  inline bool find(const K& k, V& out) const noexcept {
+    std::size_t i = home(k);
+    for (uint32_t d = 1;; ++d, i = (i + 1u) & mask_) {
+      const Slot& s = tab_[i];
+      if (s.dist < d) return false;   // empty, or a richer entry: k is absent
+      if (s.key == k) { out = s.val; return true; }
+    }
+  }
+  inline V get(const K& k, V missing) const noexcept {
+    V v; return find(k, v) ? v : missing;
+  }
+  // Pull k's home slot toward L1 ahead of a find/put/erase.
+  inline void prefetch(const K& k) const noexcept { __builtin_prefetch(&tab_[home(k)]); }
+
+  // Insert or overwrite. Returns false (and leaves the map unchanged) if k is
+  // new and the map already holds max_items entries.
+  inline bool put(const K& k, const V& v) noexcept {
+    std::size_t i = home(k);
+    uint32_t d = 1;
+    for (;; ++d, i = (i + 1u) & mask_) {
+      Slot& s = tab_[i];
+      if (s.dist < d) break;
+      if (s.key == k) { s.val = v; return true; }
+    }
+    if (size_ >= max_items_) return false;
+    Slot cur{k, v, d};
+    for (;; i = (i + 1u) & mask_) {
+      Slot& s = tab_[i];
+      if (s.dist == 0) { s = cur; break; }
+      if (s.dist < cur.dist) { Slot t = s; s = cur; cur = t; } // take from the rich
+      ++cur.dist;
+    }
+    ++size_;
+    return true;
+  }
+
+  inline bool erase(const K& k) noexcept {
+    std::size_t i = home(k);
+    for (uint32_t d = 1;; ++d, i = (i + 1u) & mask_) {
+      const Slot& s = tab_[i];
+      if (s.dist < d) return false;
+      if (s.key == k) break;
+    }
+    // backward shift: pull displaced successors one slot closer to home
+    for (;;) {
+      const std::size_t j = (i + 1u) & mask_;
+      Slot& nx = tab_[j];
+      if (nx.dist <= 1) { tab_[i].dist = 0; break; }
+      tab_[i] = nx; --tab_[i].dist;
+      i = j;
+    }
+    --size_;
+    return true;
+  }
+
+  ProbeStats probe_stats() const {
+    ProbeStats st;
+    st.size = size_; st.capacity = cap_;
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < cap_; ++i) {
+      const Slot& s = tab_[i];
+      if (s.dist == 0) continue;
+      const std::size_t d = s.dist - 1u;
+      if (d >= st.hist.size()) st.hist.resize(d + 1u, 0);
+      ++st.hist[d];
+      sum += d;
+      if (d > st.max_probe) st.max_probe = d;
+    }
+    st.mean_probe = size_ ? static_cast<double>(sum) / static_cast<double>(size_) : 0.0;
+    return st;
+  }
+
+private:
+  std::unique_ptr<Slot[], Free> tab_;
+  std::size_t cap_{0};
+  std::size_t mask_{0};
+  std::size_t size_{0};
+  std::size_t max_items_{0};
+};
+
+} // namespace t2t::lob
@@ -0,0 +1,133 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace t2t::lob {
+
+// Direct-indexed map for dense, roughly increasing 32-bit ids (exchange
+// order reference numbers): a lookup is one shift, one generation compare
+// and one load, with no hashing or probing.
+//
+// Ids are grouped in chunks of 2^CHUNK_BITS. The table holds a window of
+// `chunks` chunk slots; chunk c lives in slot c % chunks and the slot records
+// c + 1 as its generation, so an entry left over from a chunk that used the
+// slot before can never answer for another id. The window starts at a
+// sliding base chunk: when a new id lands past the end, the base advances
+// over chunks with no live ids and their slots are recycled, so the window
+// follows the live id range chunk by chunk and never rehashes. put() refuses
+// an id that still does not fit (a long-lived order pins the base); callers
+// keep such ids in a fallback hash map. Storage is calloc'd (zero == empty)
+// and sized once, so pages are only touched as the window reaches them.
+class IdTable {
+  struct Free { void operator()(uint32_t* p) const noexcept { std::free(p); } };
+  struct Chunk { uint32_t gen; uint32_t live; };   // gen = chunk number + 1, 0 = unused
+
+public:
+  static constexpr unsigned CHUNK_BITS = 12;       // 4096 ids per chunk
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  // window_ids is rounded up to a power-of-two number of chunks; 0 disables
+  // the table (every put() fails).
+  explicit IdTable(std::size_t window_ids = 0) {
+    if (window_ids == 0) return;
+    std::size_t n = 1;
+    while ((n << CHUNK_BITS) < window_ids) n <<= 1;
+    assert(n <= (std::size_t{1} << (32 - CHUNK_BITS)));
+    ent_.reset(static_cast<uint32_t*>(std::calloc(n << CHUNK_BITS, sizeof(uint32_t))));
+    assert(ent_ && "IdTable: out of memory");
+    chunk_.assign(n, Chunk{0, 0});
+    cmask_ = static_cast<uint32_t>(n - 1u);
+  }
+
+  inline bool        enabled()   const noexcept { return !chunk_.empty(); }
+  inline std::size_t size()      const noexcept { return size_; }
+  inline std::size_t window()    const noexcept { return chunk_.size() << CHUNK_BITS; }
+  inline uint32_t    base_id()   const noexcept { return base_ << CHUNK_BITS; }
+
+  // Touch every page now (off the hot path) rather than on first use.
+  inline void prefault() {
+    if (enabled() && size_ == 0) std::memset(static_cast<void*>(ent_.get()), 0, window() * sizeof(uint32_t));
+  }
+
+  // Enabled tables only. NONE if id is absent.
+  inline uint32_t get(uint32_t id) const noexcept {
+    const uint32_t c = id >> CHUNK_BITS;
+    if (chunk_[c & cmask_].gen != c + 1u) return NONE;
+    return ent_[slot(id)] - 1u;                    // empty (0) wraps to NONE
+  }
+
+  // Pull the chunk header and entry for id toward L1 (enabled tables only).
+  inline void prefetch(uint32_t id) const noexcept {
+    __builtin_prefetch(&chunk_[(id >> CHUNK_BITS) & cmask_]);
+    __builtin_prefetch(&ent_[slot(id)]);
+  }
+
+  // Insert or overwrite; v must not be NONE. false if the table is disabled
+  // or id is outside any window the live ids allow.
+  inline bool put(uint32_t id, uint32_t v) noexcept {
+    assert(v != NONE);
+    if (!enabled()) return false;
+    const uint32_t c = id >> CHUNK_BITS;
+    Chunk& ch = chunk_[c & cmask_];
+    if (ch.gen != c + 1u && !open(c)) return false;
+    uint32_t& e = ent_[slot(id)];
+    if (e == 0) { ++ch.live; ++size_; }
+    e = v + 1u;
+    return true;
+  }
+
+  // false if id is absent.
+  inline bool erase(uint32_t id) noexcept {
+    if (!enabled()) return false;
+    const uint32_t c = id >> CHUNK_BITS;
+    Chunk& ch = chunk_[c & cmask_];
+    if (ch.gen != c + 1u) return false;
+    uint32_t& e = ent_[slot(id)];
+    if (e == 0) return false;
+    e = 0; --ch.live; --size_;
+    return true;
+  }
+
+private:
+  inline std::size_t slot(uint32_t id) const noexcept {
+    return (static_cast<std::size_t>((id >> CHUNK_BITS) & cmask_) << CHUNK_BITS) |
+           (id & ((1u << CHUNK_BITS) - 1u));
+  }
+
+  // Cold path: chunk c has no slot yet. Grow the window [base_, top_] to
+  // cover c, sliding the base past empty chunks if it would get too wide.
+  // Slots outside the window always have gen 0.
+  [[gnu::noinline]] bool open(uint32_t c) noexcept {
+    const uint32_t n = cmask_ + 1u;
+    if (!has_window_) {
+      base_ = top_ = c;
+      has_window_ = true;
+    } else if (std::max(top_, c) - std::min(base_, c) >= n) {
+      while (base_ <= top_ && chunk_[base_ & cmask_].live == 0) {
+        chunk_[base_ & cmask_].gen = 0;
+        ++base_;
+      }
+      if (base_ > top_) base_ = top_ = c;            // every chunk drained
+      else if (std::max(top_, c) - std::min(base_, c) >= n) return false;
+    }
+    base_ = std::min(base_, c);
+    top_  = std::max(top_, c);
+    chunk_[c & cmask_].gen = c + 1u;
+    return true;
+  }
+
+  std::unique_ptr<uint32_t[], Free> ent_;   // value + 1 per id, 0 = empty
+  std::vector<Chunk> chunk_;
+  uint32_t    cmask_{0};
+  uint32_t    base_{0}, top_{0};            // window, in chunk numbers
+  bool        has_window_{false};
+  std::size_t size_{0};
+};
+
+} // namespace t2t::lob
@@ -6,60 +6,135 @@
 namespace t2t::lob {
 
 // -------- Side impl --------
-Lob::Side::Side(bool buy)
-: pool(static_cast<size_t>(MAX_ORDERS)),
-  levels(static_cast<size_t>(MAX_LEVELS)),
-  px2lvl(16384u, INT32_MIN),
-  id2ord(1u << 20, 0u),
+Lob::Side::Side(bool buy, std::size_t max_orders, std::size_t max_levels)
+: levels(max_levels),
+  occ(max_levels),
+  id2ord(max_orders, ID_MAP_LOAD),
   best_level(-1),
   is_buy(buy),
-  free_head(-1) {
-  reset();
+  free_head(NIL),
+  max_live(static_cast<uint32_t>(max_orders)) {
+  assert(max_levels >= 1 && max_levels <= LevelBitmap::MAX_BITS);
+  assert(max_orders < NIL);
+  link.reserve(max_orders);
+  ids.reserve(max_orders);
+  ts.reserve(max_orders);
 }
 
+// Lob::reset has already emptied the levels and unmapped their ids. Pool
+// slots above the high-water mark were never touched; the ones below are
+// re-initialised by alloc_node().
 void Lob::Side::reset() {
-  // pool free list
-  free_head = 0;
-  for (size_t i = 0; i < static_cast<size_t>(MAX_ORDERS); ++i) {
-    pool[i] = OrderNode{};
-    pool[i].next   = (i + 1u < static_cast<size_t>(MAX_ORDERS)) ? static_cast<int>(i + 1u) : -1;
-    pool[i].prev   = -1;
-    pool[i].level  = -1;
-    pool[i].active = false;
-  }
-  // levels
-  for (size_t i = 0; i < static_cast<size_t>(MAX_LEVELS); ++i) {
-    levels[i] = PriceLevel{};
-  }
-  px2lvl.clear(); id2ord.clear(); best_level = -1;
+  assert(occ.empty() && id2ord.size() == 0);
+  link.clear(); ids.clear(); ts.clear();
+  free_head = NIL; base_px = 0; best_level = -1; live = 0;
 }
 
-int Lob::Side::alloc_node() {
-  const int idx = free_head;
-  assert(idx >= 0 && "order pool exhausted");
-  const size_t sidx = static_cast<size_t>(idx);
-  free_head = pool[sidx].next;
-  pool[sidx].next = -1;
-  pool[sidx].prev = -1;
-  pool[sidx].active = true;
+void Lob::Side::prefault() {
+  if (!link.empty()) return;
+  // resize writes every slot; capacity is unchanged
+  link.resize(link.capacity()); link.clear();
+  ids.resize(ids.capacity());   ids.clear();
+  ts.resize(ts.capacity());     ts.clear();
+  id2ord.prefault();
+}
+
+uint32_t Lob::Side::alloc_node() {
+  const uint32_t idx = free_head;
+  if (idx == NIL) {
+    assert(link.size() < link.capacity() && "order pool exhausted");
+    link.emplace_back();          // within the reservations: never reallocates
+    ids.emplace_back();
+    ts.emplace_back();
+    return static_cast<uint32_t>(link.size() - 1);
+  }
+  free_head = link[idx].next;
   return idx;
 }
 
-void Lob::Side::free_node(int idx) {
-  if (idx < 0) return;
-  const size_t sidx = static_cast<size_t>(idx);
-  auto& n = pool[sidx];
-  n.active = false;
-  n.level  = -1;
-  n.qty    = 0;
-  n.prev   = -1;
-  n.next   = free_head;
+void Lob::Side::free_node(uint32_t idx) {
+  auto& n = link[idx];
+  n.qty  = 0;
+  n.prev = NIL;
+  n.next = free_head;
   free_head = idx;
 }
 
 // -------- Lob impl --------
-Lob::Lob() : bid_(true), ask_(false) {}
-void Lob::reset() { bid_.reset(); ask_.reset(); }
+Lob::Lob(std::size_t max_orders, std::size_t max_levels, std::size_t id_window)
+: bid_(true, max_orders, max_levels), ask_(false, max_orders, max_levels), ids_(id_window) {
+  assert(max_orders < ASK_REF);
+}
+
+// Only live state is visited: each occupied level's FIFO (unmapping its
+// ids) and the level itself.
+void Lob::reset() {
+  for (Side* s : {&bid_, &ask_}) {
+    for (int lvl = s->occ.lowest(); lvl >= 0; lvl = s->occ.lowest()) {
+      auto& L = s->levels[static_cast<size_t>(lvl)];
+      for (uint32_t i = L.head; i != NIL; i = s->link[i].next) unmap_id(*s, s->ids[i]);
+      L = PriceLevel{};
+      s->occ.clear(static_cast<size_t>(lvl));
+    }
+    s->reset();
+  }
+}
+void Lob::prefault() { bid_.prefault(); ask_.prefault(); ids_.prefault(); }
+
+// With the direct table on, a hit resolves side and slot in one load; the
+// hash maps are only consulted when some id spilled out of its window.
+uint32_t Lob::lookup(uint32_t id, bool& ask) const noexcept {
+  if (ids_.enabled()) {
+    const uint32_t r = ids_.get(id);
+    if (r != IdTable::NONE) { ask = (r & ASK_REF) != 0; return r & ~ASK_REF; }
+    if (bid_.id2ord.size() == 0 && ask_.id2ord.size() == 0) return NIL;
+  }
+  ask = false;
+  uint32_t idx = bid_.id2ord.get(id, NIL);
+  if (idx == NIL) { ask = true; idx = ask_.id2ord.get(id, NIL); }
+  return idx;
+}
+
+void Lob::prefetch_id(uint32_t id) const noexcept {
+  if (ids_.enabled()) {
+    ids_.prefetch(id);
+    if (bid_.id2ord.size() == 0 && ask_.id2ord.size() == 0) return;
+  }
+  bid_.id2ord.prefetch(id);
+  ask_.id2ord.prefetch(id);
+}
+
+void Lob::prefetch_order(uint32_t id) const noexcept {
+  bool ask = false;
+  const uint32_t idx = lookup(id, ask);
+  if (idx != NIL) __builtin_prefetch(&(ask ? ask_ : bid_).link[idx]);
+}
+
+void Lob::prefetch_links(uint32_t id) const noexcept {
+  bool ask = false;
+  const uint32_t idx = lookup(id, ask);
+  if (idx == NIL) return;
+  const Side& s = ask ? ask_ : bid_;
+  const OrderLink& n = s.link[idx];
+  if (n.prev != NIL) __builtin_prefetch(&s.link[n.prev]);
+  if (n.next != NIL) __builtin_prefetch(&s.link[n.next]);
+  const int64_t off = static_cast<int64_t>(n.px) - s.base_px;
+  __builtin_prefetch(&s.levels[static_cast<size_t>(off)]);
+}
+
+void Lob::prefetch_level(int32_t px, bool is_buy) const noexcept {
+  const Side& s = is_buy ? bid_ : ask_;
+  const int64_t off = static_cast<int64_t>(px) - s.base_px;
+  if (off >= 0 && off < s.width()) __builtin_prefetch(&s.levels[static_cast<size_t>(off)]);
+}
+
+void Lob::map_id(Side& s, uint32_t id, uint32_t idx) noexcept {
+  if (!ids_.put(id, s.is_buy ? idx : (idx | ASK_REF))) s.id2ord.put(id, idx);
+}
+
+void Lob::unmap_id(Side& s, uint32_t id) noexcept {
+  if (!ids_.erase(id)) s.id2ord.erase(id);
+}
 
 int Lob::best_bid() const {
   if (bid_.best_level < 0) return INT32_MIN;
@@ -71,111 +146,237 @@ int Lob::best_ask() const {
 }
 
 int Lob::ensure_level(Side& s, int32_t px) {
-  int lvl = s.px2lvl.get(px);
-  if (lvl >= 0) return lvl;
+  int64_t off = static_cast<int64_t>(px) - s.base_px;
+  if (off < 0 || off >= s.width()) {
+    if (!recenter(s, px)) return -1;
+    off = static_cast<int64_t>(px) - s.base_px;
+  }
+  const int lvl = static_cast<int>(off);
+  auto& L = s.levels[static_cast<size_t>(lvl)];
+  if (L.active) return lvl;
 
-  // find a free level slot
-  for (size_t i = 0; i < static_cast<size_t>(MAX_LEVELS); ++i) {
-    auto& L = s.levels[i];
-    if (!L.active) {
-      L = PriceLevel{};
-      L.active = true; L.px = px; L.head = -1; L.tail = -1; L.total_qty = 0;
-      s.px2lvl.put(px, static_cast<int>(i));
-      if (s.best_level < 0) {
-        s.best_level = static_cast<int>(i);
-      } else {
-        const int bp = s.levels[static_cast<size_t>(s.best_level)].px;
-        if (s.is_buy ? (px > bp) : (px < bp)) s.best_level = static_cast<int>(i);
-      }
-      return static_cast<int>(i);
-    }
+  L = PriceLevel{};
+  L.active = true; L.px = px;
+  s.occ.set(static_cast<size_t>(lvl));
+  if (s.best_level < 0 || (s.is_buy ? (lvl > s.best_level) : (lvl < s.best_level))) {
+    s.best_level = lvl;
+  }
+  return lvl;
+}
+
+// Move the ladder window so px (and every live level) fits, centred on the
+// occupied span. O(max_levels) but only on a drift of the whole book.
+bool Lob::recenter(Side& s, int32_t px) {
+  const int lo_i = s.occ.lowest();
+  if (lo_i < 0) {
+    s.base_px = static_cast<int64_t>(px) - s.width() / 2;
+    return true;
   }
-  assert(false && "no free price level");
-  return -1;
+  const int hi_i = s.occ.highest();
+  const int64_t lo = std::min<int64_t>(s.base_px + lo_i, px);
+  const int64_t hi = std::max<int64_t>(s.base_px + hi_i, px);
+  if (hi - lo >= s.width()) return false;   // caller counts the reject
+  const int64_t new_base = lo - (s.width() - 1 - (hi - lo)) / 2;
+  const int64_t shift = s.base_px - new_base; // old slot i moves to i + shift
+
+  auto move_one = [&](int i) {
+    const size_t from = static_cast<size_t>(i);
+    const size_t to   = static_cast<size_t>(i + shift);
+    s.levels[to] = s.levels[from];
+    s.levels[from] = PriceLevel{};
+  };
+  // Walk in the direction that never overwrites a not-yet-moved level.
+  if (shift > 0) { for (int i = hi_i; i >= lo_i; --i) if (s.levels[static_cast<size_t>(i)].active) move_one(i); }
+  else           { for (int i = lo_i; i <= hi_i; ++i) if (s.levels[static_cast<size_t>(i)].active) move_one(i); }
+
+  s.occ.reset();
+  for (int64_t i = lo_i + shift; i <= hi_i + shift; ++i) {
+    if (s.levels[static_cast<size_t>(i)].active) s.occ.set(static_cast<size_t>(i));
+  }
+  s.base_px = new_base;
+  if (s.best_level >= 0) s.best_level = static_cast<int>(s.best_level + shift);
+  return true;
 }
 
-void Lob::enqueue(Side& s, const Order& o) {
+bool Lob::enqueue(Side& s, const Order& o) {
+  // The configured limit, which the id map is sized for; the pools'
+  // capacity() may round up.
+  if (s.live >= s.max_live) { ++rejects_.capacity; return false; }
   const int lvl = ensure_level(s, o.px);
-  const size_t slvl = static_cast<size_t>(lvl);
-  const int idx = s.alloc_node();
-  const size_t sidx = static_cast<size_t>(idx);
+  if (lvl < 0) { ++rejects_.price; return false; }
+  const uint32_t idx = s.alloc_node();
 
-  auto& n = s.pool[sidx];
-  n.id=o.id; n.px=o.px; n.qty=o.qty; n.ts=o.ts; n.is_buy=o.is_buy; n.level=lvl;
+  map_id(s, o.id, idx);
+  ++s.live;
+  s.ids[idx] = o.id;
+  s.ts[idx]  = o.ts;
 
-  auto& L = s.levels[slvl];
+  auto& n = s.link[idx];
+  n.px = o.px; n.qty = o.qty;
+  link_tail(s, lvl, idx);
+  return true;
+}
+
+void Lob::link_tail(Side& s, int lvl, uint32_t idx) {
+  auto& L = s.levels[static_cast<size_t>(lvl)];
+  auto& n = s.link[idx];
   n.prev = L.tail;
-  n.next = -1;
-  if (L.tail >= 0) {
-    s.pool[static_cast<size_t>(L.tail)].next = idx;
+  n.next = NIL;
+  if (L.tail != NIL) {
+    s.link[L.tail].next = idx;
   } else {
     L.head = idx;
   }
-  L.tail = idx; L.total_qty += o.qty;
-
-  s.id2ord.put(o.id, idx);
+  L.tail = idx; L.total_qty += n.qty;
+}
 
-  // update best
-  if (s.best_level < 0) {
-    s.best_level = lvl;
-  } else {
-    const int bp = s.levels[static_cast<size_t>(s.best_level)].px;
-    if (s.is_buy ? (o.px > bp) : (o.px < bp)) s.best_level = lvl;
-  }
+// id is the order's own id (callers already hold it), so a cancel never
+// reads the cold arrays.
+void Lob::remove_idx(Side& s, uint32_t idx, uint32_t id) {
+  unlink(s, idx);
+  unmap_id(s, id);
+  --s.live;
+  s.free_node(idx);
 }
 
-void Lob::remove_idx(Side& s, int idx) {
-  if (idx < 0) return;
-  const size_t sidx = static_cast<size_t>(idx);
-  auto& n = s.pool[sidx]; if (!n.active) return;
+// idx still holds its old px and neighbour links, and those neighbours are
+// still adjacent (nothing ran in between), so it slots back in place; a
+// level emptied by the unlink is re-created, which cannot fail as the
+// window has not moved.
+void Lob::relink(Side& s, uint32_t idx) {
+  auto& n = s.link[idx];
+  const int lvl = ensure_level(s, n.px);
+  auto& L = s.levels[static_cast<size_t>(lvl)];
+  if (n.prev != NIL) s.link[n.prev].next = idx; else L.head = idx;
+  if (n.next != NIL) s.link[n.next].prev = idx; else L.tail = idx;
+  L.total_qty += n.qty;
+}
 
-  const int lvl_idx = n.level;
+void Lob::unlink(Side& s, uint32_t idx) {
+  const auto& n = s.link[idx];
+  const int lvl_idx = static_cast<int>(static_cast<int64_t>(n.px) - s.base_px);
   auto& L = s.levels[static_cast<size_t>(lvl_idx)];
 
-  if (n.prev >= 0) s.pool[static_cast<size_t>(n.prev)].next = n.next; else L.head = n.next;
-  if (n.next >= 0) s.pool[static_cast<size_t>(n.next)].prev = n.prev; else L.tail = n.prev;
+  if (n.prev != NIL) s.link[n.prev].next = n.next; else L.head = n.next;
+  if (n.next != NIL) s.link[n.next].prev = n.prev; else L.tail = n.prev;
 
   L.total_qty -= n.qty;
-  s.id2ord.erase(n.id);
-  s.free_node(idx);
-
   if (L.total_qty <= 0) {
-    // deactivate level
-    s.px2lvl.erase(L.px);
+    // deactivate level; next best is one bitmap query
     L = PriceLevel{};
+    s.occ.clear(static_cast<size_t>(lvl_idx));
     if (s.best_level == lvl_idx) {
-      // recompute best
-      s.best_level = -1;
-      for (size_t i = 0; i < static_cast<size_t>(MAX_LEVELS); ++i) {
-        if (!s.levels[i].active) continue;
-        if (s.best_level < 0) {
-          s.best_level = static_cast<int>(i);
-        } else {
-          const int cur = s.levels[static_cast<size_t>(s.best_level)].px;
-          if (s.is_buy ? (s.levels[i].px > cur) : (s.levels[i].px < cur)) {
-            s.best_level = static_cast<int>(i);
-          }
-        }
-      }
+      s.best_level = s.is_buy ? s.occ.highest() : s.occ.lowest();
     }
   }
 }
 
-void Lob::add(const Order& o) {
+bool Lob::add(const Order& o) {
   Side& s = o.is_buy ? bid_ : ask_;
-  enqueue(s, o);
+  return enqueue(s, o);
+}
+
+Sweep Lob::add_and_match(const Order& o, std::span<Exec> fills) {
+  Side& opp = o.is_buy ? ask_ : bid_;
+  Sweep r;
+  int32_t left = o.qty;
+  while (left > 0 && opp.best_level >= 0) {
+    auto& L = opp.levels[static_cast<size_t>(opp.best_level)];
+    if (o.is_buy ? L.px > o.px : L.px < o.px) break;   // no longer marketable
+    if (r.fills == fills.size()) {
+      r.filled = o.qty - left;
+      return r;
+    }
+    const uint32_t idx = L.head;
+    auto& n = opp.link[idx];
+    const int32_t q = n.qty < left ? n.qty : left;
+    const uint32_t id = opp.ids[idx];
+    fills[r.fills++] = Exec{o.ts, id, L.px, q};
+    left -= q;
+    if (q == n.qty) {
+      remove_idx(opp, idx, id);       // moves best_level on when L empties
+    } else {
+      n.qty -= q;
+      L.total_qty -= q;
+    }
+  }
+  r.filled = o.qty - left;
+  if (left > 0) {
+    Side& s = o.is_buy ? bid_ : ask_;
+    if (enqueue(s, Order{o.ts, o.id, o.px, left, o.is_buy})) r.rested = left;
+  }
+  return r;
 }
 
 void Lob::cancel(uint32_t id) {
-  int idx = bid_.id2ord.get(id);
-  if (idx >= 0) { remove_idx(bid_, idx); return; }
-  idx = ask_.id2ord.get(id);
-  if (idx >= 0) { remove_idx(ask_, idx); return; }
+  bool ask = false;
+  const uint32_t idx = lookup(id, ask);
+  if (idx != NIL) remove_idx(ask ? ask_ : bid_, idx, id);
   // idempotent if not found
 }
 
+int32_t Lob::shrink(uint32_t id, int32_t qty, Fill* f) {
+  bool ask = false;
+  const uint32_t idx = lookup(id, ask);
+  if (idx == NIL) return 0;
+  Side& s = ask ? ask_ : bid_;
+  auto& n = s.link[idx];
+  if (qty <= 0 || qty >= n.qty) {
+    const int32_t all = n.qty;
+    if (f) *f = Fill{n.px, all, s.is_buy};
+    remove_idx(s, idx, id);
+    return all;
+  }
+  if (f) *f = Fill{n.px, qty, s.is_buy};
+  n.qty -= qty;
+  s.levels[static_cast<size_t>(static_cast<int64_t>(n.px) - s.base_px)].total_qty -= qty;
+  return qty;
+}
+
+bool Lob::replace(uint32_t old_id, uint32_t new_id, int32_t px, int32_t qty) {
+  bool ask = false;
+  const uint32_t idx = lookup(old_id, ask);
+  if (idx == NIL) return false;
+  Side& s = ask ? ask_ : bid_;
+  auto& n = s.link[idx];
+  if (qty <= 0) { remove_idx(s, idx, old_id); return true; }
+
+  if (px == n.px) {
+    unmap_id(s, old_id);
+    // Same level: new size, move to the back of its FIFO.
+    auto& L = s.levels[static_cast<size_t>(static_cast<int64_t>(px) - s.base_px)];
+    L.total_qty += qty - n.qty;
+    n.qty = qty;
+    if (L.tail != idx) {
+      if (n.prev != NIL) s.link[n.prev].next = n.next; else L.head = n.next;
+      s.link[n.next].prev = n.prev;
+      n.prev = L.tail; n.next = NIL;
+      s.link[L.tail].next = idx;
+      L.tail = idx;
+    }
+  } else {
+    unlink(s, idx);
+    const int lvl = ensure_level(s, px);
+    if (lvl < 0) {                 // new price does not fit: keep the order as it was
+      relink(s, idx);
+      ++rejects_.price;
+      return false;
+    }
+    unmap_id(s, old_id);
+    n.px = px; n.qty = qty;
+    link_tail(s, lvl, idx);
+  }
+  map_id(s, new_id, idx);
+  s.ids[idx] = new_id;
+  return true;
+}
+
 int Lob::best_index(const Side& s) const { return s.best_level; }
 
+Lob::IdMap::ProbeStats Lob::id_map_stats(bool bid_side) const {
+  return (bid_side ? bid_ : ask_).id2ord.probe_stats();
+}
+
 bool Lob::match_top(Exec& e) {
   const int bi = best_index(bid_), ai = best_index(ask_);
   if (bi < 0 || ai < 0) return false;
@@ -184,25 +385,27 @@ bool Lob::match_top(Exec& e) {
   if (!B.active || !A.active) return false;
   if (B.px < A.px) return false;  // not crossed
 
-  const int bidx = B.head, aidx = A.head;
-  if (bidx < 0 || aidx < 0) return false;
+  const uint32_t bidx = B.head, aidx = A.head;
+  if (bidx == NIL || aidx == NIL) return false;
 
-  auto& b = bid_.pool[static_cast<size_t>(bidx)];
-  auto& a = ask_.pool[static_cast<size_t>(aidx)];
+  auto& b = bid_.link[bidx];
+  auto& a = ask_.link[aidx];
+  const uint64_t bts = bid_.ts[bidx], ats = ask_.ts[aidx];
+  const uint32_t bid_id = bid_.ids[bidx], ask_id = ask_.ids[aidx];
 
   const int32_t qty = (b.qty < a.qty) ? b.qty : a.qty;
-  const int32_t px  = (b.ts <= a.ts) ? a.px : b.px;
+  const int32_t px  = (bts <= ats) ? a.px : b.px;
 
-  e.ts = (b.ts < a.ts ? a.ts : b.ts);
-  e.id = (b.ts < a.ts ? b.id : a.id);
+  e.ts = (bts < ats ? ats : bts);
+  e.id = (bts < ats ? bid_id : ask_id);
   e.qty = qty;
   e.px  = px;
 
   b.qty -= qty; a.qty -= qty;
   B.total_qty -= qty; A.total_qty -= qty;
 
-  if (b.qty == 0) remove_idx(bid_, bidx);
-  if (a.qty == 0) remove_idx(ask_, aidx);
+  if (b.qty == 0) remove_idx(bid_, bidx, bid_id);
+  if (a.qty == 0) remove_idx(ask_, aidx, ask_id);
   return true;
 }
 
@@ -1,7 +1,12 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <span>
 #include <vector>
 #include <climits>
+#include "liblob/bitmap.h"
+#include "liblob/flat_map.h"
+#include "liblob/id_table.h"
 
 namespace t2t::lob {
 
@@ -15,90 +20,164 @@ struct Order {
 };
 struct Exec {
   uint64_t ts;
-  uint32_t id;   // id of aggressor (simplified)
+  uint32_t id;   // match_top: later-stamped side (simplified); add_and_match: resting order
   int32_t  px;
   int32_t  qty;
 };
+// What Lob::execute took off a resting order: the shares, at that order's
+// price and side (a feed's execute message need not carry either).
+struct Fill {
+  int32_t px{0};
+  int32_t qty{0};
+  bool    is_buy{false};
+};
+// Orders the book refused (add/replace returned false) instead of silently
+// dropping them, by reason. Any non-zero count means the book no longer
+// matches the feed.
+struct Rejects {
+  uint64_t price{0};      // price too far from the live levels to fit the ladder window
+  uint64_t capacity{0};   // order pool full (max_orders live on that side)
+  uint64_t total() const noexcept { return price + capacity; }
+};
+// Outcome of Lob::add_and_match. filled + rested < qty when the fill buffer
+// ran out while the order could still trade, or when the book refused to
+// rest the remainder (counted in Lob::rejects()); nothing rested then.
+struct Sweep {
+  std::size_t fills{0};   // Execs written
+  int32_t     filled{0};
+  int32_t     rested{0};
+};
 
 class Lob {
 public:
-  Lob();
-  void reset();
+  static constexpr std::size_t DEFAULT_MAX_ORDERS = 2'000'000;  // per side pool
+  static constexpr std::size_t DEFAULT_MAX_LEVELS = 1u << 16;    // per side ladder width (ticks)
+
+  // max_orders: live orders per side; max_levels: ladder width in ticks
+  // (<= LevelBitmap::MAX_BITS). Order pool and id map are reserved up front
+  // (no allocation after construction) but their pages are touched only as
+  // orders arrive, so construction is cheap and memory follows the
+  // high-water mark of live orders. prefault() touches them eagerly instead.
+  // id_window > 0 adds a direct-indexed id table (IdTable) covering that many
+  // consecutive ids: one lookup then resolves both side and slot; ids that
+  // do not fit its window fall back to the per-side hash maps.
+  explicit Lob(std::size_t max_orders = DEFAULT_MAX_ORDERS,
+               std::size_t max_levels = DEFAULT_MAX_LEVELS,
+               std::size_t id_window  = 0);
+  void reset();      // O(live orders + occupied levels)
+  void prefault();   // touch every pool page now, off the hot path; no-op once used
 
-  void add(const Order& o);       // price-time priority at each level
+  std::size_t max_orders() const noexcept { return bid_.max_live; }
+  std::size_t max_levels() const noexcept { return bid_.levels.size(); }
+  std::size_t live_orders() const noexcept { return bid_.live + ask_.live; }
+  std::size_t id_window()   const noexcept { return ids_.window(); }
+  std::size_t hashed_ids()  const noexcept { return bid_.id2ord.size() + ask_.id2ord.size(); }  // not in the direct table
+  const Rejects& rejects()  const noexcept { return rejects_; }
+
+  // Price-time priority at each level. false (counted in rejects()) if the
+  // order cannot be placed: its side already holds max_orders, or its
+  // price does not fit the ladder window together with the live levels.
+  bool add(const Order& o);
   void cancel(uint32_t id);       // idempotent; safe if already gone
+  // Partial fill / partial cancel: take qty shares off the order in place,
+  // keeping its queue position; the order goes when nothing is left (or
+  // qty <= 0). Returns the shares removed, 0 if id is unknown; execute also
+  // reports them in *f with the order's price and side (untouched if
+  // unknown).
+  int32_t execute(uint32_t id, int32_t qty, Fill* f = nullptr) { return shrink(id, qty, f); }
+  int32_t reduce(uint32_t id, int32_t qty)  { return shrink(id, qty, nullptr); }
+  // Same side, back of the queue, keeps the original ts; false if old_id is
+  // unknown, or if the new price cannot be placed (counted in rejects(); the
+  // order then stays as it was, under old_id and in its queue position).
+  // Reuses the order's slot; at an unchanged price the level is not touched
+  // beyond its FIFO and total.
+  bool replace(uint32_t old_id, uint32_t new_id, int32_t px, int32_t qty);
   bool match_top(Exec& e);        // consume at top if crossed; 1 exec per call
+  // Aggressive add: o trades against the opposite side in price-time order
+  // up to its limit, one Exec per resting order touched (at that order's
+  // price, stamped o.ts), written to fills in a single pass; the remainder
+  // rests as a normal add, which the book may refuse like any add (see
+  // Sweep). Stops early if fills is full.
+  Sweep add_and_match(const Order& o, std::span<Exec> fills);
+
+  // Lookahead hints for batch loops (engine::apply_batch): each pulls in
+  // what a later operation on id will touch, one dependent step per call,
+  // so issue them in this order a few events apart. They never change state.
+  void prefetch_id(uint32_t id) const noexcept;      // id-map slot(s)
+  void prefetch_order(uint32_t id) const noexcept;   // resolve id; its pool node
+  void prefetch_links(uint32_t id) const noexcept;   // its FIFO neighbours and level
+  void prefetch_level(int32_t px, bool is_buy) const noexcept;  // ladder slot for an add
 
   int  best_bid() const;          // INT32_MIN if empty
   int  best_ask() const;          // INT32_MAX if empty
 
+  using IdMap = FlatMap<uint32_t, uint32_t>;
+  IdMap::ProbeStats id_map_stats(bool bid_side) const;  // O(capacity); call after a run
+
 private:
   // ------------ Internal structures ------------
-  static constexpr int MAX_ORDERS = 2'000'000;   // per side pool
-  static constexpr int MAX_LEVELS = 8192;        // per side levels
-  template <typename K>
-  struct FixedMap {
-    struct Node { K key; int val; };
-    std::vector<Node> tab;
-    K empty_key;
-    explicit FixedMap(size_t pow2, K empty) : tab(pow2), empty_key(empty) {
-      for (auto& n : tab) { n.key = empty_key; n.val = -1; }
-    }
-    inline void clear() { for (auto& n: tab) { n.key=empty_key; n.val=-1; } }
-    inline int  get(const K& k) const {
-      size_t m = tab.size()-1, h = (size_t)1469598103934665603ull ^ (size_t)k;
-      for (size_t p=0;p<tab.size();++p) { auto& n = tab[(h+p)&m]; if (n.key==k) return n.val; if (n.key==empty_key) return -1; }
-      return -1;
-    }
-    inline void put(const K& k, int v) {
-      size_t m = tab.size()-1, h = (size_t)1469598103934665603ull ^ (size_t)k;
-      for (size_t p=0;p<tab.size();++p) { auto& n = tab[(h+p)&m]; if (n.key==empty_key || n.key==k) { n.key=k; n.val=v; return; } }
-    }
-    inline void erase(const K& k) {
-      size_t m = tab.size()-1, h = (size_t)1469598103934665603ull ^ (size_t)k;
-      for (size_t p=0;p<tab.size();++p) { auto& n = tab[(h+p)&m]; if (n.key==k) { n.key=empty_key; n.val=-1; return; } if (n.key==empty_key) return; }
-    }
-  };
+  static constexpr double ID_MAP_LOAD = 0.5;     // id2ord max load factor
+  static constexpr uint32_t NIL = UINT32_MAX;     // null order index
+  static constexpr uint32_t ASK_REF = 1u << 31;   // IdTable value: ASK_REF | index for asks
 
-  struct OrderNode {
-    uint32_t id{0};
-    int32_t  px{0};
+  // Order storage is split by access pattern. OrderLink holds what cancels,
+  // FIFO walks and fills touch (16 bytes, four per cache line); the id and
+  // timestamp live in parallel cold arrays read only by the fill paths
+  // (match_top, add_and_match) and reset; adds and replace only write them.
+  // px stays hot: it locates the level (slot = px - base_px).
+  struct OrderLink {
+    uint32_t next{NIL};  // FIFO queue (linked by index); free list when released
+    uint32_t prev{NIL};
     int32_t  qty{0};
-    uint64_t ts{0};
-    int      next{-1};   // FIFO queue (linked by index)
-    int      prev{-1};
-    int      level{-1};  // owning price level index
-    bool     is_buy{true};
-    bool     active{false};
+    int32_t  px{0};
   };
 
   struct PriceLevel {
-    int32_t px{0};
-    int     head{-1};
-    int     tail{-1};
-    int     total_qty{0};
-    bool    active{false};
+    int32_t  px{0};
+    uint32_t head{NIL};
+    uint32_t tail{NIL};
+    int      total_qty{0};
+    bool     active{false};
   };
 
+  // Price ladder: levels[px - base_px] for px in [base_px, base_px + max_levels).
+  // The base re-centres (shifting levels) when a price falls outside the window.
   struct Side {
-    std::vector<OrderNode> pool;
+    std::vector<OrderLink> link;  // hot; reserved to max_orders; size = high-water mark
+    std::vector<uint32_t>  ids;   // cold, parallel to link
+    std::vector<uint64_t>  ts;    // cold, parallel to link
     std::vector<PriceLevel> levels;
-    FixedMap<int32_t>   px2lvl;   // price -> level index
-    FixedMap<uint32_t>  id2ord;   // id -> order index
+    LevelBitmap         occ;      // occupied ladder slots
+    IdMap               id2ord;   // id -> order index (ids not in the direct table)
+    int64_t base_px{0};           // price of ladder slot 0
     int best_level{-1};           // index of best (max for bid, min for ask)
     bool is_buy{true};
-    int  free_head{-1};           // free list head for pool indices
-    explicit Side(bool buy);
+    uint32_t free_head{NIL};      // free list of released slots (below the high-water mark)
+    uint32_t live{0};             // orders resting on this side
+    uint32_t max_live{0};         // max_orders, the limit enqueue enforces (not link.capacity())
+    Side(bool buy, std::size_t max_orders, std::size_t max_levels);
+    int  width() const noexcept { return static_cast<int>(levels.size()); }
     void reset();
-    int  alloc_node();            // from free list
-    void free_node(int idx);      // return to free list
+    void prefault();
+    uint32_t alloc_node();        // free list, else next never-used slot
+    void free_node(uint32_t idx); // return to free list
   };
 
   Side bid_, ask_;
+  IdTable ids_;                   // optional; disabled when id_window == 0
+  Rejects rejects_;
 
   int  ensure_level(Side& s, int32_t px);
-  void enqueue(Side& s, const Order& o);
-  void remove_idx(Side& s, int idx);
+  bool recenter(Side& s, int32_t px);
+  bool enqueue(Side& s, const Order& o);
+  void remove_idx(Side& s, uint32_t idx, uint32_t id);
+  void unlink(Side& s, uint32_t idx);                  // out of its FIFO; empties the level if last
+  void link_tail(Side& s, int lvl, uint32_t idx);      // onto the back of level lvl's FIFO
+  void relink(Side& s, uint32_t idx);                  // undo unlink(): back between its old neighbours
+  int32_t shrink(uint32_t id, int32_t qty, Fill* f);
+  uint32_t lookup(uint32_t id, bool& ask) const noexcept;  // index, NIL if unknown
+  void map_id(Side& s, uint32_t id, uint32_t idx) noexcept;
+  void unmap_id(Side& s, uint32_t id) noexcept;
   int  best_index(const Side& s) const;
 };
 
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <cassert>
+
+// Single-producer / multi-consumer broadcast ring (Disruptor style): every
+// consumer sees every event from one shared buffer, each through its own
+// cursor. Two producer policies:
+//   Gating    : try_publish fails while the slowest consumer is a full ring
+//               behind (lossless, back-pressure).
+//   Overwrite : the producer never waits; a consumer that falls more than a
+//               ring behind gets Lagged, loses the overwritten events (counted
+//               in lost()) and resumes half a ring behind the producer.
+//
+// Each slot carries its own sequence word (seqlock): 2*(s+1) once event s is
+// published, odd while it is being written. Consumers poll only the slot they
+// want, never the producer's counter, and detect a torn read when the word
+// changes under them (Overwrite only). Register consumers before publishing.
+namespace t2t::ring {
+
+template <typename T>
+class BroadcastRing {
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+ public:
+  enum class Policy : uint8_t { Gating, Overwrite };
+  enum class Read : uint8_t { Ok, Empty, Lagged };
+
+  BroadcastRing(size_t capacity_pow2, size_t max_consumers, Policy policy = Policy::Gating)
+  : cap_(capacity_pow2), mask_(capacity_pow2 - 1), max_cons_(max_consumers), policy_(policy),
+    slots_(new Slot[capacity_pow2]), cons_(new Cursor[max_consumers]) {
+    assert((capacity_pow2 & (capacity_pow2 - 1)) == 0 && "capacity must be power of two");
+  }
+
+  BroadcastRing(const BroadcastRing&)            = delete;
+  BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+  // Setup: new consumer starting at the next published event; -1 if full.
+  int add_consumer() noexcept {
+    const size_t id = n_cons_.load(std::memory_order_relaxed);
+    if (id >= max_cons_) return -1;
+    cons_[id].next.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+    n_cons_.store(id + 1, std::memory_order_release);
+    return static_cast<int>(id);
+  }
+
+  // ---- Producer thread ----
+  bool try_publish(const T& x) noexcept {
+    const uint64_t s = head_.load(std::memory_order_relaxed);
+    if (policy_ == Policy::Gating && s - gate_cache_ >= cap_) {
+      gate_cache_ = slowest(s);
+      if (s - gate_cache_ >= cap_) return false; // slowest consumer a ring behind
+    }
+    Slot& sl = slots_[s & mask_];
+    sl.seq.store(2 * s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    sl.val = x;
+    sl.seq.store(2 * s + 2, std::memory_order_release);
+    head_.store(s + 1, std::memory_order_release);
+    return true;
+  }
+
+  // ---- Consumer threads (one per id) ----
+  Read try_read(int id, T& out) noexcept {
+    Cursor& c = cons_[id];
+    const uint64_t s    = c.next.load(std::memory_order_relaxed);
+    const Slot&    sl   = slots_[s & mask_];
+    const uint64_t want = 2 * s + 2;
+    const uint64_t v1   = sl.seq.load(std::memory_order_acquire);
+    if (v1 < want) return Read::Empty;        // not published yet (or being written)
+    if (v1 == want) {
+      out = sl.val;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sl.seq.load(std::memory_order_relaxed) == want) {
+        c.next.store(s + 1, std::memory_order_release);
+        return Read::Ok;
+      }
+    }
+    // Overwritten before or while reading: skip ahead.
+    const uint64_t h    = head_.load(std::memory_order_acquire);
+    const uint64_t jump = h > cap_ / 2 ? h - cap_ / 2 : 0;
+    const uint64_t to   = std::max(jump, s + 1);
+    c.lost += to - s;
+    c.next.store(to, std::memory_order_release);
+    return Read::Lagged;
+  }
+
+  uint64_t lost(int id) const noexcept { return cons_[id].lost; }                 // consumer thread
+  uint64_t cursor(int id) const noexcept { return cons_[id].next.load(std::memory_order_acquire); }
+  uint64_t published() const noexcept { return head_.load(std::memory_order_acquire); }
+  size_t   capacity() const noexcept { return cap_; }
+  size_t   consumers() const noexcept { return n_cons_.load(std::memory_order_acquire); }
+  Policy   policy() const noexcept { return policy_; }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> seq{0};
+    T val;
+  };
+  struct alignas(64) Cursor {
+    std::atomic<uint64_t> next{0};
+    uint64_t lost{0};
+  };
+
+  uint64_t slowest(uint64_t s) const noexcept {
+    uint64_t m = s;
+    const size_t n = n_cons_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < n; ++i) m = std::min(m, cons_[i].next.load(std::memory_order_acquire));
+    return m;
+  }
+
+  // producer line: next sequence + cached slowest cursor
+  alignas(64) std::atomic<uint64_t> head_{0};
+  uint64_t gate_cache_{0};
+  alignas(64) const size_t cap_;
+  const size_t mask_;
+  const size_t max_cons_;
+  const Policy policy_;
+  std::atomic<size_t> n_cons_{0};
+  std::unique_ptr<Slot[]>   slots_;
+  std::unique_ptr<Cursor[]> cons_;
+};
+
+} // namespace t2t::ring
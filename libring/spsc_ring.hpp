@@ -1,13 +1,22 @@
 #pragma once
 #include <cstddef>
 #include <cstdint>
+#include <algorithm>
 #include <atomic>
+#include <span>
 #include <type_traits>
 #include <cassert>
 #include <new>
 
 // Single-Producer/Single-Consumer ring (power-of-two capacity).
-// Non-blocking try_push / try_pop. Cache-line padded head/tail to avoid false sharing.
+// Non-blocking try_push / try_pop, batched try_push_n / try_pop_n, and
+// zero-copy reserve/commit (producer) and peek/release (consumer) spans.
+//
+// head_/tail_ are free-running counters (slot = counter & mask), so all
+// capacity() slots are usable. Each side keeps a private copy of the other
+// side's counter on its own cache line and reloads the shared one only when
+// the ring looks full (producer) or empty (consumer), so steady-state
+// operations touch the opposite cache line rarely.
 namespace t2t::ring {
 
 template <typename T>
@@ -25,33 +34,114 @@ class SpscRing {
   SpscRing(const SpscRing&)            = delete;
   SpscRing& operator=(const SpscRing&) = delete;
 
-  // Producer thread
+  // ---- Producer thread ----
   bool try_push(const T& x) noexcept {
     const size_t head = head_.load(std::memory_order_relaxed);
-    const size_t next = (head + 1u) & mask_;
-    if (next == tail_.load(std::memory_order_acquire)) return false; // full
-    buf_[head] = x;
-    head_.store(next, std::memory_order_release);
+    if (head - tail_cache_ == cap_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head - tail_cache_ == cap_) return false; // full
+    }
+    buf_[head & mask_] = x;
+    head_.store(head + 1u, std::memory_order_release);
     return true;
   }
 
-  // Consumer thread
+  // Push up to n items from src; returns how many were pushed.
+  size_t try_push_n(const T* src, size_t n) noexcept {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    n = std::min(n, free_slots(head, n));
+    if (n == 0) return 0;
+    const size_t i     = head & mask_;
+    const size_t first = std::min(n, cap_ - i);
+    std::copy(src, src + first, buf_ + i);
+    std::copy(src + first, src + n, buf_);
+    head_.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  // Up to n contiguous free slots to fill in place (may be shorter at the
+  // wrap point or when the ring is nearly full; empty if full). Publish with
+  // commit(k), k <= span size.
+  std::span<T> reserve(size_t n) noexcept {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t i    = head & mask_;
+    n = std::min({n, free_slots(head, n), cap_ - i});
+    return std::span<T>(buf_ + i, n);
+  }
+  void commit(size_t k) noexcept {
+    head_.store(head_.load(std::memory_order_relaxed) + k, std::memory_order_release);
+  }
+
+  // ---- Consumer thread ----
   bool try_pop(T& out) noexcept {
     const size_t tail = tail_.load(std::memory_order_relaxed);
-    if (tail == head_.load(std::memory_order_acquire)) return false; // empty
-    out = buf_[tail];
-    tail_.store((tail + 1u) & mask_, std::memory_order_release);
+    if (tail == head_cache_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail == head_cache_) return false; // empty
+    }
+    out = buf_[tail & mask_];
+    tail_.store(tail + 1u, std::memory_order_release);
     return true;
   }
 
+  // Pop up to n items into dst; returns how many were popped.
+  size_t try_pop_n(T* dst, size_t n) noexcept {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    n = std::min(n, used_slots(tail, n));
+    if (n == 0) return 0;
+    const size_t i     = tail & mask_;
+    const size_t first = std::min(n, cap_ - i);
+    std::copy(buf_ + i, buf_ + i + first, dst);
+    std::copy(buf_, buf_ + (n - first), dst + first);
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  // Up to n contiguous filled slots to read in place (shorter at the wrap
+  // point; empty if the ring is empty). Free them with release(k).
+  std::span<const T> peek(size_t n) noexcept {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t i    = tail & mask_;
+    n = std::min({n, used_slots(tail, n), cap_ - i});
+    return std::span<const T>(buf_ + i, n);
+  }
+  void release(size_t k) noexcept {
+    tail_.store(tail_.load(std::memory_order_relaxed) + k, std::memory_order_release);
+  }
+
   size_t capacity() const noexcept { return cap_; }
 
  private:
+  // Free slots seen by the producer, refreshing the cached tail only if
+  // fewer than `want` look free.
+  size_t free_slots(size_t head, size_t want) noexcept {
+    size_t n = cap_ - (head - tail_cache_);
+    if (n < want) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      n = cap_ - (head - tail_cache_);
+    }
+    return n;
+  }
+  // Filled slots seen by the consumer, refreshing the cached head only if
+  // fewer than `want` look filled.
+  size_t used_slots(size_t tail, size_t want) noexcept {
+    size_t n = head_cache_ - tail;
+    if (n < want) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      n = head_cache_ - tail;
+    }
+    return n;
+  }
+
+  // producer line: own counter + cached consumer counter
   alignas(64) std::atomic<size_t> head_{0};
+  size_t tail_cache_{0};
+  // consumer line: own counter + cached producer counter
   alignas(64) std::atomic<size_t> tail_{0};
-  const size_t cap_;
+  size_t head_cache_{0};
+  alignas(64) const size_t cap_;
   const size_t mask_;
-  alignas(64) T* const buf_;
+  T* const buf_;
   char _pad_[64]; // guard against false sharing with following objects
 };
 
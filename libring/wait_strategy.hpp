@@ -0,0 +1,156 @@
+#pragma once
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+#endif
+#if defined(__linux__)
+  #include <linux/futex.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+// How a thread waits for a ring condition (data to pop, space to push).
+//
+//   w.wait(ready);   // returns once ready() is true; ready() may have side
+//                    // effects (e.g. be a try_pop) and is re-evaluated
+//   w.notify();      // other side, after publishing; wakes a parked waiter
+//
+// One waiter object per direction, shared by both threads. Policies:
+//   BusySpin  : re-check in a tight loop (isolated cores, lowest latency)
+//   PauseSpin : _mm_pause between checks (SMT-friendly)
+//   SpinYield : pause-spin `spins` times, then sched_yield between checks
+//   SpinPark  : pause-spin `spins` times, then sleep on a futex until notify()
+// Pick one at compile time as a template parameter, or at run time with
+// Waiter (switch on Policy).
+namespace t2t::ring {
+
+inline void cpu_pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#endif
+}
+
+struct BusySpin {
+  template <class Ready> void wait(Ready&& ready) noexcept { while (!ready()) {} }
+  void notify() noexcept {}
+};
+
+struct PauseSpin {
+  template <class Ready> void wait(Ready&& ready) noexcept { while (!ready()) cpu_pause(); }
+  void notify() noexcept {}
+};
+
+struct SpinYield {
+  uint32_t spins{1000};
+  template <class Ready> void wait(Ready&& ready) noexcept {
+    for (uint32_t i = 0; !ready(); ++i) {
+      if (i < spins) cpu_pause();
+      else           std::this_thread::yield();
+    }
+  }
+  void notify() noexcept {}
+};
+
+// Parks on a futex word after spinning. notify() costs a fence and a load
+// while nobody is parked; it issues FUTEX_WAKE only when a waiter has
+// announced itself in sleepers_.
+class SpinPark {
+public:
+  uint32_t spins{1000};
+
+  template <class Ready> void wait(Ready&& ready) noexcept {
+    for (uint32_t i = 0; i < spins; ++i) {
+      if (ready()) return;
+      cpu_pause();
+    }
+    for (;;) {
+      if (ready()) return;
+      const uint32_t e = epoch_.load(std::memory_order_acquire);
+      sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      // Re-check after announcing: a notify() that missed us has already
+      // published, and one that sees us bumps epoch_ so the sleep returns.
+      if (ready()) { sleepers_.fetch_sub(1, std::memory_order_relaxed); return; }
+      park(e);
+      sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  void notify() noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) == 0) return;
+    epoch_.fetch_add(1, std::memory_order_release);
+    wake();
+  }
+
+private:
+  void park(uint32_t e) noexcept {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, e, nullptr, nullptr, 0);
+#else
+    epoch_.wait(e, std::memory_order_acquire);
+#endif
+  }
+  void wake() noexcept {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    epoch_.notify_all();
+#endif
+  }
+
+  alignas(64) std::atomic<uint32_t> epoch_{0};
+  std::atomic<uint32_t> sleepers_{0};
+};
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word");
+
+enum class WaitPolicy : uint8_t { BusySpin, PauseSpin, SpinYield, SpinPark };
+
+// "spin" | "pause" | "yield" | "park"; false if unknown.
+inline bool parse_wait_policy(std::string_view s, WaitPolicy& out) noexcept {
+  if (s == "spin")  { out = WaitPolicy::BusySpin;  return true; }
+  if (s == "pause") { out = WaitPolicy::PauseSpin; return true; }
+  if (s == "yield") { out = WaitPolicy::SpinYield; return true; }
+  if (s == "park")  { out = WaitPolicy::SpinPark;  return true; }
+  return false;
+}
+
+inline const char* wait_policy_name(WaitPolicy p) noexcept {
+  switch (p) {
+    case WaitPolicy::BusySpin:  return "spin";
+    case WaitPolicy::PauseSpin: return "pause";
+    case WaitPolicy::SpinYield: return "yield";
+    case WaitPolicy::SpinPark:  return "park";
+  }
+  return "?";
+}
+
+// Run-time selected policy (one predictable switch per wait/notify).
+class Waiter {
+public:
+  explicit Waiter(WaitPolicy p = WaitPolicy::PauseSpin, uint32_t spins = 1000) noexcept
+  : policy_(p) { yield_.spins = spins; park_.spins = spins; }
+
+  template <class Ready> void wait(Ready&& ready) noexcept {
+    switch (policy_) {
+      case WaitPolicy::BusySpin:  BusySpin{}.wait(ready);  break;
+      case WaitPolicy::PauseSpin: PauseSpin{}.wait(ready); break;
+      case WaitPolicy::SpinYield: yield_.wait(ready);      break;
+      case WaitPolicy::SpinPark:  park_.wait(ready);       break;
+    }
+  }
+  void notify() noexcept { if (policy_ == WaitPolicy::SpinPark) park_.notify(); }
+
+  WaitPolicy policy() const noexcept { return policy_; }
+
+private:
+  WaitPolicy policy_;
+  SpinYield  yield_;
+  SpinPark   park_;
+};
+
+} // namespace t2t::ring
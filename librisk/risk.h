@@ -39,4 +39,14 @@ public:
   }
 };
 
+// Position and cash P&L from our fills (execs are taken as fills against us).
+struct PnL {
+  int inv{0};
+  double pnl{0.0};
+  void on_exec(int32_t px, int32_t qty, bool is_buy) {
+    inv += is_buy ? qty : -qty;
+    pnl += (is_buy ? -1.0 : 1.0) * static_cast<double>(px) * static_cast<double>(qty);
+  }
+};
+
 } // namespace t2t::risk
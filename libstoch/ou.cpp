@@ -15,8 +15,9 @@ OuParams fit_ou(const std::vector<double>& x, double dt) {
     sx  += xt; sy  += yt;
     sxx += xt*xt; sxy += xt*yt;
   }
-  const double denom = n*sxx - sx*sx;
-  const double a = (n*sxy - sx*sy) / denom;
+  const double nd = static_cast<double>(n);
+  const double denom = nd*sxx - sx*sx;
+  const double a = (nd*sxy - sx*sy) / denom;
   const double b = (sy - a*sx) / static_cast<double>(n);
 
   double sse = 0.0;
@@ -32,4 +33,135 @@ OuParams fit_ou(const std::vector<double>& x, double dt) {
   return {kappa, theta, sigma};
 }
 
+// OLS on (possibly weighted) moments of centred pairs; SSE from the expansion
+// Σ(y - a x - b)² so no second pass over the samples is needed.
+static OuParams from_moments(double n, double sx, double sy, double sxx, double sxy,
+                             double syy, double dof, double centre, double dt) {
+  const double denom = n*sxx - sx*sx;
+  const double a = (n*sxy - sx*sy) / denom;
+  const double b = (sy - a*sx) / n;
+
+  double sse = syy - 2.0*a*sxy - 2.0*b*sy + a*a*sxx + 2.0*a*b*sx + n*b*b;
+  if (sse < 0.0) sse = 0.0;
+  const double var_eps = sse / dof;
+
+  const double kappa = -std::log(a) / dt;
+  const double theta = b / (1.0 - a) + centre;
+  const double sigma = std::sqrt(var_eps * (2.0*kappa) / (1.0 - std::exp(-2.0*kappa*dt)));
+  return {kappa, theta, sigma};
+}
+
+// -------- RollingOu --------
+RollingOu::RollingOu(std::size_t window) : xs_(window, 0.0), ts_(window, 0) {
+  assert(window >= 3);
+}
+
+void RollingOu::clear() noexcept {
+  head_ = count_ = shadow_pairs_ = 0;
+  c_ = c2_ = 0.0;
+  s_ = s2_ = Sums{};
+}
+
+double RollingOu::last() const noexcept {
+  if (count_ == 0) return 0.0;
+  const std::size_t w = xs_.size();
+  return xs_[(head_ + w - 1u) % w];
+}
+
+void RollingOu::push(uint64_t ts_ns, double x) noexcept {
+  const std::size_t w = xs_.size();
+  if (count_ == 0) c_ = c2_ = x;
+
+  if (count_ == w) {
+    // drop the oldest pair (xs[head], xs[head+1]); it went in about c_
+    s_.add(xs_[head_] - c_, xs_[(head_ + 1u) % w] - c_, -1.0);
+  }
+  if (count_ > 0) {
+    const double xp = xs_[(head_ + w - 1u) % w];
+    s_.add(xp - c_, x - c_, 1.0);
+    s2_.add(xp - c2_, x - c2_, 1.0);
+    if (++shadow_pairs_ == w - 1u) {
+      // The shadow now holds exactly the pairs of the (full) window: swap it
+      // in, dropping whatever error the live sums picked up, and start a new
+      // shadow about the newest sample.
+      s_ = s2_;
+      c_ = c2_;
+      s2_ = Sums{};
+      c2_ = x;
+      shadow_pairs_ = 0;
+    }
+  }
+
+  xs_[head_] = x;
+  ts_[head_] = ts_ns;
+  head_ = (head_ + 1u) % w;
+  if (count_ < w) ++count_;
+}
+
+double RollingOu::dt_s(double fallback) const noexcept {
+  if (count_ < 2) return fallback;
+  const std::size_t w = xs_.size();
+  const uint64_t t0 = ts_[(head_ + w - count_) % w];
+  const uint64_t t1 = ts_[(head_ + w - 1u) % w];
+  const double dt = (static_cast<double>(t1 - t0) / 1e9) / static_cast<double>(count_ - 1u);
+  return dt > 0.0 ? dt : fallback;
+}
+
+OuParams RollingOu::params(double dt) const noexcept {
+  assert(ready());
+  const double n = static_cast<double>(count_ - 1u);
+  return from_moments(n, s_.sx, s_.sy, s_.sxx, s_.sxy, s_.syy, n - 2.0, c_, dt);
+}
+
+// -------- EwOu --------
+EwOu::EwOu(double lambda) : lambda_(lambda) {
+  assert(lambda > 0.0 && lambda <= 1.0);
+}
+
+double EwOu::lambda_from_halflife(double halflife_samples) {
+  return halflife_samples > 0.0 ? std::exp2(-1.0 / halflife_samples) : 1.0;
+}
+
+void EwOu::clear() noexcept {
+  count_ = 0; last_ts_ = 0; last_x_ = c_ = 0.0;
+  sw_ = sx_ = sy_ = sxx_ = sxy_ = syy_ = sdt_ = 0.0;
+}
+
+void EwOu::push(uint64_t ts_ns, double x) noexcept {
+  if (count_ == 0) {
+    c_ = x;
+  } else {
+    const double l = lambda_;
+    const double xp = last_x_ - c_;
+    const double xn = x - c_;
+    sw_  = l*sw_  + 1.0;
+    sx_  = l*sx_  + xp;     sy_  = l*sy_  + xn;
+    sxx_ = l*sxx_ + xp*xp;  sxy_ = l*sxy_ + xp*xn;  syy_ = l*syy_ + xn*xn;
+    sdt_ = l*sdt_ + static_cast<double>(ts_ns - last_ts_);
+
+    // Re-centre on the newest sample; exact shift of the moments, O(1).
+    const double d = xn;
+    sxx_ += -2.0*d*sx_ + d*d*sw_;
+    syy_ += -2.0*d*sy_ + d*d*sw_;
+    sxy_ += -d*(sx_ + sy_) + d*d*sw_;
+    sx_  -= d*sw_;
+    sy_  -= d*sw_;
+    c_ = x;
+  }
+  last_x_ = x;
+  last_ts_ = ts_ns;
+  ++count_;
+}
+
+double EwOu::dt_s(double fallback) const noexcept {
+  if (sw_ <= 0.0) return fallback;
+  const double dt = (sdt_ / sw_) / 1e9;
+  return dt > 0.0 ? dt : fallback;
+}
+
+OuParams EwOu::params(double dt) const noexcept {
+  assert(ready());
+  return from_moments(sw_, sx_, sy_, sxx_, sxy_, syy_, sw_ - 2.0, c_, dt);
+}
+
 } // namespace t2t::stoch
@@ -1,13 +1,96 @@
 #pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace t2t::stoch {
 
 struct OuParams { double kappa, theta, sigma; };
 
+// A fit worth quoting from: mean-reverting (kappa > 0) with finite
+// parameters. A trending or flat window gives a >= 1 or a degenerate
+// regression, and with it a NaN or negative kappa.
+inline bool usable(const OuParams& p) noexcept {
+  return p.kappa > 0.0 && std::isfinite(p.kappa) && std::isfinite(p.theta) && std::isfinite(p.sigma);
+}
+
 // Fit OU parameters from a series x[0..n-1] sampled at fixed dt seconds.
 // Discrete model: x_{t+Δ} = a x_t + b + ε, with
 //   a = e^{-κΔ}, b = θ(1-a), Var(ε) = σ^2 (1-e^{-2κΔ})/(2κ)
 OuParams fit_ou(const std::vector<double>& x, double dt);
 
+// Streaming OU fit over the last `window` samples.
+// Keeps the OLS sufficient statistics (Σx, Σy, Σx², Σxy, Σy²) of the pairs
+// (x_t, x_{t+1}) inside a fixed ring, so push() is O(1) and never allocates.
+// Sums are kept about a centre so large mids stay exact. To stop add/subtract
+// drift, every pair also goes into a shadow set of sums about a newer centre;
+// once the shadow holds exactly the window's pairs (window - 1 pushes) it
+// replaces the live sums. Every push costs the same: there is no
+// O(window) recomputation.
+class RollingOu {
+public:
+  explicit RollingOu(std::size_t window);
+
+  void push(uint64_t ts_ns, double x) noexcept;
+  void clear() noexcept;
+
+  std::size_t size()   const noexcept { return count_; }
+  std::size_t window() const noexcept { return xs_.size(); }
+  bool        ready()  const noexcept { return count_ >= 3; }
+  double      last()   const noexcept;
+
+  // Mean sample spacing over the window (seconds); `fallback` if degenerate.
+  double   dt_s(double fallback = 1e-3) const noexcept;
+  // Same result as fit_ou() over the current window at spacing dt.
+  OuParams params(double dt) const noexcept;
+  OuParams params() const noexcept { return params(dt_s()); }
+
+private:
+  std::vector<double>   xs_;
+  std::vector<uint64_t> ts_;
+  std::size_t head_{0};   // next write slot
+  std::size_t count_{0};
+  struct Sums {
+    double sx{0}, sy{0}, sxx{0}, sxy{0}, syy{0};
+    inline void add(double x0, double x1, double sign) noexcept {
+      sx += sign*x0; sy += sign*x1;
+      sxx += sign*x0*x0; sxy += sign*x0*x1; syy += sign*x1*x1;
+    }
+  };
+  double c_{0.0};         // centre subtracted from every sample in s_
+  Sums   s_;
+  double c2_{0.0};        // shadow: pairs pushed since it was last swapped in
+  Sums   s2_;
+  std::size_t shadow_pairs_{0};
+};
+
+// Exponentially-weighted OU fit: each new pair has weight 1 and older pairs
+// decay by `lambda` per sample (lambda == 1 is an expanding-window fit_ou).
+class EwOu {
+public:
+  explicit EwOu(double lambda);
+  static double lambda_from_halflife(double halflife_samples);
+
+  void push(uint64_t ts_ns, double x) noexcept;
+  void clear() noexcept;
+
+  std::size_t size()  const noexcept { return count_; }
+  bool        ready() const noexcept { return count_ >= 3 && sw_ > 2.0; }
+  double      last()  const noexcept { return last_x_; }
+
+  double   dt_s(double fallback = 1e-3) const noexcept;
+  OuParams params(double dt) const noexcept;
+  OuParams params() const noexcept { return params(dt_s()); }
+
+private:
+  double lambda_;
+  std::size_t count_{0};
+  uint64_t last_ts_{0};
+  double last_x_{0.0};
+  double c_{0.0};
+  double sw_{0}, sx_{0}, sy_{0}, sxx_{0}, sxy_{0}, syy_{0};
+  double sdt_{0};         // decayed Σ Δts (ns), same weights as the pairs
+};
+
 } // namespace t2t::stoch
@@ -1,22 +1,63 @@
 #include "histo.h"
-#include <fstream>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 
 namespace t2t::histo {
 
-static void write_one(std::ofstream& ofs, const char* name, const Histo& h) {
-  for (size_t i = 0; i < h.edges_us.size(); ++i) {
-    ofs << name << ',' << h.edges_us[i] << ',' << h.counts[i] << '\n';
-  }
+LogHisto::LogHisto(unsigned sub_bits, unsigned value_bits)
+: sub_bits_(std::clamp(sub_bits, 1u, 16u)),
+  value_bits_(std::clamp(value_bits, sub_bits_, 63u)),
+  limit_(uint64_t{1} << value_bits_) {
+  assert(sub_bits == sub_bits_ && value_bits == value_bits_);
+  counts_.assign(index(limit_ - 1) + 1, 0);
+}
+
+// Index i < 2^sub_bits is the value itself; above, shift = (i >> (sub_bits-1)) - 1
+// and the bucket covers [sub << shift, (sub + 1) << shift).
+uint64_t LogHisto::bucket_lo(std::size_t i) const noexcept {
+  if (i < (std::size_t{1} << sub_bits_)) return i;
+  const unsigned shift = static_cast<unsigned>(i >> (sub_bits_ - 1u)) - 1u;
+  const uint64_t sub = i - (static_cast<std::size_t>(shift) << (sub_bits_ - 1u));
+  return sub << shift;
+}
+
+uint64_t LogHisto::bucket_width(std::size_t i) const noexcept {
+  if (i < (std::size_t{1} << sub_bits_)) return 1;
+  return uint64_t{1} << ((i >> (sub_bits_ - 1u)) - 1u);
 }
 
-void write_csv(const std::string& path, const AllStageHistos& h) {
-  std::ofstream ofs(path, std::ios::out | std::ios::trunc);
-  ofs << "stage,bucket_us,count\n";
-  write_one(ofs, "parse", h.parse);
-  write_one(ofs, "lob",   h.lob);
-  write_one(ofs, "sig",   h.sig);
-  write_one(ofs, "risk",  h.risk);
-  write_one(ofs, "e2e",   h.e2e);
+bool LogHisto::merge(const LogHisto& o) noexcept {
+  if (o.sub_bits_ != sub_bits_ || o.value_bits_ != value_bits_) return false;
+  for (std::size_t i = 0; i < counts_.size(); ++i) counts_[i] += o.counts_[i];
+  total_ += o.total_;
+  sum_   += o.sum_;
+  min_ = std::min(min_, o.min_);
+  max_ = std::max(max_, o.max_);
+  return true;
+}
+
+void LogHisto::reset() noexcept {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  total_ = sum_ = max_ = 0;
+  min_ = UINT64_MAX;
+}
+
+uint64_t LogHisto::quantile(double q) const noexcept {
+  if (total_ == 0) return 0;
+  const double r = std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total_));
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(r));
+  if (rank >= total_) return max_;   // exact ends
+  if (rank == 1) return min_;
+  uint64_t seen = 0;
+  for (std::size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      const uint64_t mid = bucket_lo(i) + (bucket_width(i) - 1) / 2;
+      return std::clamp(mid, min_, max_);
+    }
+  }
+  return max_;
 }
 
 } // namespace t2t::histo
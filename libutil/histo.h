@@ -1,29 +1,76 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 #include <vector>
-#include <string>
 
 namespace t2t::histo {
 
-struct Histo {
-  // Fixed microsecond bucket upper bounds, inclusive.
-  std::vector<uint32_t> edges_us;
-  std::vector<uint64_t> counts;
-  explicit Histo(std::vector<uint32_t> edges) : edges_us(std::move(edges)), counts(edges_us.size(), 0) {}
-  inline void add_ns(uint64_t ns) noexcept {
-    uint32_t us = (uint32_t)(ns / 1000u);
-    size_t i = 0;
-    for (; i < edges_us.size(); ++i) { if (us <= edges_us[i]) { counts[i]++; return; } }
-    if (!counts.empty()) counts.back()++;
+// HDR-style log-linear histogram of non-negative integers (latency ticks or
+// ns). Values below 2^sub_bits get a bucket each; above that each power of
+// two [2^k, 2^(k+1)) is cut into 2^(sub_bits-1) equal buckets, so a bucket
+// is never wider than 2^-(sub_bits-1) of the values in it and a quantile
+// (bucket midpoint) is within half that of the true sample. record() is a
+// bit scan, a shift and an increment: no search, no allocation. Values at
+// or above 2^value_bits land in the top bucket (max() stays exact).
+//
+// Histograms with the same layout merge by adding counts, so per-thread or
+// per-run histograms combine into one without keeping samples.
+class LogHisto {
+public:
+  static constexpr unsigned DEFAULT_SUB_BITS   = 8;    // <= 0.4% quantile error
+  static constexpr unsigned DEFAULT_VALUE_BITS = 42;   // 4.4e12: ~35 min of 2 GHz ticks
+
+  // sub_bits in [1, 16], value_bits in [sub_bits, 63].
+  explicit LogHisto(unsigned sub_bits = DEFAULT_SUB_BITS, unsigned value_bits = DEFAULT_VALUE_BITS);
+
+  inline void record(uint64_t v) noexcept {
+    ++counts_[index(v < limit_ ? v : limit_ - 1)];
+    ++total_;
+    sum_ += v;
+    if (v < min_) min_ = v;
+    if (v > max_) max_ = v;
   }
-};
 
-struct AllStageHistos {
-  Histo parse, lob, sig, risk, e2e;
-  explicit AllStageHistos(const std::vector<uint32_t>& edges)
-  : parse(edges), lob(edges), sig(edges), risk(edges), e2e(edges) {}
-};
+  // false (and no change) if the layouts differ.
+  bool merge(const LogHisto& o) noexcept;
+  void reset() noexcept;
+
+  uint64_t count() const noexcept { return total_; }
+  uint64_t min()   const noexcept { return total_ ? min_ : 0; }
+  uint64_t max()   const noexcept { return max_; }
+  double   mean()  const noexcept { return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0; }
+  unsigned sub_bits()   const noexcept { return sub_bits_; }
+  unsigned value_bits() const noexcept { return value_bits_; }
+  std::size_t buckets() const noexcept { return counts_.size(); }
+
+  // Value at quantile q in [0, 1]: the midpoint of the bucket holding the
+  // ceil(q * count())-th smallest sample, clamped to [min(), max()] (which
+  // the first and last ranks return exactly); 0 if empty. O(buckets), for
+  // reporting.
+  uint64_t quantile(double q) const noexcept;
 
-void write_csv(const std::string& path, const AllStageHistos& h);
+  // fn(lo, hi, count) for every non-empty bucket in value order; the
+  // bucket holds values in [lo, hi].
+  template <class Fn> void for_each(Fn&& fn) const {
+    for (std::size_t i = 0; i < counts_.size(); ++i) {
+      if (counts_[i]) fn(bucket_lo(i), bucket_lo(i) + bucket_width(i) - 1, counts_[i]);
+    }
+  }
+
+private:
+  inline std::size_t index(uint64_t v) const noexcept {
+    const unsigned len   = 64u - static_cast<unsigned>(__builtin_clzll(v | 1u));   // bit length
+    const unsigned shift = len > sub_bits_ ? len - sub_bits_ : 0u;
+    return (static_cast<std::size_t>(shift) << (sub_bits_ - 1u)) + static_cast<std::size_t>(v >> shift);
+  }
+  uint64_t bucket_lo(std::size_t i) const noexcept;
+  uint64_t bucket_width(std::size_t i) const noexcept;
+
+  unsigned sub_bits_, value_bits_;
+  uint64_t limit_;                 // 2^value_bits
+  std::vector<uint64_t> counts_;
+  uint64_t total_{0}, sum_{0};
+  uint64_t min_{UINT64_MAX}, max_{0};
+};
 
 } // namespace t2t::histo
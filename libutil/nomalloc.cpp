@@ -5,13 +5,14 @@
 namespace t2t::nomalloc {
 
 std::atomic<bool> g_guard_enabled{false};
+thread_local int t_allow_depth = 0;
 
 void enable_guard()  { g_guard_enabled.store(true,  std::memory_order_seq_cst); }
 void disable_guard() { g_guard_enabled.store(false, std::memory_order_seq_cst); }
 
 // Internal helpers that the global operators will call
 void* operator_new(std::size_t sz) {
-  if (g_guard_enabled.load(std::memory_order_relaxed)) {
+  if (g_guard_enabled.load(std::memory_order_relaxed) && t_allow_depth == 0) {
     std::fprintf(stderr, "[nomalloc] allocation of %zu bytes detected in hot path\n", sz);
     std::abort();
   }
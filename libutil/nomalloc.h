@@ -12,7 +12,19 @@ void enable_guard();
 // Call after hot-path finishes.
 void disable_guard();
 
-// Abort immediately on allocation if guard is enabled.
+// Per-thread exemption: while a ScopedAllow is alive on a thread, that
+// thread may allocate with the guard enabled. For rare cold paths inside the
+// guarded loop (e.g. first-touch creation of an instrument's book).
+extern thread_local int t_allow_depth;
+class ScopedAllow {
+public:
+  ScopedAllow() noexcept  { ++t_allow_depth; }
+  ~ScopedAllow() noexcept { --t_allow_depth; }
+  ScopedAllow(const ScopedAllow&)            = delete;
+  ScopedAllow& operator=(const ScopedAllow&) = delete;
+};
+
+// Abort immediately on allocation if guard is enabled (and not allowed).
 void* operator_new(std::size_t sz);
 void  operator_delete(void* p) noexcept;
 
@@ -0,0 +1,200 @@
+#include "perf_counters.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if T2T_HAVE_PERF_EVENT
+  #include <sys/ioctl.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+namespace t2t::perf {
+
+namespace {
+
+#if T2T_HAVE_PERF_EVENT
+
+struct Spec { uint32_t type; uint64_t config; };
+
+constexpr uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+constexpr Spec SPECS[N_COUNTERS] = {
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                   PERF_COUNT_HW_CACHE_RESULT_MISS)},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+  {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                   PERF_COUNT_HW_CACHE_RESULT_MISS)},
+};
+
+constexpr uint64_t READ_FORMAT =
+  PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+int open_event(const Spec& s, int leader) {
+  perf_event_attr a;
+  std::memset(&a, 0, sizeof a);
+  a.size = sizeof a;
+  a.type = s.type;
+  a.config = s.config;
+  if (leader < 0) a.disabled = 1;   // leader starts disabled; members follow it
+  a.exclude_kernel = 1;
+  a.exclude_hv = 1;
+  a.read_format = READ_FORMAT;
+  return static_cast<int>(syscall(SYS_perf_event_open, &a, 0, -1, leader, PERF_FLAG_FD_CLOEXEC));
+}
+
+std::string why(int e) {
+  char buf[160];
+  switch (e) {
+    case EACCES: case EPERM: {
+      const int p = paranoid_level();
+      if (p == INT32_MIN) return "permission denied (seccomp or missing CAP_PERFMON)";
+      std::snprintf(buf, sizeof buf, "permission denied (perf_event_paranoid=%d; user-space counting needs <= 2, "
+                    "or CAP_PERFMON; containers may block it via seccomp)", p);
+      return buf;
+    }
+    case ENOENT: case ENODEV: case EOPNOTSUPP:
+      return "no hardware PMU exposed (VM or container without PMU passthrough)";
+    case ENOSYS:
+      return "perf_event_open not supported by this kernel";
+    default:
+      std::snprintf(buf, sizeof buf, "perf_event_open: %s", std::strerror(e));
+      return buf;
+  }
+}
+#endif
+
+} // namespace
+
+const char* name(Counter c) noexcept {
+  switch (c) {
+    case Cycles:       return "cycles";
+    case Instructions: return "instructions";
+    case L1dMiss:      return "l1d_miss";
+    case LlcMiss:      return "llc_miss";
+    case BranchMiss:   return "branch_miss";
+    case DtlbMiss:     return "dtlb_miss";
+    default:           return "?";
+  }
+}
+
+#if T2T_HAVE_PERF_EVENT
+int paranoid_level() {
+  FILE* f = std::fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+  if (!f) return INT32_MIN;
+  int v = INT32_MIN;
+  if (std::fscanf(f, "%d", &v) != 1) v = INT32_MIN;
+  std::fclose(f);
+  return v;
+}
+
+bool Group::open(std::string* err) {
+  close();
+  fd_[Cycles] = open_event(SPECS[Cycles], -1);
+  if (fd_[Cycles] < 0) {
+    if (err) *err = why(errno);
+    return false;
+  }
+  slot_[Cycles] = members_++;
+  for (unsigned c = Cycles + 1; c < N_COUNTERS; ++c) {
+    fd_[c] = open_event(SPECS[c], fd_[Cycles]);
+    if (fd_[c] >= 0) slot_[c] = members_++;
+  }
+
+  // One read-only page per event: the kernel publishes its index/offset
+  // there, and cap_user_rdpmc says whether user space may rdpmc it.
+  const long pg = sysconf(_SC_PAGESIZE);
+  for (unsigned c = 0; c < N_COUNTERS; ++c) {
+    if (fd_[c] < 0) continue;
+    void* p = mmap(nullptr, static_cast<size_t>(pg), PROT_READ, MAP_SHARED, fd_[c], 0);
+    if (p != MAP_FAILED) page_[c] = static_cast<const perf_event_mmap_page*>(p);
+  }
+  ioctl(fd_[Cycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fd_[Cycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#if T2T_HAVE_RDPMC
+  rdpmc_ = true;
+  for (unsigned c = 0; c < N_COUNTERS; ++c) {
+    if (fd_[c] >= 0 && (!page_[c] || !page_[c]->cap_user_rdpmc)) rdpmc_ = false;
+  }
+#endif
+
+  constexpr int N = 101;
+  uint64_t d[N_COUNTERS][N];
+  for (int i = 0; i < N; ++i) {
+    Snapshot a, b;
+    read(a);
+    read(b);
+    for (unsigned c = 0; c < N_COUNTERS; ++c) d[c][i] = b.v[c] - a.v[c];
+  }
+  for (unsigned c = 0; c < N_COUNTERS; ++c) {
+    std::nth_element(d[c], d[c] + N / 2, d[c] + N);
+    overhead_.v[c] = d[c][N / 2];
+  }
+  return true;
+}
+
+void Group::close() noexcept {
+  const long pg = sysconf(_SC_PAGESIZE);
+  for (unsigned c = 0; c < N_COUNTERS; ++c) {
+    if (page_[c]) munmap(const_cast<perf_event_mmap_page*>(page_[c]), static_cast<size_t>(pg));
+    page_[c] = nullptr;
+  }
+  for (int c = N_COUNTERS - 1; c >= 0; --c) {   // members before the leader
+    if (fd_[c] >= 0) ::close(fd_[c]);
+    fd_[c] = -1;
+    slot_[c] = -1;
+  }
+  members_ = 0;
+  rdpmc_ = false;
+  overhead_ = Snapshot{};
+}
+
+void Group::read_group(Snapshot& s) const noexcept {
+  s = Snapshot{};
+  if (!ok()) return;
+  uint64_t buf[3 + N_COUNTERS] = {};   // nr, time_enabled, time_running, values
+  const ssize_t want = static_cast<ssize_t>((3 + static_cast<size_t>(members_)) * sizeof(uint64_t));
+  if (::read(fd_[Cycles], buf, sizeof buf) != want) return;
+  for (unsigned c = 0; c < N_COUNTERS; ++c) {
+    if (slot_[c] >= 0) s.v[c] = buf[3 + slot_[c]];
+  }
+}
+
+double Group::running_fraction() const noexcept {
+  if (!ok()) return 0.0;
+  uint64_t buf[3 + N_COUNTERS] = {};
+  if (::read(fd_[Cycles], buf, sizeof buf) < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buf[1] == 0) return 0.0;
+  return static_cast<double>(buf[2]) / static_cast<double>(buf[1]);
+}
+
+#else
+int paranoid_level() { return INT32_MIN; }
+
+bool Group::open(std::string* err) {
+  if (err) *err = "hardware counters need Linux perf_event_open";
+  return false;
+}
+void   Group::close() noexcept {}
+void   Group::read_group(Snapshot& s) const noexcept { s = Snapshot{}; }
+double Group::running_fraction() const noexcept { return 0.0; }
+#endif
+
+double StageCounts::per_event(Counter c, const Snapshot& overhead) const noexcept {
+  if (events == 0) return 0.0;
+  const double v = static_cast<double>(sum[c]) / static_cast<double>(events) - static_cast<double>(overhead.v[c]);
+  return std::max(v, 0.0);
+}
+
+double StageCounts::ipc(const Snapshot& overhead) const noexcept {
+  const double cyc = per_event(Cycles, overhead);
+  return cyc > 0.0 ? per_event(Instructions, overhead) / cyc : 0.0;
+}
+
+} // namespace t2t::perf
@@ -0,0 +1,172 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+#if defined(__linux__)
+  #include <linux/perf_event.h>
+  #define T2T_HAVE_PERF_EVENT 1
+#else
+  #define T2T_HAVE_PERF_EVENT 0
+#endif
+
+#if T2T_HAVE_PERF_EVENT && (defined(__x86_64__) || defined(__i386__))
+  #include <x86intrin.h>
+  #define T2T_HAVE_RDPMC 1
+#else
+  #define T2T_HAVE_RDPMC 0
+#endif
+
+namespace t2t::perf {
+
+// Hardware performance counters for one thread, opened as a single
+// perf_event group (user space only) so they are scheduled on the PMU
+// together. The group counts from open() until it is closed; callers take
+// Snapshots around the code of interest and use differences.
+//
+// read() uses rdpmc when the kernel allows it on every counter's mmap page
+// (a few dozen cycles per counter, no syscall), else one read() of the
+// group. Counters are per thread: open and read a Group on the thread it
+// measures. Counters the PMU lacks are left out of the group (has() is
+// false, they read as 0); without even a cycle counter open() fails and
+// says why (no PMU in the VM or container, perf_event_paranoid, seccomp,
+// or not Linux).
+enum Counter : unsigned { Cycles, Instructions, L1dMiss, LlcMiss, BranchMiss, DtlbMiss, N_COUNTERS };
+
+const char* name(Counter c) noexcept;
+
+struct Snapshot {
+  uint64_t v[N_COUNTERS]{};
+};
+
+class Group {
+public:
+  Group() = default;
+  ~Group() { close(); }
+  Group(const Group&) = delete;
+  Group& operator=(const Group&) = delete;
+
+  // Open and start the counters for the calling thread. Also measures the
+  // cost of a read itself (overhead()). false, with the reason in *err, if
+  // no cycle counter can be opened.
+  bool open(std::string* err = nullptr);
+  void close() noexcept;
+
+  bool ok()     const noexcept { return fd_[Cycles] >= 0; }
+  bool has(Counter c) const noexcept { return fd_[c] >= 0; }
+  bool rdpmc()  const noexcept { return rdpmc_; }
+
+  // Median counts of one back-to-back pair of reads: what every delta
+  // includes just from taking the snapshots.
+  const Snapshot& overhead() const noexcept { return overhead_; }
+
+  // Fraction of the time since open() the group was on the PMU (< 1 when
+  // the kernel multiplexed it with other events); 0 if not ok().
+  double running_fraction() const noexcept;
+
+  inline void read(Snapshot& s) const noexcept {
+#if T2T_HAVE_RDPMC
+    if (rdpmc_) [[likely]] {
+      for (unsigned c = 0; c < N_COUNTERS; ++c) s.v[c] = page_[c] ? read_page(page_[c]) : 0;
+      return;
+    }
+#endif
+    read_group(s);
+  }
+
+private:
+#if T2T_HAVE_PERF_EVENT
+  using Page = perf_event_mmap_page;
+#else
+  using Page = void;
+#endif
+#if T2T_HAVE_RDPMC
+  // Seqlock read of the kernel's count for one event: its offset plus the
+  // live hardware counter (sign-extended from pmc_width bits) while the
+  // event is on the PMU (index != 0).
+  static inline uint64_t read_page(const volatile perf_event_mmap_page* pc) noexcept {
+    uint32_t seq;
+    uint64_t count;
+    do {
+      seq = pc->lock;
+      asm volatile("" ::: "memory");
+      const uint32_t idx = pc->index;
+      count = static_cast<uint64_t>(pc->offset);
+      if (pc->cap_user_rdpmc && idx != 0) {
+        const unsigned shift = 64u - static_cast<unsigned>(pc->pmc_width);
+        const uint64_t raw = __rdpmc(static_cast<int>(idx - 1)) << shift;
+        count += static_cast<uint64_t>(static_cast<int64_t>(raw) >> shift);
+      }
+      asm volatile("" ::: "memory");
+    } while (pc->lock != seq);
+    return count;
+  }
+#endif
+  void read_group(Snapshot& s) const noexcept;
+
+  int      fd_[N_COUNTERS] = {-1, -1, -1, -1, -1, -1};
+  int      slot_[N_COUNTERS] = {-1, -1, -1, -1, -1, -1};   // position in a group read()
+  int      members_{0};
+  const Page* page_[N_COUNTERS] = {};
+  bool     rdpmc_{false};
+  Snapshot overhead_{};
+};
+
+// Counter deltas summed over the sampled events that passed through one
+// stage.
+struct StageCounts {
+  uint64_t sum[N_COUNTERS]{};
+  uint64_t events{0};
+
+  inline void add(const Snapshot& from, const Snapshot& to) noexcept {
+    for (unsigned c = 0; c < N_COUNTERS; ++c) sum[c] += to.v[c] - from.v[c];
+    ++events;
+  }
+  // Mean per event with the snapshot cost (Group::overhead) taken off,
+  // floored at 0.
+  double per_event(Counter c, const Snapshot& overhead) const noexcept;
+  // Instructions per cycle on the same basis; 0 without cycles.
+  double ipc(const Snapshot& overhead) const noexcept;
+};
+
+// One thread's Group, charged to stages on every `every`-th event after
+// `skip` warm-up events: sample() at the event's first timing mark decides
+// and takes the starting snapshot, then charge() at each stage egress adds
+// the delta since the previous snapshot to that stage. Sampled events also
+// carry the snapshot cost in their latency samples, so keep `every` sparse.
+class Sampler {
+public:
+  explicit Sampler(unsigned every = 0, uint64_t skip = 0) : every_(every), skip_(skip) {}
+
+  // On the owning thread; false (with *err) if counters are unavailable.
+  bool open(std::string* err = nullptr) { return every_ > 0 && group_.open(err); }
+
+  inline bool sample() noexcept {
+    if (!group_.ok()) return false;
+    if (skip_ > 0) { --skip_; return false; }
+    if (++n_ < every_) return false;
+    n_ = 0;
+    group_.read(last_);
+    return true;
+  }
+  inline void charge(StageCounts& c) noexcept {
+    Snapshot now;
+    group_.read(now);
+    c.add(last_, now);
+    last_ = now;
+  }
+
+  const Group& group() const noexcept { return group_; }
+  unsigned     every() const noexcept { return every_; }
+
+private:
+  Group    group_;
+  Snapshot last_{};
+  unsigned every_;
+  unsigned n_{0};
+  uint64_t skip_;
+};
+
+// /proc/sys/kernel/perf_event_paranoid, or INT32_MIN if unreadable.
+int paranoid_level();
+
+} // namespace t2t::perf
@@ -4,10 +4,14 @@
 
 namespace t2t::timing {
 
-ScopedTimer::~ScopedTimer() noexcept {
-  auto t1 = clock::now();
-  uint64_t ns = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
-  buf.push(ns);
+void SampleBuffer::to_ns() noexcept {
+  const size_t n = std::min(idx.load(std::memory_order_relaxed), ns.size());
+  for (size_t i = 0; i < n; ++i) ns[i] = tsc::to_ns(ns[i]);
+}
+
+void StageTimers::to_ns() noexcept {
+  for (Stage* s : {&parse, &lob, &sig, &risk, &encode, &e2e, &service, &queue, &handoff, &handoff2})
+    s->raw.to_ns();
 }
 
 uint64_t now_ns() {
@@ -15,46 +19,53 @@ uint64_t now_ns() {
            clock::now().time_since_epoch()).count();
 }
 
-static void write_one(std::ofstream& ofs, const char* stage,
-                      const std::vector<uint64_t>& ns, size_t warmup, size_t total) {
-  size_t start = warmup < ns.size() ? warmup : ns.size();
-  size_t end   = std::min(total, ns.size());
-  for (size_t i = start; i < end; ++i) {
-    ofs << stage << ',' << ns[i] << '\n';
-  }
+namespace {
+
+struct Named { const char* name; const Stage* stage; };
+
+std::vector<Named> stages(const StageTimers& st) {
+  return {{"parse", &st.parse}, {"lob", &st.lob}, {"sig", &st.sig}, {"risk", &st.risk},
+          {"encode", &st.encode}, {"e2e", &st.e2e}, {"service", &st.service}, {"queue", &st.queue},
+          {"handoff", &st.handoff}, {"handoff2", &st.handoff2}};
 }
 
-void write_csv_latency(const std::string& path,
-                       const StageTimers& st,
-                       size_t warmup,
-                       size_t total) {
+} // namespace
+
+void write_csv_latency(const std::string& path, const StageTimers& st) {
   std::ofstream ofs(path, std::ios::out | std::ios::trunc);
   ofs << "stage,ns\n";
-  write_one(ofs, "parse", st.parse.ns, warmup, total);
-  write_one(ofs, "lob",   st.lob.ns,   warmup, total);
-  write_one(ofs, "sig",   st.sig.ns,   warmup, total);
-  write_one(ofs, "risk",  st.risk.ns,  warmup, total);
-  write_one(ofs, "e2e",   st.e2e.ns,   warmup, total);
+  for (const auto& [name, s] : stages(st)) {
+    const size_t n = std::min(s->raw.idx.load(std::memory_order_relaxed), s->raw.ns.size());
+    for (size_t i = 0; i < n; ++i) ofs << name << ',' << s->raw.ns[i] << '\n';
+  }
 }
 
-static double quantile_us(std::vector<uint64_t> v, size_t warmup, size_t total, double q) {
-  size_t start = std::min(warmup, v.size());
-  size_t end   = std::min(total, v.size());
-  if (end <= start + 1) return 0.0;
-  auto first = v.begin() + (ptrdiff_t)start;
-  auto last  = v.begin() + (ptrdiff_t)end;
-  auto kth   = first + (ptrdiff_t)((end - start - 1) * q);
-  std::nth_element(first, kth, last);
-  uint64_t ns = *kth;
-  return ns / 1000.0;
+void write_csv_histo(const std::string& path, const StageTimers& st) {
+  std::ofstream ofs(path, std::ios::out | std::ios::trunc);
+  ofs << "stage,lo_ns,hi_ns,count\n";
+  for (const auto& [name, s] : stages(st)) {
+    if (!s->used()) continue;
+    // Tick buckets narrower than 1 ns convert to the same ns range: merge
+    // rows until the next bucket starts past the pending one.
+    uint64_t lo_ns = 0, hi_ns = 0, n = 0;
+    s->hist.for_each([&, nm = name](uint64_t lo, uint64_t hi, uint64_t c) {
+      const uint64_t l = tsc::to_ns(lo), h = tsc::to_ns(hi);
+      if (n && l <= hi_ns) { hi_ns = std::max(hi_ns, h); n += c; return; }
+      if (n) ofs << nm << ',' << lo_ns << ',' << hi_ns << ',' << n << '\n';
+      lo_ns = l; hi_ns = h; n = c;
+    });
+    if (n) ofs << name << ',' << lo_ns << ',' << hi_ns << ',' << n << '\n';
+  }
 }
 
-Summary summarize(const std::vector<uint64_t>& ns, size_t warmup, size_t total) {
+Summary summarize(const histo::LogHisto& h) {
+  auto us = [&](double q) { return static_cast<double>(tsc::to_ns(h.quantile(q))) / 1000.0; };
   Summary s;
-  s.p50_us  = quantile_us(ns, warmup, total, 0.50);
-  s.p90_us  = quantile_us(ns, warmup, total, 0.90);
-  s.p99_us  = quantile_us(ns, warmup, total, 0.99);
-  s.p999_us = quantile_us(ns, warmup, total, 0.999);
+  s.p50_us   = us(0.50);
+  s.p90_us   = us(0.90);
+  s.p99_us   = us(0.99);
+  s.p999_us  = us(0.999);
+  s.p9999_us = us(0.9999);
   return s;
 }
 
@@ -4,46 +4,101 @@
 #include <string>
 #include <vector>
 #include <atomic>
+#include "histo.h"
+#include "tsc.h"
 
 namespace t2t::timing {
 
 using clock = std::chrono::steady_clock;
 
+// Stage clock: raw tsc ticks (see tsc.h). Differences of now_ticks() are
+// recorded as ticks and become ns only when reported.
+inline uint64_t now_ticks() noexcept { return tsc::start(); }
+
+// Raw per-message samples, preallocated: ticks while running, ns after
+// to_ns(). One writer thread; read idx after it has been joined.
 struct SampleBuffer {
-  // Preallocated buffer for per-message ns samples.
   std::vector<uint64_t> ns;
   std::atomic<size_t>   idx{0};
   explicit SampleBuffer(size_t cap) : ns(cap, 0) {}
   inline void push(uint64_t v) noexcept {
-    size_t i = idx.fetch_add(1, std::memory_order_relaxed);
+    const size_t i = idx.load(std::memory_order_relaxed);
     if (i < ns.size()) ns[i] = v;
+    idx.store(i + 1, std::memory_order_relaxed);
+  }
+  void to_ns() noexcept;   // convert the samples pushed so far
+};
+
+// One timed stage. Every sample (in ticks) goes into a log-linear
+// histogram, which is all the summaries and latency_hist.csv need; raw
+// capture (raw_cap > 0) also keeps each sample for latency.csv. The first
+// `skip` samples (warm-up) are dropped. One writer thread per stage.
+struct Stage {
+  histo::LogHisto hist;
+  SampleBuffer    raw;
+  uint64_t        skip, seen{0};
+  Stage(size_t warmup, size_t raw_cap, unsigned sub_bits = histo::LogHisto::DEFAULT_SUB_BITS)
+  : hist(sub_bits), raw(raw_cap), skip(warmup) {}
+  inline void push(uint64_t ticks) noexcept {
+    if (seen++ < skip) return;
+    hist.record(ticks);
+    if (!raw.ns.empty()) raw.push(ticks);
   }
+  bool used() const noexcept { return seen > 0; }
 };
 
+// Per-event stage samples. Stages are timed between egress marks: each
+// stage's sample runs from the previous stage's egress (or from when its
+// thread picked the event up) to its own. e2e runs from ingress (the feed
+// handler first sees the event, before decoding) to encoded output ready,
+// and splits into service (sum of the stage samples) and queue (the rest:
+// ring waits, batching, a busy worker).
 struct StageTimers {
-  SampleBuffer parse, lob, sig, risk, e2e;
-  explicit StageTimers(size_t cap)
-  : parse(cap), lob(cap), sig(cap), risk(cap), e2e(cap) {}
+  Stage parse, lob, sig, risk, encode;
+  Stage e2e, service, queue;
+  // Threaded modes only (omitted from output if unused):
+  Stage handoff;    // event ring push -> pop
+  Stage handoff2;   // --pipeline: book -> risk ring push -> pop
+  // raw_cap: samples kept per stage for latency.csv (0 = histograms only);
+  // sub_bits: histogram precision (LogHisto).
+  StageTimers(size_t warmup, size_t raw_cap, bool threaded = false,
+              unsigned sub_bits = histo::LogHisto::DEFAULT_SUB_BITS)
+  : parse(warmup, raw_cap, sub_bits), lob(warmup, raw_cap, sub_bits), sig(warmup, raw_cap, sub_bits),
+    risk(warmup, raw_cap, sub_bits), encode(warmup, raw_cap, sub_bits), e2e(warmup, raw_cap, sub_bits),
+    service(warmup, raw_cap, sub_bits), queue(warmup, raw_cap, sub_bits),
+    handoff(warmup, threaded ? raw_cap : 0, sub_bits), handoff2(warmup, threaded ? raw_cap : 0, sub_bits) {}
+  // One event's e2e (ticks) and the service part of it; service is capped
+  // at e2e so service + queue == e2e holds for every sample.
+  inline void split(uint64_t total, uint64_t svc) noexcept {
+    if (svc > total) svc = total;
+    e2e.push(total);
+    service.push(svc);
+    queue.push(total - svc);
+  }
+  void to_ns() noexcept;   // raw samples; once, before writing them
 };
 
 struct ScopedTimer {
-  SampleBuffer& buf;
-  const clock::time_point t0;
-  explicit ScopedTimer(SampleBuffer& b) noexcept : buf(b), t0(clock::now()) {}
-  ~ScopedTimer() noexcept;
+  Stage& stage;
+  const uint64_t t0;
+  explicit ScopedTimer(Stage& s) noexcept : stage(s), t0(tsc::start()) {}
+  ~ScopedTimer() noexcept { stage.push(tsc::stop() - t0); }
 };
 
 uint64_t now_ns();
 
-void write_csv_latency(const std::string& path,
-                       const StageTimers& st,
-                       size_t warmup,
-                       size_t total);
+// Raw samples (after to_ns()) as stage,ns rows; stages without raw capture
+// are skipped.
+void write_csv_latency(const std::string& path, const StageTimers& st);
+
+// Every used stage's histogram as stage,lo_ns,hi_ns,count rows (non-empty
+// buckets only).
+void write_csv_histo(const std::string& path, const StageTimers& st);
 
 struct Summary {
-  double p50_us{}, p90_us{}, p99_us{}, p999_us{};
+  double p50_us{}, p90_us{}, p99_us{}, p999_us{}, p9999_us{};
 };
 
-Summary summarize(const std::vector<uint64_t>& ns, size_t warmup, size_t total);
+Summary summarize(const histo::LogHisto& ticks);
 
 } // namespace t2t::timing
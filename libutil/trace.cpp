@@ -0,0 +1,75 @@
+#include "trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+
+namespace t2t::trace {
+
+Recorder::Recorder(const Config& cfg) : cfg_(cfg) {
+  cfg_.capacity = std::max<std::size_t>(cfg_.capacity, 1);
+  cfg_.every    = std::max<uint32_t>(cfg_.every, 1);
+  if (cfg_.slow_ticks == 0) cfg_.context = 0;
+  bytes_ = (cfg_.capacity + cfg_.context) * sizeof(Record);
+  void* p = mmap(nullptr, bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) return;
+  std::memset(p, 0, bytes_);   // fault every page in now, not on the hot path
+  ring_ = static_cast<Record*>(p);
+  ctx_  = ring_ + cfg_.capacity;
+}
+
+Recorder::~Recorder() {
+  if (ring_) munmap(ring_, bytes_);
+}
+
+bool Recorder::flush(const std::string& path, double ns_per_tick, std::string* err) const {
+  auto fail = [&](const char* what) {
+    if (err) *err = path + ": " + what + " (" + std::strerror(errno) + ")";
+    return false;
+  };
+  FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return fail("cannot open");
+  Header h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version     = kVersion;
+  h.record_size = sizeof(Record);
+  h.records     = records();
+  h.offered     = offered_;
+  h.overwritten = kept_ - h.records;
+  h.ns_per_tick = ns_per_tick;
+  h.slow_ticks  = cfg_.slow_ticks;
+  h.every       = cfg_.every;
+  h.context     = cfg_.context;
+  bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1;
+  // Oldest first: once the ring has wrapped, that is the slot after the newest.
+  const std::size_t first = kept_ > cfg_.capacity ? kept_ % cfg_.capacity : 0;
+  const std::size_t n1 = std::min<std::size_t>(h.records, cfg_.capacity - first);
+  if (ok && n1) ok = std::fwrite(ring_ + first, sizeof(Record), n1, f) == n1;
+  if (ok && h.records > n1) ok = std::fwrite(ring_, sizeof(Record), h.records - n1, f) == h.records - n1;
+  if (std::fclose(f) != 0) ok = false;
+  return ok || fail("write failed");
+}
+
+bool load(const std::string& path, Header& h, std::vector<Record>& out, std::string* err) {
+  auto fail = [&](const char* what) {
+    if (err) *err = path + ": " + what;
+    return false;
+  };
+  FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) return fail("cannot open");
+  bool ok = std::fread(&h, sizeof(h), 1, f) == 1;
+  if (ok && (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion ||
+             h.record_size != sizeof(Record))) {
+    std::fclose(f);
+    return fail("not a t2t trace (or another version)");
+  }
+  if (ok) {
+    out.resize(h.records);
+    ok = std::fread(out.data(), sizeof(Record), out.size(), f) == out.size();
+  }
+  std::fclose(f);
+  return ok || fail("truncated");
+}
+
+} // namespace t2t::trace
@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary event trace for latency forensics: what the book and strategy saw
+// and decided at each traced event, with the stage marks that show where
+// its time went. A Recorder is one thread's ring of fixed 64-byte Records
+// in memory mapped (and touched) at construction, so record() never
+// allocates or makes a syscall; flush() writes the ring to a file once the
+// run is over. tools/read_trace.py decodes it.
+//
+// Layout (little-endian, native struct layout):
+//   Header           64 bytes
+//   Record[records]  64 bytes each, oldest first
+namespace t2t::trace {
+
+constexpr char     kMagic[8] = {'T', '2', 'T', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t kVersion  = 1;
+
+// Stage egress marks, in ticks after ingress (0 = not available).
+enum Mark : unsigned { Parse, Lob, Sig, Risk, Encode, N_MARKS };
+
+// Record::flags
+constexpr uint8_t kSlow    = 1;   // over the slow threshold (context records are not)
+constexpr uint8_t kNoBook  = 2;   // book stages ran on another thread: no lob mark or top of book
+
+struct Record {
+  uint64_t seq;               // event index in the run
+  uint64_t t_ingress;         // ticks (tsc.h)
+  uint32_t mark[N_MARKS];     // mark[Encode] is the event's e2e
+  uint32_t order_id;
+  int32_t  best_bid, best_ask;   // after the book update
+  int32_t  bid_px, ask_px;       // quote
+  int32_t  inv;
+  uint8_t  type;              // itch::EvType
+  uint8_t  side;              // 1 = buy
+  uint8_t  allowed;           // risk decision
+  uint8_t  flags;
+};
+static_assert(sizeof(Record) == 64, "trace record layout");
+
+struct Header {
+  char     magic[8];
+  uint32_t version;
+  uint32_t record_size;       // sizeof(Record)
+  uint64_t records;           // in the file
+  uint64_t offered;           // events passed to record()
+  uint64_t overwritten;       // kept, then lost to a full ring
+  double   ns_per_tick;       // to convert t_ingress and marks
+  uint64_t slow_ticks;        // 0 = plain sampling
+  uint32_t every;
+  uint32_t context;
+};
+static_assert(sizeof(Header) == 64, "trace header layout");
+
+// Which events a Recorder keeps.
+//   slow_ticks == 0: every `every`-th event (1 = all).
+//   slow_ticks > 0:  events whose e2e (mark[Encode]) is at least slow_ticks,
+//                    each with up to `context` events before and after it.
+// Either way the ring keeps the newest `capacity` records.
+struct Config {
+  std::size_t capacity{1u << 16};
+  uint32_t    every{1};
+  uint64_t    slow_ticks{0};
+  uint32_t    context{16};
+};
+
+class Recorder {
+public:
+  explicit Recorder(const Config& cfg);
+  ~Recorder();
+  Recorder(const Recorder&) = delete;
+  Recorder& operator=(const Recorder&) = delete;
+
+  bool ok() const noexcept { return ring_ != nullptr; }
+
+  inline void record(const Record& r) noexcept {
+    ++offered_;
+    if (cfg_.slow_ticks == 0) {
+      if (++n_ < cfg_.every) return;
+      n_ = 0;
+      put(r);
+    } else if (r.mark[Encode] >= cfg_.slow_ticks) {
+      for (std::size_t k = ctx_len_; k > 0; --k) put(ctx_[(ctx_head_ + cfg_.context - k) % cfg_.context]);
+      ctx_len_ = 0;
+      put(r).flags |= kSlow;
+      post_ = cfg_.context;
+      ++slow_;
+    } else if (post_ > 0) {
+      --post_;
+      put(r);
+    } else if (cfg_.context > 0) {
+      ctx_[ctx_head_] = r;
+      ctx_head_ = ctx_head_ + 1 == cfg_.context ? 0 : ctx_head_ + 1;
+      if (ctx_len_ < cfg_.context) ++ctx_len_;
+    }
+  }
+
+  std::size_t records() const noexcept { return kept_ < cfg_.capacity ? kept_ : cfg_.capacity; }
+  uint64_t    slow()    const noexcept { return slow_; }
+  uint64_t    offered() const noexcept { return offered_; }
+
+  // Header + records, oldest first. false (with *err) on I/O errors.
+  bool flush(const std::string& path, double ns_per_tick, std::string* err) const;
+
+private:
+  inline Record& put(const Record& r) noexcept {
+    Record& slot = ring_[kept_++ % cfg_.capacity];
+    slot = r;
+    return slot;
+  }
+
+  Config      cfg_;
+  Record*     ring_{nullptr};      // capacity records, then context records
+  Record*     ctx_{nullptr};
+  std::size_t bytes_{0};
+  uint64_t    kept_{0}, offered_{0}, slow_{0};
+  uint32_t    n_{0}, post_{0};
+  uint32_t    ctx_head_{0}, ctx_len_{0};
+};
+
+// Read a trace file back. false (with *err) if it is not one or is short.
+bool load(const std::string& path, Header& h, std::vector<Record>& out, std::string* err);
+
+} // namespace t2t::trace
@@ -0,0 +1,93 @@
+#include "tsc.h"
+#include <algorithm>
+#include <ctime>
+#include <vector>
+
+#if T2T_HAVE_TSC
+  #include <cpuid.h>
+#endif
+
+namespace t2t::tsc {
+
+namespace detail {
+bool   use_tsc = false;
+double ns_per_tick = 1.0;
+} // namespace detail
+
+namespace {
+
+Info g_info;
+bool g_init = false;
+
+uint64_t raw_ns() noexcept {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000u + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+#if T2T_HAVE_TSC
+// CPUID.80000007H:EDX[8]: TSC ticks at a constant rate across P/C-states.
+bool invariant_tsc() noexcept {
+  unsigned a = 0, b = 0, c = 0, d = 0;
+  if (__get_cpuid_max(0x80000000u, nullptr) < 0x80000007u) return false;
+  if (!__get_cpuid(0x80000007u, &a, &b, &c, &d)) return false;
+  return (d & (1u << 8)) != 0;
+}
+
+// One (tsc, ns) pair: the clock_gettime call bracketed by the two TSC reads
+// that are closest together out of a few tries, tsc taken as their midpoint.
+void paired_read(uint64_t& tsc, uint64_t& ns) noexcept {
+  uint64_t best = UINT64_MAX;
+  for (int i = 0; i < 16; ++i) {
+    const uint64_t t0 = start();
+    const uint64_t n  = raw_ns();
+    const uint64_t t1 = stop();
+    if (t1 - t0 < best) { best = t1 - t0; tsc = t0 + (t1 - t0) / 2; ns = n; }
+  }
+}
+#endif
+
+double measure_overhead_ns() {
+  constexpr int N = 10'001;
+  std::vector<uint64_t> d(N);
+  for (auto& x : d) {
+    const uint64_t t0 = start();
+    x = stop() - t0;
+  }
+  std::nth_element(d.begin(), d.begin() + N / 2, d.end());
+  return static_cast<double>(d[N / 2]) * detail::ns_per_tick;
+}
+
+} // namespace
+
+const Info& init(bool allow_tsc, int calib_ms) {
+  if (g_init) return g_info;
+  g_init = true;
+#if T2T_HAVE_TSC
+  g_info.invariant = invariant_tsc();
+  if (allow_tsc && g_info.invariant) {
+    detail::use_tsc = true;        // start()/stop() read the TSC from here on
+    uint64_t tsc0 = 0, ns0 = 0, tsc1 = 0, ns1 = 0;
+    paired_read(tsc0, ns0);
+    const uint64_t until = ns0 + static_cast<uint64_t>(std::max(calib_ms, 1)) * 1'000'000u;
+    while (raw_ns() < until) {}
+    paired_read(tsc1, ns1);
+    if (tsc1 > tsc0 && ns1 > ns0) {
+      detail::ns_per_tick = static_cast<double>(ns1 - ns0) / static_cast<double>(tsc1 - tsc0);
+      g_info.tsc = true;
+      g_info.ghz = 1.0 / detail::ns_per_tick;
+      g_info.ns_per_tick = detail::ns_per_tick;
+    } else {
+      detail::use_tsc = false;     // went backwards or did not move: unusable
+    }
+  }
+#else
+  (void)allow_tsc; (void)calib_ms;
+#endif
+  g_info.overhead_ns = measure_overhead_ns();
+  return g_info;
+}
+
+const Info& info() noexcept { return g_info; }
+
+} // namespace t2t::tsc
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define T2T_HAVE_TSC 1
+#else
+  #define T2T_HAVE_TSC 0
+#endif
+
+namespace t2t::tsc {
+
+// Cycle clock for stage timing. start()/stop() return raw ticks: TSC cycles
+// once init() has found an invariant TSC and calibrated it, steady_clock ns
+// otherwise (before init(), on other ISAs, or when the TSC is unusable).
+// Samples stay in ticks on the hot path; to_ns() converts at report time.
+//
+// start() is lfence; rdtsc (earlier work must finish before the read) and
+// stop() is rdtscp; lfence (the read waits for the timed work, later work
+// waits for the read), so the pair brackets exactly the code between them.
+struct Info {
+  bool   tsc{false};          // ticks are TSC cycles
+  bool   invariant{false};    // CPUID reports an invariant TSC
+  double ghz{0.0};            // calibrated TSC rate (0 if unused)
+  double ns_per_tick{1.0};
+  double overhead_ns{0.0};    // median back-to-back start() -> stop()
+};
+
+namespace detail {
+extern bool   use_tsc;
+extern double ns_per_tick;
+inline uint64_t steady_ns() noexcept {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+} // namespace detail
+
+// Call once at startup, before any thread takes samples; later calls return
+// the first result. allow_tsc = false forces the steady_clock fallback.
+// Calibration spins for about calib_ms against CLOCK_MONOTONIC_RAW.
+const Info& init(bool allow_tsc = true, int calib_ms = 20);
+const Info& info() noexcept;
+
+inline uint64_t start() noexcept {
+#if T2T_HAVE_TSC
+  if (detail::use_tsc) [[likely]] {
+    _mm_lfence();
+    return __rdtsc();
+  }
+#endif
+  return detail::steady_ns();
+}
+
+inline uint64_t stop() noexcept {
+#if T2T_HAVE_TSC
+  if (detail::use_tsc) [[likely]] {
+    unsigned aux;
+    const uint64_t t = __rdtscp(&aux);
+    _mm_lfence();
+    return t;
+  }
+#endif
+  return detail::steady_ns();
+}
+
+inline uint64_t to_ns(uint64_t ticks) noexcept {
+  return detail::use_tsc ? static_cast<uint64_t>(static_cast<double>(ticks) * detail::ns_per_tick + 0.5)
+                         : ticks;
+}
+
+} // namespace t2t::tsc
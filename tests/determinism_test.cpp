@@ -43,10 +43,12 @@ static std::string run_once(const std::string& path_csv) {
       book.add({ev.ts_ns, ev.order_id, ev.px, ev.qty, ev.side});
     } else if (ev.type == itch::EvType('C')) {
       book.cancel(ev.order_id); mm.on_cancel();
+    } else if (ev.type == itch::EvType('X')) {
+      book.reduce(ev.order_id, ev.qty); mm.on_cancel();
     } else {
       mm.on_exec();
-      pnl.on_exec(ev.px, ev.qty, !ev.side);
-      book.cancel(ev.order_id);
+      lob::Fill f;
+      if (book.execute(ev.order_id, ev.qty, &f) > 0) pnl.on_exec(f.px, f.qty, !f.is_buy);
     }
 
     // Heuristic quote only (determinism independent of stochastic layer)
@@ -70,6 +72,7 @@ void run_determinism_tests() {
     ofs << "2,A,2,0,101,3\n";
     ofs << "3,E,1,1,100,1\n";
     ofs << "4,C,2,0,0,0\n";
+    ofs << "5,X,1,1,100,1\n";
     ofs << "5,A,3,1,101,1\n";
   }
 
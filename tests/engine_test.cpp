@@ -0,0 +1,185 @@
+#include "tests/test_util.h"
+#include "libengine/batch.h"
+#include "libengine/sharded.h"
+#include "libitch/itch5.h"
+#include "librisk/risk.h"
+#include <algorithm>
+#include <cstdio>
+#include <span>
+#include <vector>
+
+using namespace t2t;
+
+namespace {
+
+// Interleaved adds/execs/cancels on a few symbols.
+std::vector<itch::Event> make_feed(size_t n, uint16_t symbols) {
+  std::vector<itch::Event> ev;
+  uint32_t id = 1;
+  for (size_t i = 0; i < n; ++i) {
+    itch::Event e{};
+    e.ts_ns  = 1'000 * i;
+    e.locate = static_cast<uint16_t>((i * 7) % symbols);
+    const size_t phase = i % 5;
+    e.side   = (i & 1) != 0;
+    e.px     = 1'000 * (e.locate + 1) + (e.side ? -1 : 1) * static_cast<int32_t>(1 + i % 9);
+    e.qty    = static_cast<int32_t>(1 + i % 4);
+    if (phase < 3) { e.type = itch::EvType::Add; e.order_id = id++; }
+    else { e.type = phase == 3 ? itch::EvType::Exec : itch::EvType::Cancel; e.order_id = id > 5 ? id - 5 : 1; }
+    ev.push_back(e);
+  }
+  return ev;
+}
+
+struct Run {
+  std::vector<engine::Decision> log;
+  engine::RiskTotals totals;
+  size_t books{0};
+};
+
+Run run(const std::vector<itch::Event>& feed, unsigned shards, bool kill = false) {
+  engine::Config cfg;
+  cfg.shards = shards;
+  cfg.ring_size = 64;             // small ring: the dispatcher waits for space
+  cfg.book = lob::BookSpec{1024, 256};
+  cfg.log_capacity = feed.size();
+  engine::ShardedEngine eng(cfg);
+  if (kill) eng.kill();
+  eng.start();
+  for (const auto& e : feed) eng.dispatch(e);
+  eng.finish();
+  Run r;
+  eng.for_each_decision([&](const engine::Decision& d) { r.log.push_back(d); });
+  r.totals = eng.totals();
+  for (unsigned k = 0; k < eng.shards(); ++k) r.books += eng.books(k).size();
+  return r;
+}
+
+bool same_decision(const engine::Decision& a, const engine::Decision& b) {
+  return a.seq == b.seq && a.ts_ns == b.ts_ns && a.locate == b.locate && a.allowed == b.allowed &&
+         a.q.bid_px == b.q.bid_px && a.q.ask_px == b.q.ask_px && a.inv == b.inv && a.pnl == b.pnl;
+}
+
+} // namespace
+
+extern void run_engine_tests() {
+  const auto feed = make_feed(3000, 5);
+  const Run one = run(feed, 1);
+  T2T_CHECK(one.log.size() == feed.size());
+  T2T_CHECK(one.books == 5 && one.totals.instruments == 5 && one.totals.events == feed.size());
+  for (size_t i = 0; i < one.log.size(); ++i) T2T_CHECK(one.log[i].seq == i);
+
+  // Merged decisions do not depend on the shard count
+  for (const unsigned S : {2u, 3u, 8u}) {
+    const Run r = run(feed, S);
+    T2T_CHECK(r.log.size() == one.log.size() && r.books == 5);
+    bool same = true;
+    for (size_t i = 0; i < r.log.size() && i < one.log.size(); ++i) same = same && same_decision(r.log[i], one.log[i]);
+    T2T_CHECK(same);
+    T2T_CHECK(r.totals.net_inv == one.totals.net_inv && r.totals.quotes == one.totals.quotes);
+  }
+
+  // A symbol alone gets the same decisions as inside the mixed feed
+  std::vector<itch::Event> solo;
+  for (const auto& e : feed) if (e.locate == 3) solo.push_back(e);
+  const Run s = run(solo, 1);
+  size_t j = 0; bool match = true;
+  for (const auto& d : one.log) {
+    if (d.locate != 3) continue;
+    const auto& x = s.log[j++];
+    match = match && x.allowed == d.allowed && x.q.bid_px == d.q.bid_px && x.inv == d.inv && x.pnl == d.pnl;
+  }
+  T2T_CHECK(match && j == s.log.size());
+
+  // Aggregate view: net inventory is the sum of the last inventory per symbol
+  int64_t net = 0;
+  std::vector<int32_t> last(5, 0);
+  for (const auto& d : one.log) last[d.locate] = d.inv;
+  for (const int32_t v : last) net += v;
+  T2T_CHECK(one.totals.net_inv == net);
+
+  // kill() stops all quoting
+  const Run k = run(feed, 2, /*kill=*/true);
+  T2T_CHECK(k.totals.quotes == 0 && k.totals.events == feed.size());
+
+  // A log shorter than its shard's share stops recording and reports what
+  // it lost; sized from shard_of() it loses nothing
+  {
+    engine::Config cfg;
+    cfg.shards = 2;
+    cfg.ring_size = 64;
+    cfg.book = lob::BookSpec{1024, 256};
+    cfg.log_capacity = 100;
+    engine::ShardedEngine eng(cfg);
+    std::vector<size_t> share(2, 0);
+    for (const auto& e : feed) ++share[eng.shard_of(e.locate)];
+    eng.reserve_log(1, share[1]);
+    eng.start();
+    for (const auto& e : feed) eng.dispatch(e);
+    eng.finish();
+    size_t logged = 0;
+    eng.for_each_decision([&](const engine::Decision&) { ++logged; });
+    T2T_CHECK(share[0] > 100 && eng.log_dropped(0) == share[0] - 100 && eng.log_dropped(1) == 0);
+    T2T_CHECK(logged == 100 + share[1]);
+  }
+
+  // apply_batch: same book states, callback order and book creation as one
+  // apply() per event, for any batch size and lookahead
+  auto tops = [&](size_t batch, size_t ahead) {
+    lob::BookManager books(lob::BookSpec{1024, 256});
+    std::vector<int64_t> seen;
+    for (size_t i = 0; i < feed.size(); i += batch) {
+      const size_t n = std::min(batch, feed.size() - i);
+      engine::apply_batch(books, std::span<const itch::Event>(feed.data() + i, n),
+                          [&](const itch::Event& e, const lob::Lob& b, const lob::Fill&) {
+        seen.push_back((static_cast<int64_t>(e.locate) << 48) ^ (static_cast<int64_t>(b.best_bid()) << 20) ^ b.best_ask());
+      }, ahead);
+    }
+    return seen;
+  };
+  lob::BookManager ref_books(lob::BookSpec{1024, 256});
+  std::vector<int64_t> ref;
+  for (const auto& e : feed) {
+    lob::Lob& b = engine::book_for(ref_books, e.locate);
+    engine::apply(b, e);
+    ref.push_back((static_cast<int64_t>(e.locate) << 48) ^ (static_cast<int64_t>(b.best_bid()) << 20) ^ b.best_ask());
+  }
+  T2T_CHECK(tops(64, 4) == ref && tops(7, 0) == ref && tops(feed.size(), 16) == ref && tops(1, 2) == ref);
+
+  // ITCH E carries neither side nor price, C only its print price: fills
+  // are booked at the resting order's side, at its price for E and the
+  // message's for C, and only for the shares the book actually had
+  std::vector<uint8_t> buf;
+  itch::itch5::append(buf, itch::Event{1, itch::EvType::Add, 4, 1, true,  10'000, 5, 0}, itch::itch5::Framing::Raw);
+  itch::itch5::append(buf, itch::Event{2, itch::EvType::Add, 4, 2, false, 10'010, 7, 0}, itch::itch5::Framing::Raw);
+  itch::itch5::append(buf, itch::Event{3, itch::EvType::Exec, 4, 1, false, 0, 2, 0}, itch::itch5::Framing::Raw);
+  const uint8_t exec_c[36] = {
+    'C', 0x00,0x04, 0,0, 0,0,0,0,0,4,          // locate 4, ts 4
+    0,0,0,0,0,0,0,2, 0,0,0,3,                  // order ref 2, 3 shares
+    0,0,0,0,0,0,0,1, 'Y', 0x00,0x00,0x27,0x18 };  // match no., printable, price 10008
+  buf.insert(buf.end(), exec_c, exec_c + sizeof(exec_c));
+  itch::itch5::append(buf, itch::Event{5, itch::EvType::Exec, 4, 1,  false, 0, 10, 0}, itch::itch5::Framing::Raw);  // 3 left
+  itch::itch5::append(buf, itch::Event{6, itch::EvType::Exec, 4, 99, false, 0, 1,  0}, itch::itch5::Framing::Raw);  // unknown
+  const char* path = "/tmp/t2t_engine_exec.bin";
+  if (FILE* f = std::fopen(path, "wb")) { std::fwrite(buf.data(), 1, buf.size(), f); std::fclose(f); }
+  itch::Itch5File file; std::string err;
+  T2T_CHECK(file.open(path, itch::itch5::Framing::Raw, &err));
+  std::vector<itch::Event> execs;
+  itch::Itch5Cursor cur = file.cursor();
+  for (itch::Event e{}; cur.next(e); ) execs.push_back(e);
+  T2T_CHECK(execs.size() == 6 && !execs[2].side && execs[2].px == 0 && execs[3].px == 10'008);
+
+  lob::Lob xb(64, 256);
+  risk::PnL pnl;
+  for (const auto& e : execs) {
+    lob::Fill f;
+    engine::apply(xb, e, &f);
+    if (f.qty > 0) pnl.on_exec(f.px, f.qty, !f.is_buy);
+  }
+  const int    want_inv = -2 + 3 - 3;                            // sold to bid 1, bought from ask 2
+  const double want_pnl = 2.0 * 10'000 - 3.0 * 10'008 + 3.0 * 10'000;
+  T2T_CHECK(pnl.inv == want_inv && pnl.pnl == want_pnl && xb.live_orders() == 1);
+  const Run xr = run(execs, 2);
+  T2T_CHECK(xr.totals.net_inv == want_inv && xr.totals.pnl == want_pnl && xr.log.back().inv == want_inv);
+  std::remove(path);
+}
@@ -0,0 +1,52 @@
+#include "tests/test_util.h"
+#include "liblob/flat_map.h"
+#include <cstdint>
+#include <vector>
+
+using t2t::lob::FlatMap;
+
+void run_flat_map_tests() {
+  // Basic put / get / overwrite / erase
+  FlatMap<uint32_t, int> m(8, 0.5);
+  T2T_CHECK(m.capacity() == 16 && m.max_items() == 8);
+  T2T_CHECK(m.get(1, -1) == -1);
+  T2T_CHECK(m.put(1, 10) && m.put(2, 20));
+  T2T_CHECK(m.put(1, 11));              // overwrite, size unchanged
+  T2T_CHECK(m.size() == 2 && m.get(1, -1) == 11 && m.get(2, -1) == 20);
+  T2T_CHECK(m.erase(1) && !m.erase(1));
+  T2T_CHECK(m.get(1, -1) == -1 && m.size() == 1);
+
+  // Capacity check: the 9th distinct key is refused, not silently dropped
+  m.clear();
+  for (uint32_t k = 100; k < 108; ++k) T2T_CHECK(m.put(k, static_cast<int>(k)));
+  T2T_CHECK(!m.put(999, 1));
+  T2T_CHECK(m.put(100, 7));             // overwriting an existing key still works
+  T2T_CHECK(m.size() == 8);
+
+  // Colliding keys: erase from the middle of a probe chain must not orphan
+  // later keys (backward shift, no tombstones).
+  FlatMap<uint32_t, int> c(8, 0.5);
+  std::vector<uint32_t> same;
+  for (uint32_t k = 1; same.size() < 4; ++k) {
+    if (c.home(k) == c.home(1)) same.push_back(k);
+  }
+  for (size_t i = 0; i < same.size(); ++i) T2T_CHECK(c.put(same[i], static_cast<int>(i)));
+  auto st = c.probe_stats();
+  T2T_CHECK(st.size == 4 && st.max_probe == 3);
+  T2T_CHECK(c.erase(same[1]));
+  T2T_CHECK(c.get(same[0], -1) == 0);
+  T2T_CHECK(c.get(same[2], -1) == 2);
+  T2T_CHECK(c.get(same[3], -1) == 3);
+  st = c.probe_stats();
+  T2T_CHECK(st.max_probe == 2);
+
+  // Dense ids under churn: every live key stays reachable
+  FlatMap<uint32_t, int> d(1024, 0.75);
+  for (uint32_t k = 1; k <= 50'000; ++k) {
+    T2T_CHECK(d.put(k, static_cast<int>(k)));
+    if (k > 512) T2T_CHECK(d.erase(k - 512));
+  }
+  bool all = d.size() == 512;
+  for (uint32_t k = 50'000 - 511; k <= 50'000; ++k) all = all && d.get(k, -1) == static_cast<int>(k);
+  T2T_CHECK(all);
+}
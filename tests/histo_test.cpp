@@ -0,0 +1,58 @@
+#include "tests/test_util.h"
+#include "libutil/histo.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using t2t::histo::LogHisto;
+
+extern void run_histo_tests() {
+  // Small values are exact; empty histogram reports zeros
+  LogHisto h(4, 20);
+  T2T_CHECK(h.count()==0 && h.quantile(0.5)==0 && h.min()==0 && h.max()==0);
+  for (uint64_t v = 0; v < 16; ++v) h.record(v);
+  T2T_CHECK(h.count()==16 && h.min()==0 && h.max()==15);
+  T2T_CHECK(h.quantile(0.0)==0 && h.quantile(0.5)==7 && h.quantile(1.0)==15);
+
+  // Buckets tile the range: contiguous, in order, each within 2^-(sub_bits-1)
+  uint64_t next = 0; bool tiled = true;
+  LogHisto all(4, 12);
+  for (uint64_t v = 0; v < 4096; ++v) all.record(v);
+  all.for_each([&](uint64_t lo, uint64_t hi, uint64_t c) {
+    tiled = tiled && lo == next && hi >= lo && c == hi - lo + 1 && (lo < 16 || (hi - lo + 1) * 8 <= lo);
+    next = hi + 1;
+  });
+  T2T_CHECK(tiled && next == 4096);
+
+  // Out-of-range values clamp into the top bucket; max stays exact
+  h.record(uint64_t{1} << 40);
+  T2T_CHECK(h.max()==(uint64_t{1} << 40) && h.quantile(1.0)==(uint64_t{1} << 40));
+
+  // Quantiles of a heavy-tailed sample agree with the sorted samples within
+  // the bucket precision
+  std::mt19937_64 mt(5);
+  std::lognormal_distribution<double> dist(7.0, 1.2);
+  std::vector<uint64_t> v(200'000);
+  LogHisto a, b;
+  for (size_t i = 0; i < v.size(); ++i) {
+    v[i] = static_cast<uint64_t>(dist(mt));
+    (i & 1 ? a : b).record(v[i]);
+  }
+  T2T_CHECK(a.merge(b) && a.count()==v.size());
+  std::sort(v.begin(), v.end());
+  bool close = true;
+  for (const double q : {0.5, 0.9, 0.99, 0.999, 0.9999}) {
+    const double exact = static_cast<double>(v[static_cast<size_t>(std::ceil(q * static_cast<double>(v.size()))) - 1]);
+    const double got   = static_cast<double>(a.quantile(q));
+    close = close && std::fabs(got - exact) <= exact / 256.0 + 1.0;
+  }
+  T2T_CHECK(close && a.min()==v.front() && a.max()==v.back());
+
+  // Layouts must match to merge; reset empties
+  LogHisto other(6);
+  T2T_CHECK(!a.merge(other) && a.count()==v.size());
+  a.reset();
+  T2T_CHECK(a.count()==0 && a.quantile(0.99)==0 && a.mean()==0.0);
+}
@@ -1,6 +1,12 @@
 #include "libitch/itch.h"
+#include "libitch/csv_cursor.h"
+#include "libitch/itch5.h"
+#include "libitch/symbols.h"
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #ifndef T2T_CHECK
 #define T2T_CHECK(x) do { if(!(x)) *(volatile int*)0=0; } while(0)
@@ -8,6 +14,245 @@
 
 using namespace t2t::itch;
 
+static bool same_event(const Event& a, const Event& b) {
+  return a.ts_ns == b.ts_ns && a.type == b.type && a.locate == b.locate && a.order_id == b.order_id &&
+         a.side == b.side && a.px == b.px && a.qty == b.qty && a.new_id == b.new_id;
+}
+
+static void write_bytes(const char* path, const std::vector<uint8_t>& buf) {
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  ofs.write(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(buf.size()));
+}
+
+static bool load_text(const char* text, size_t max_msgs, Replay& r, std::string& err) {
+  const char* path = "/tmp/t2t_itch_edge.csv";
+  { std::ofstream ofs(path, std::ios::binary | std::ios::trunc); ofs << text; }
+  err.clear();
+  return r.load_csv(path, max_msgs, &err);
+}
+
+// mmap/SIMD loader edge cases; expectations are those of the original
+// getline + from_chars loader.
+static void run_csv_edge_tests() {
+  Replay r; std::string err;
+
+  // No header, no trailing newline; last field ends at the mapping's end
+  T2T_CHECK(load_text("1,A,7,1,100,5\n2,C,7,1,0,0", 0, r, err));
+  T2T_CHECK(r.events.size() == 2 && r.events[1].type == EvType::Cancel && r.events[1].qty == 0);
+
+  // CRLF rows parse (from_chars stops at '\r'), extra columns are ignored,
+  // an empty type column means Add, wide and negative numbers go the slow path
+  T2T_CHECK(load_text("ts_ns,type,order_id,side,px,qty\r\n"
+                      "1234567890123456789,,4294967295,s,-42,7\r\n"
+                      "000000012,E,0012,b,100,3,extra,cols\n", 0, r, err));
+  T2T_CHECK(r.events.size() == 2);
+  T2T_CHECK(r.events[0].ts_ns == 1234567890123456789ull && r.events[0].type == EvType::Add);
+  T2T_CHECK(r.events[0].order_id == 4294967295u && !r.events[0].side && r.events[0].px == -42 && r.events[0].qty == 7);
+  T2T_CHECK(r.events[1].ts_ns == 12 && r.events[1].order_id == 12 && r.events[1].side && r.events[1].qty == 3);
+
+  // Errors carry the offending line
+  T2T_CHECK(!load_text("1,A,1,1,100,5\n\n2,A,2,1,100,5\n", 0, r, err));
+  T2T_CHECK(err == "parse error: " && r.events.size() == 1);
+  T2T_CHECK(!load_text("1,A,1,1,100\n", 0, r, err));
+  T2T_CHECK(err == "parse error: 1,A,1,1,100");
+  T2T_CHECK(!load_text("1,A,4294967296,1,100,5\n", 0, r, err));   // id overflows u32
+  T2T_CHECK(err == "parse error: 1,A,4294967296,1,100,5");
+  T2T_CHECK(!load_text("1,A,1,x,100,5", 0, r, err));
+  T2T_CHECK(err == "parse error: 1,A,1,x,100,5");
+  T2T_CHECK(!load_text("1,A,1,1,100,5\n2,X,1,1,0,2\n3,U,1,1,101,5\n", 0, r, err));   // no new_id column
+  T2T_CHECK(err == "parse error: 3,U,1,1,101,5" && r.events.size() == 2 && r.events[1].type == EvType::Reduce);
+
+  // Locate column only when the header names it; then it is required
+  T2T_CHECK(load_text("ts_ns,type,order_id,side,px,qty,locate\r\n"
+                      "1,A,1,1,100,5,7\r\n2,A,2,0,101,5,65535,x\n", 0, r, err));
+  T2T_CHECK(r.events.size() == 2 && r.events[0].locate == 7 && r.events[1].locate == 65535);
+  T2T_CHECK(load_text("ts_ns,type,order_id,side,px,qty\n1,A,1,1,100,5,7\n", 0, r, err));
+  T2T_CHECK(r.events.size() == 1 && r.events[0].locate == 0);
+  T2T_CHECK(!load_text("ts_ns,type,order_id,side,px,qty,locate\n1,A,1,1,100,5\n", 0, r, err));
+  T2T_CHECK(err == "parse error: 1,A,1,1,100,5");
+  T2T_CHECK(!load_text("ts_ns,type,order_id,side,px,qty,locate\n1,A,1,1,100,5,65536\n", 0, r, err));
+
+  // max_msgs stops before a later bad row is looked at; header-only is empty
+  T2T_CHECK(load_text("1,A,1,1,100,5\n2,A,2,1,100,5\nbad\n", 2, r, err));
+  T2T_CHECK(r.events.size() == 2);
+  T2T_CHECK(load_text("ts_ns,type,order_id,side,px,qty\n", 0, r, err) && r.events.empty());
+  T2T_CHECK(load_text("", 0, r, err) && r.events.empty());
+  T2T_CHECK(!r.load_csv("/tmp/t2t_no_such_file.csv", 0, &err));
+  T2T_CHECK(err == "cannot open: /tmp/t2t_no_such_file.csv");
+}
+
+// Binary ITCH 5.0: hand-built bytes, then encode -> file -> mmap -> decode.
+static void run_itch5_tests() {
+  // 'A' Add Order, laid out by hand (big-endian)
+  const uint8_t add[36] = {
+    'A', 0x00,0x07, 0x00,0x00,                 // locate, tracking
+    0x00,0x01, 0x02,0x03,0x04,0x05,            // ts = 0x0001'02030405
+    0,0,0,0, 0x00,0x01,0xE2,0x40,              // order ref = 123456
+    'S', 0x00,0x00,0x01,0x2C,                  // side, shares = 300
+    'A','A','P','L',' ',' ',' ',' ',
+    0x00,0x1E,0x84,0x80 };                     // price = 2000000 (200.0000)
+  Event ev{};
+  T2T_CHECK(itch5::msg_len('A') == 36 && itch5::msg_len('Z') == 0);
+  T2T_CHECK(itch5::decode(add, sizeof(add), ev));
+  T2T_CHECK(ev.type == EvType::Add && ev.ts_ns == 0x000102030405ull && ev.locate == 7);
+  T2T_CHECK(ev.order_id == 123456 && ev.side == false && ev.qty == 300 && ev.px == 2'000'000);
+  T2T_CHECK(!itch5::decode(add, 20, ev));    // too short
+
+  const std::vector<Event> evs = {
+    {100, EvType::Add,     1,   1, true,  10'000, 5, 0},
+    {110, EvType::Add,     513, 2, false, 10'002, 7, 0},
+    {120, EvType::Exec,    1,   1, false, 0,      2, 0},
+    {130, EvType::Reduce,  513, 2, false, 0,      3, 0},   // X: partial cancel
+    {140, EvType::Replace, 1,   1, false, 10'001, 4, 9},
+    {150, EvType::Cancel,  1,   9, false, 0,      0, 0},   // D: delete
+  };
+  const uint8_t sys_event[12] = {'S', 0,0, 0,0, 0,0,0,0,0,1, 'O'};
+
+  for (const auto framing : {itch5::Framing::Raw, itch5::Framing::LengthPrefixed}) {
+    std::vector<uint8_t> buf;
+    if (framing == itch5::Framing::LengthPrefixed) { buf.push_back(0); buf.push_back(12); }
+    for (uint8_t b : sys_event) buf.push_back(b); // skipped by next()
+    for (const auto& e : evs) itch5::append(buf, e, framing);
+
+    const char* path = "/tmp/t2t_itch5_demo.bin";
+    write_bytes(path, buf);
+
+    Itch5File f; std::string err;
+    T2T_CHECK(f.open(path, itch5::Framing::Auto, &err));
+    T2T_CHECK(f.framing() == framing);
+    T2T_CHECK(f.size() == buf.size());
+    T2T_CHECK(f.count_events() == evs.size());
+
+    Itch5Cursor c = f.cursor();
+    size_t n = 0; bool all = true;
+    while (c.next(ev)) { all = all && n < evs.size() && same_event(ev, evs[n]); ++n; }
+    T2T_CHECK(all && n == evs.size() && !c.error());
+
+    // Truncated tail is reported, everything before it still decodes
+    buf.resize(buf.size() - 5);
+    write_bytes(path, buf);
+    T2T_CHECK(f.open(path, framing, &err));
+    c = f.cursor(); n = 0;
+    while (c.next(ev)) ++n;
+    T2T_CHECK(n == evs.size() - 1 && c.error());
+  }
+
+  Itch5File missing; std::string err;
+  T2T_CHECK(!missing.open("/tmp/t2t_no_such_file.bin", itch5::Framing::Auto, &err) && !err.empty());
+}
+
+// Symbol directory: CSV sizing file, then ITCH 'R' messages.
+static void run_symbol_tests() {
+  const char* path = "/tmp/t2t_symbols.csv";
+  {
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs << "locate,symbol,max_orders,max_levels\r\n1,AAPL,50000,4096\r\n\n513,MSFT\n";
+  }
+  SymbolDirectory d; std::string err;
+  T2T_CHECK(d.load_csv(path, &err) && d.size() == 2);
+  const SymbolInfo* a = d.find(1);
+  T2T_CHECK(a && a->symbol == "AAPL" && a->max_orders == 50000 && a->max_levels == 4096);
+  const SymbolInfo* m = d.find(513);
+  T2T_CHECK(m && m->symbol == "MSFT" && m->max_orders == 0 && m->max_levels == 0);
+  T2T_CHECK(!d.find(2));
+
+  for (const char* bad : {"1,AAPL\n1,MSFT\n", "70000,AAPL\n", "1,\n", "1,AAPL,12x\n"}) {
+    { std::ofstream ofs(path, std::ios::binary | std::ios::trunc); ofs << bad; }
+    SymbolDirectory e;
+    T2T_CHECK(!e.load_csv(path, &err) && !err.empty());
+  }
+  SymbolDirectory none;
+  T2T_CHECK(!none.load_csv("/tmp/t2t_no_such_file.csv", &err) && none.find(0) == nullptr);
+
+  // 'R' Stock Directory: locate 2 / "IBM" new, locate 1 already known (kept),
+  // and an 'R' after the first order message is not read
+  auto dir_msg = [](uint16_t loc, const char* sym) {
+    std::vector<uint8_t> r(39, 0);
+    r[0] = 'R'; r[1] = static_cast<uint8_t>(loc >> 8); r[2] = static_cast<uint8_t>(loc);
+    std::memset(r.data() + 11, ' ', 8);
+    std::memcpy(r.data() + 11, sym, std::strlen(sym));
+    return r;
+  };
+  std::vector<uint8_t> buf;
+  for (const auto& r : {dir_msg(2, "IBM"), dir_msg(1, "ZZZZZZZZ")}) {
+    uint16_t loc; char sym[9];
+    T2T_CHECK(itch5::decode_directory(r.data(), r.size(), loc, sym));
+    for (uint8_t b : r) buf.push_back(b);
+  }
+  itch5::append(buf, Event{1, EvType::Add, 2, 1, true, 100, 1, 0}, itch5::Framing::Raw);
+  for (uint8_t b : dir_msg(3, "LATE")) buf.push_back(b);
+  write_bytes("/tmp/t2t_symbols.bin", buf);
+
+  Itch5File f;
+  T2T_CHECK(f.open("/tmp/t2t_symbols.bin", itch5::Framing::Raw, &err));
+  T2T_CHECK(d.load_itch5(f) == 1 && d.size() == 3);
+  T2T_CHECK(d.find(2) && d.find(2)->symbol == "IBM");
+  T2T_CHECK(d.find(1)->symbol == "AAPL" && !d.find(3));
+}
+
+static bool same_events(const std::vector<Event>& a, const std::vector<Event>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) if (!same_event(a[i], b[i])) return false;
+  return true;
+}
+
+// Parallel loader must match the serial one for every thread count, row cap
+// and error position (first error in file order wins; rows before it kept).
+static void run_csv_parallel_tests() {
+  const char* path = "/tmp/t2t_itch_par.csv";
+  const size_t rows = 5000, bad_row = 3217;
+  for (const bool with_bad : {false, true}) {
+    {
+      std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+      ofs << "ts_ns,type,order_id,side,px,qty\n";
+      for (size_t i = 0; i < rows; ++i) {
+        if (with_bad && (i == bad_row || i == rows - 10)) { ofs << i << ",A,x,1,1,1\n"; continue; }
+        ofs << (i * 7) << ',' << "ACE"[i % 3] << ',' << (i + 1) << ',' << (i & 1) << ','
+            << (10000 + static_cast<int>(i % 97) - 48) << ',' << (i % 5) << '\n';
+      }
+      ofs << "999999,A,1,B,1,2"; // no trailing newline
+    }
+    for (const size_t cap : {size_t{0}, size_t{1}, size_t{2500}, bad_row, bad_row + 1, rows + 1}) {
+      Replay ser; std::string serr;
+      const bool sok = ser.load_csv(path, cap, &serr);
+      for (const unsigned T : {1u, 2u, 3u, 7u, 64u}) {
+        Replay par; std::string perr;
+        Replay::LoadStats ls;
+        const bool pok = par.load_csv_parallel(path, cap, T, &perr, &ls);
+        T2T_CHECK(pok == sok);
+        T2T_CHECK(perr == serr);
+        T2T_CHECK(same_events(par.events, ser.events));
+        T2T_CHECK(ls.workers.size() == T);
+        size_t b = 0;
+        for (const auto& w : ls.workers) b += w.bytes;
+        T2T_CHECK(b > 0);
+      }
+    }
+
+    // Streaming cursor: same rows, same stop point and error text
+    Replay ser; std::string serr;
+    const bool sok = ser.load_csv(path, 0, &serr);
+    CsvCursor cc; std::string cerr;
+    T2T_CHECK(cc.open(path, &cerr));
+    T2T_CHECK(cc.count_rows() == rows + 1);
+    std::vector<Event> got;
+    Event ev{};
+    while (cc.next(ev)) got.push_back(ev);
+    T2T_CHECK(cc.error() == !sok);
+    T2T_CHECK(cc.error_message() == serr);
+    T2T_CHECK(same_events(got, ser.events));
+  }
+
+  // Tiny input with more workers than lines
+  {
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs << "1,A,1,1,100,1\n";
+  }
+  Replay par; std::string err;
+  T2T_CHECK(par.load_csv_parallel(path, 0, 8, &err) && par.events.size() == 1);
+  T2T_CHECK(!par.load_csv_parallel("/tmp/t2t_no_such_file.csv", 0, 4, &err) && !err.empty());
+}
+
 extern void run_itch_tests() {
   const char* path = "/tmp/t2t_itch_demo.csv";
   {
@@ -38,4 +283,9 @@ extern void run_itch_tests() {
   const auto& e = r.events[2];
   T2T_CHECK(e.type == EvType('E'));
   T2T_CHECK(e.side == false); // '0'/'S' -> sell
+
+  run_csv_edge_tests();
+  run_csv_parallel_tests();
+  run_itch5_tests();
+  run_symbol_tests();
 }
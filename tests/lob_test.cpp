@@ -1,4 +1,5 @@
 #include "tests/test_util.h"
+#include "liblob/book_manager.h"
 #include "liblob/lob.h"
 #include <climits>
 
@@ -33,4 +34,168 @@ extern void run_lob_tests() {
 
   // Ensure cancelling again is safe
   book.cancel(3);
+
+  // FIFO order within a level survives mid-queue cancels and freed-slot
+  // reuse; replace keeps the original timestamp
+  Lob q(16, 64);
+  for (uint32_t i = 0; i < 4; ++i) q.add({100 + i, 10 + i, 500, 1, false});
+  q.cancel(11);
+  q.add({200, 20, 500, 1, false});          // reuses slot of 11, joins at the back
+  T2T_CHECK(q.replace(12, 30, 500, 1));     // 12 goes behind 20, ts stays 102
+  T2T_CHECK(!q.replace(99, 31, 500, 1));
+  // Aggressors 900.. lift one resting ask each; the last one is stamped
+  // before 30's inherited ts, so the fill reports the aggressor's id
+  uint32_t fill_id[4] = {};
+  for (uint32_t k = 0; k < 4; ++k) {
+    q.add({k < 3 ? 1'000u + k : 101u, 900 + k, 500, 1, true});
+    Exec f{};
+    T2T_CHECK(q.match_top(f) && f.px == 500 && f.qty == 1);
+    fill_id[k] = f.id;
+  }
+  T2T_CHECK(fill_id[0]==10 && fill_id[1]==13 && fill_id[2]==20 && fill_id[3]==903);
+  T2T_CHECK(q.best_ask()==INT32_MAX && q.best_bid()==INT32_MIN && q.live_orders()==0);
+
+  // In-place modifies: a partial execute or reduce keeps queue priority,
+  // taking the rest removes the order; a same-price replace goes to the back
+  // of its level, a new price moves the order to another level
+  Lob m(16, 64);
+  m.add({1, 1, 300, 5, true});
+  m.add({2, 2, 300, 5, true});
+  m.add({3, 3, 299, 4, true});
+  T2T_CHECK(m.execute(1, 2)==2 && m.reduce(1, 1)==1 && m.live_orders()==3);
+  T2T_CHECK(m.execute(77, 1)==0);                // unknown id
+  m.add({4, 50, 300, 1, false});
+  Exec me{};
+  T2T_CHECK(m.match_top(me) && me.qty==1);
+  T2T_CHECK(m.reduce(1, 5)==1 && m.best_bid()==300);     // 1 was still first; over-reduce takes the rest
+  T2T_CHECK(m.replace(2, 20, 300, 7) && m.best_bid()==300);
+  T2T_CHECK(m.reduce(20, 0)==7 && m.best_bid()==299 && m.live_orders()==1);
+  m.add({5, 4, 299, 1, true});
+  T2T_CHECK(m.replace(3, 30, 299, 2));            // same level, now behind 4
+  m.add({6, 51, 299, 3, false});
+  T2T_CHECK(m.match_top(me) && me.qty==1);        // 4 first
+  T2T_CHECK(m.match_top(me) && me.qty==2 && m.live_orders()==0);
+  m.add({7, 5, 298, 2, true});
+  T2T_CHECK(m.replace(5, 6, 310, 3) && m.best_bid()==310);
+  T2T_CHECK(m.replace(6, 7, 310, 0) && m.live_orders()==0);
+  T2T_CHECK(!m.replace(3, 31, 299, 1));           // old id is gone after a replace
+  T2T_CHECK(m.best_bid()==INT32_MIN && m.best_ask()==INT32_MAX);
+
+  // Sweep: an aggressive buy walks asks best-first, FIFO within a level,
+  // partially fills the last resting order and rests its remainder; a
+  // short fill buffer stops the sweep without resting anything
+  Lob sw(16, 64);
+  sw.add({1, 1, 101, 2, false});
+  sw.add({2, 2, 100, 3, false});
+  sw.add({3, 3, 100, 1, false});
+  sw.add({4, 4, 103, 5, false});
+  sw.add({5, 5, 99, 1, true});
+  Exec fb[8] = {};
+  Sweep r = sw.add_and_match({9, 10, 101, 7, true}, fb);
+  T2T_CHECK(r.fills==3 && r.filled==6 && r.rested==1);
+  T2T_CHECK(fb[0].id==2 && fb[0].px==100 && fb[0].qty==3 && fb[0].ts==9);
+  T2T_CHECK(fb[1].id==3 && fb[1].qty==1 && fb[2].id==1 && fb[2].px==101 && fb[2].qty==2);
+  T2T_CHECK(sw.best_bid()==101 && sw.best_ask()==103 && sw.live_orders()==3);
+  r = sw.add_and_match({10, 11, 99, 2, false}, fb);      // sell hits 10 then 5
+  T2T_CHECK(r.fills==2 && r.filled==2 && r.rested==0 && fb[0].id==10 && fb[1].id==5 && fb[1].px==99);
+  r = sw.add_and_match({11, 12, 102, 4, true}, fb);      // not marketable: rests whole
+  T2T_CHECK(r.fills==0 && r.rested==4 && sw.best_bid()==102);
+  sw.add({12, 13, 103, 1, false});
+  r = sw.add_and_match({13, 14, 110, 9, true}, std::span<Exec>(fb, 1));
+  T2T_CHECK(r.fills==1 && r.filled==5 && r.rested==0 && sw.best_ask()==103 && sw.best_bid()==102);
+  r = sw.add_and_match({14, 14, 110, 4, true}, fb);      // caller resubmits the rest
+  T2T_CHECK(r.fills==1 && fb[0].id==13 && r.rested==3 && sw.best_bid()==110 && sw.best_ask()==INT32_MAX);
+
+  // Direct id table: one lookup finds either side; ids outside its window
+  // spill to the hash maps and behave the same
+  Lob dt(64, 64, 4096);
+  T2T_CHECK(dt.id_window()==4096);
+  dt.add({1, 10, 700, 1, true});
+  dt.add({2, 11, 705, 2, false});
+  dt.add({3, 1'000'000, 701, 3, true});      // far outside: hashed
+  dt.add({4, 1'000'001, 704, 4, false});
+  T2T_CHECK(dt.live_orders()==4 && dt.hashed_ids()==2);
+  T2T_CHECK(dt.best_bid()==701 && dt.best_ask()==704);
+  dt.cancel(1'000'001); dt.cancel(10);
+  T2T_CHECK(dt.best_ask()==705 && dt.best_bid()==701 && dt.hashed_ids()==1);
+  T2T_CHECK(dt.replace(11, 12, 706, 2) && dt.best_ask()==706);
+  dt.cancel(11);                                // stale: idempotent
+  dt.reset();
+  T2T_CHECK(dt.live_orders()==0 && dt.hashed_ids()==0 && dt.best_ask()==INT32_MAX);
+
+  // Price ladder: prices far apart force the window to re-centre; best
+  // tracking must survive the shift and fall through emptied levels.
+  Lob wide;
+  wide.add({1, 100, 50'000, 1, true});
+  wide.add({2, 101, 20'000, 1, true});   // below the initial window
+  wide.add({3, 102, 75'000, 1, true});   // above it
+  T2T_CHECK(wide.best_bid()==75'000);
+  wide.cancel(102);
+  T2T_CHECK(wide.best_bid()==50'000);
+  wide.cancel(100);
+  T2T_CHECK(wide.best_bid()==20'000);
+  wide.add({4, 103, 20'001, 2, false});
+  wide.add({5, 104, 20'003, 2, false});
+  T2T_CHECK(wide.best_ask()==20'001);
+  wide.cancel(103);
+  T2T_CHECK(wide.best_ask()==20'003);
+  wide.cancel(101); wide.cancel(104);
+  T2T_CHECK(wide.best_bid()==INT32_MIN && wide.best_ask()==INT32_MAX);
+
+  // A price that cannot share the ladder window with the live levels is
+  // refused and counted, not dropped; a replace to such a price leaves the
+  // order as it was, queue position included
+  Lob nar(16, 64);
+  T2T_CHECK(nar.add({1, 1, 1'000, 1, true}) && nar.add({2, 2, 1'000, 1, true}) && nar.add({3, 3, 1'001, 1, true}));
+  T2T_CHECK(!nar.add({4, 4, 1'064, 1, true}) && nar.rejects().price==1 && nar.live_orders()==3);
+  T2T_CHECK(nar.add({5, 5, 1'063, 1, true}) && nar.best_bid()==1'063);   // still fits: re-centres
+  nar.cancel(5);
+  T2T_CHECK(!nar.replace(1, 10, 900, 2) && nar.rejects().price==2 && nar.live_orders()==3);
+  T2T_CHECK(!nar.replace(3, 11, 2'000, 1) && nar.best_bid()==1'001 && nar.rejects().price==3);   // sole order of its level
+  Exec nf[4] = {};
+  const Sweep ns = nar.add_and_match({6, 20, 1'000, 3, false}, nf);
+  T2T_CHECK(ns.fills==3 && nf[0].id==3 && nf[1].id==1 && nf[2].id==2 && nf[1].qty==1);
+  T2T_CHECK(nar.live_orders()==0 && nar.rejects().price==3);
+
+  // Instrument-sized book: a narrow ladder still re-centres, and a full
+  // pool refuses further adds instead of overrunning
+  Lob small(4, 64);
+  T2T_CHECK(small.max_orders()==4 && small.max_levels()==64);
+  for (uint32_t i = 0; i < 4; ++i) T2T_CHECK(small.add({i, 200 + i, 1'000 + static_cast<int32_t>(i) * 20, 1, true}));
+  T2T_CHECK(!small.add({4, 204, 1'010, 1, true}));   // pool holds 4: refused and counted
+  T2T_CHECK(small.rejects().capacity==1 && small.rejects().price==0 && small.best_bid()==1'060);
+  Exec sf[2] = {};
+  const Sweep full = small.add_and_match({5, 205, 1'070, 2, true}, sf);   // nothing to hit, cannot rest
+  T2T_CHECK(full.fills==0 && full.rested==0 && small.rejects().capacity==2);
+  small.cancel(203);
+  T2T_CHECK(small.best_bid()==1'040);
+
+  // reset() only walks live orders; the book then behaves as new, with or
+  // without prefaulted pools
+  T2T_CHECK(small.live_orders()==3);
+  small.reset();
+  T2T_CHECK(small.live_orders()==0 && small.best_bid()==INT32_MIN && small.best_ask()==INT32_MAX);
+  small.cancel(200);                      // stale id is gone
+  small.prefault();
+  for (uint32_t i = 0; i < 4; ++i) small.add({i, 200 + i, 5'000 - static_cast<int32_t>(i), 1, false});
+  T2T_CHECK(small.live_orders()==4 && small.best_ask()==4'997);
+  small.cancel(203);
+  T2T_CHECK(small.best_ask()==4'998);
+
+  // Book manager: books appear on first use with their own sizing and stay
+  // independent; dispatch is by locate
+  BookManager mgr(BookSpec{1024, 256});
+  mgr.set_spec(7, BookSpec{16, 128});
+  T2T_CHECK(mgr.size()==0 && mgr.find(7)==nullptr);
+  mgr.book(7).add({1, 1, 500, 1, true});
+  mgr.book(300).add({2, 1, 900, 1, false});
+  T2T_CHECK(mgr.size()==2 && mgr.locate_at(0)==7 && mgr.locate_at(1)==300);
+  T2T_CHECK(mgr.find(7)->max_orders()==16 && mgr.find(7)->max_levels()==128);
+  T2T_CHECK(mgr.find(300)->max_orders()==1024 && mgr.find(300)->max_levels()==256);
+  T2T_CHECK(mgr.find(7)->best_bid()==500 && mgr.find(7)->best_ask()==INT32_MAX);
+  T2T_CHECK(mgr.find(300)->best_ask()==900 && mgr.find(300)->best_bid()==INT32_MIN);
+  for (uint16_t loc = 1000; loc < 1040; ++loc) mgr.book(loc);   // growth keeps contents
+  T2T_CHECK(mgr.size()==42 && mgr.find(7)->best_bid()==500);
+  mgr.reset();
+  T2T_CHECK(mgr.size()==42 && mgr.find(7)->best_bid()==INT32_MIN);
 }
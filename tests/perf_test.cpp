@@ -0,0 +1,49 @@
+#include "tests/test_util.h"
+#include "libutil/perf_counters.h"
+#include <string>
+
+using namespace t2t;
+
+extern void run_perf_tests() {
+  // Per-event means take the snapshot cost off and never go negative
+  perf::StageCounts sc;
+  perf::Snapshot a, b, ovh;
+  b.v[perf::Cycles] = 1'000; b.v[perf::Instructions] = 2'500; b.v[perf::L1dMiss] = 3;
+  sc.add(a, b);
+  sc.add(b, b);
+  ovh.v[perf::Cycles] = 100; ovh.v[perf::L1dMiss] = 5;
+  T2T_CHECK(sc.events==2 && sc.sum[perf::Cycles]==1'000);
+  T2T_CHECK(sc.per_event(perf::Cycles, ovh)==400.0 && sc.per_event(perf::L1dMiss, ovh)==0.0);
+  T2T_CHECK(sc.ipc(ovh)==1'250.0 / 400.0 && perf::StageCounts{}.ipc(ovh)==0.0);
+  T2T_CHECK(std::string(perf::name(perf::DtlbMiss))=="dtlb_miss");
+
+  // Counters are optional: without a PMU (or with a restrictive
+  // perf_event_paranoid) open() says why and everything reads as zero;
+  // with one, counts move forward on this thread
+  perf::Group g;
+  std::string err;
+  if (!g.open(&err)) {
+    T2T_CHECK(!err.empty() && !g.ok() && !g.has(perf::Cycles));
+    perf::Snapshot s;
+    s.v[perf::Cycles] = 7;
+    g.read(s);
+    T2T_CHECK(s.v[perf::Cycles]==0 && g.running_fraction()==0.0);
+    perf::Sampler sp(1);
+    T2T_CHECK(!sp.open() && !sp.sample());
+  } else {
+    perf::Snapshot s0, s1;
+    g.read(s0);
+    volatile uint64_t x = 0;
+    for (int i = 0; i < 100'000; ++i) x = x + static_cast<uint64_t>(i);
+    g.read(s1);
+    T2T_CHECK(g.has(perf::Cycles) && s1.v[perf::Cycles] > s0.v[perf::Cycles]);
+    T2T_CHECK(!g.has(perf::Instructions) || s1.v[perf::Instructions] - s0.v[perf::Instructions] > 100'000u);
+    perf::Sampler sp(2, 1);
+    T2T_CHECK(sp.open());
+    perf::StageCounts st;
+    for (int i = 0; i < 5; ++i) if (sp.sample()) sp.charge(st);   // skip 1, then every 2nd
+    T2T_CHECK(st.events==2);
+  }
+  perf::Sampler off;   // every = 0: never opens
+  T2T_CHECK(!off.open() && !off.sample());
+}
@@ -1,9 +1,116 @@
 #include "tests/test_util.h"
+#include "libring/broadcast_ring.hpp"
 #include "libring/spsc_ring.hpp"
+#include "libring/wait_strategy.hpp"
+#include <chrono>
 #include <cstdint>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 using t2t::ring::SpscRing;
 
+// Producer/consumer transfer where both directions wait with policy W;
+// the producer pauses now and then so SpinPark actually parks.
+template <class W>
+static bool transfer_with(W& data, W& space, uint32_t total) {
+  SpscRing<uint32_t> q(1024);
+  std::thread prod([&] {
+    for (uint32_t i = 0; i < total; ++i) {
+      space.wait([&] { return q.try_push(i); });
+      data.notify();
+      if (i % 4096 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  });
+  bool ok = true;
+  for (uint32_t i = 0; i < total; ++i) {
+    uint32_t v = 0;
+    data.wait([&] { return q.try_pop(v); });
+    space.notify();
+    ok &= (v == i);
+  }
+  prod.join();
+  return ok;
+}
+
+static void run_wait_strategy_tests() {
+  using namespace t2t::ring;
+  { BusySpin a, b;  T2T_CHECK(transfer_with(a, b, 20000)); }
+  { PauseSpin a, b; T2T_CHECK(transfer_with(a, b, 20000)); }
+  { SpinYield a{100}, b{100}; T2T_CHECK(transfer_with(a, b, 20000)); }
+  { SpinPark a, b; a.spins = b.spins = 10; T2T_CHECK(transfer_with(a, b, 20000)); }
+  for (const char* name : {"spin", "pause", "yield", "park"}) {
+    WaitPolicy p{};
+    T2T_CHECK(parse_wait_policy(name, p));
+    T2T_CHECK(std::string_view(wait_policy_name(p)) == name);
+    Waiter a(p, 10), b(p, 10);
+    T2T_CHECK(transfer_with(a, b, 20000));
+  }
+  WaitPolicy p{};
+  T2T_CHECK(!parse_wait_policy("sleep", p));
+}
+
+static void run_broadcast_tests() {
+  using BR = t2t::ring::BroadcastRing<uint64_t>;
+
+  // Gating: every consumer sees every event; the slowest one blocks the producer
+  BR g(8, 3);
+  T2T_CHECK(g.add_consumer() == 0 && g.add_consumer() == 1 && g.add_consumer() == 2);
+  T2T_CHECK(g.add_consumer() == -1);
+  uint64_t v = 0;
+  T2T_CHECK(g.try_read(0, v) == BR::Read::Empty);
+  for (uint64_t i = 0; i < 8; ++i) T2T_CHECK(g.try_publish(i));
+  T2T_CHECK(!g.try_publish(8));
+  for (int c = 0; c < 2; ++c)
+    for (uint64_t i = 0; i < 8; ++i) T2T_CHECK(g.try_read(c, v) == BR::Read::Ok && v == i);
+  T2T_CHECK(!g.try_publish(8));                 // consumer 2 has not moved
+  T2T_CHECK(g.try_read(2, v) == BR::Read::Ok && v == 0);
+  T2T_CHECK(g.try_publish(8) && !g.try_publish(9));
+  T2T_CHECK(g.try_read(0, v) == BR::Read::Ok && v == 8);
+  T2T_CHECK(g.try_read(0, v) == BR::Read::Empty);
+
+  // Overwrite: producer never blocks; a lapped reader reports the loss and
+  // resumes in order half a ring behind
+  BR o(8, 1, BR::Policy::Overwrite);
+  T2T_CHECK(o.add_consumer() == 0);
+  for (uint64_t i = 0; i < 20; ++i) T2T_CHECK(o.try_publish(i));
+  T2T_CHECK(o.try_read(0, v) == BR::Read::Lagged);
+  T2T_CHECK(o.lost(0) == 16 && o.cursor(0) == 16);
+  for (uint64_t i = 16; i < 20; ++i) T2T_CHECK(o.try_read(0, v) == BR::Read::Ok && v == i);
+  T2T_CHECK(o.try_read(0, v) == BR::Read::Empty);
+
+  // Threads: gating consumers see the exact sequence; overwrite consumers see
+  // increasing, untorn values and account for every skipped event
+  struct Pair { uint64_t a, b; };
+  for (const bool overwrite : {false, true}) {
+    t2t::ring::BroadcastRing<Pair> r(64, 3, overwrite ? t2t::ring::BroadcastRing<Pair>::Policy::Overwrite
+                                                       : t2t::ring::BroadcastRing<Pair>::Policy::Gating);
+    for (int c = 0; c < 3; ++c) r.add_consumer();
+    const uint64_t total = 100000;
+    bool ok[3] = {true, true, true};
+    std::thread cons[3];
+    for (int c = 0; c < 3; ++c) {
+      cons[c] = std::thread([&, c] {
+        uint64_t expect = 0;
+        Pair p{};
+        while (expect < total) {
+          const auto rd = r.try_read(c, p);
+          if (rd == t2t::ring::BroadcastRing<Pair>::Read::Empty) { std::this_thread::yield(); continue; }
+          if (rd == t2t::ring::BroadcastRing<Pair>::Read::Lagged) { expect = r.cursor(c); continue; }
+          ok[c] &= (p.a == expect && p.b == ~expect);
+          ++expect;
+        }
+        if (!overwrite) ok[c] &= (r.lost(c) == 0);
+      });
+    }
+    for (uint64_t i = 0; i < total;) {
+      if (r.try_publish(Pair{i, ~i})) ++i; else std::this_thread::yield();
+    }
+    for (auto& t : cons) t.join();
+    T2T_CHECK(ok[0] && ok[1] && ok[2]);
+  }
+}
+
 // Define with external linkage (no 'extern' keyword on the definition)
 void run_ring_tests() {
   struct Item { uint32_t v; };
@@ -22,6 +129,74 @@ void run_ring_tests() {
   Item tmp{};
   for (uint32_t i=0;i<1000;++i) T2T_CHECK(r.try_pop(tmp));
 
-  // capacity
+  // capacity: every slot is usable
   T2T_CHECK(r.capacity() == 1024);
+  for (uint32_t i=0;i<1024;++i) T2T_CHECK(r.try_push(Item{i}));
+  T2T_CHECK(!r.try_push(Item{0}));
+  for (uint32_t i=0;i<1024;++i) { T2T_CHECK(r.try_pop(tmp)); T2T_CHECK(tmp.v == i); }
+  T2T_CHECK(!r.try_pop(tmp));
+
+  // batched push/pop across the wrap point, partial when full/empty
+  SpscRing<uint32_t> b(16);
+  uint32_t src[32], dst[32];
+  for (uint32_t i=0;i<32;++i) src[i] = 100 + i;
+  T2T_CHECK(b.try_push_n(src, 10) == 10);
+  T2T_CHECK(b.try_pop_n(dst, 10) == 10 && dst[9] == 109);
+  T2T_CHECK(b.try_push_n(src, 32) == 16);       // wraps, stops at capacity
+  T2T_CHECK(b.try_push_n(src, 1) == 0);
+  T2T_CHECK(b.try_pop_n(dst, 32) == 16);
+  bool in_order = true;
+  for (uint32_t i=0;i<16;++i) in_order &= (dst[i] == 100 + i);
+  T2T_CHECK(in_order);
+  T2T_CHECK(b.try_pop_n(dst, 4) == 0);
+
+  // reserve/commit and peek/release: spans stop at the wrap point
+  // (head and tail are at 26 == slot 10 here)
+  auto w = b.reserve(10);
+  T2T_CHECK(w.size() == 6);
+  for (size_t i=0;i<w.size();++i) w[i] = static_cast<uint32_t>(i);
+  b.commit(w.size());
+  w = b.reserve(10);
+  T2T_CHECK(w.size() == 10);
+  for (size_t i=0;i<w.size();++i) w[i] = static_cast<uint32_t>(6 + i);
+  b.commit(4);                                  // publish only part of it
+  auto rd = b.peek(100);
+  T2T_CHECK(rd.size() == 6 && rd[0] == 0 && rd[5] == 5);
+  b.release(6);
+  rd = b.peek(100);
+  T2T_CHECK(rd.size() == 4 && rd[3] == 9);
+  b.release(4);
+  T2T_CHECK(b.peek(1).empty());
+
+  // two threads, mixed single and batched operations: order preserved
+  SpscRing<uint32_t> q(64);
+  const uint32_t total = 200000;
+  std::thread prod([&] {
+    uint32_t next = 0, buf[7];
+    while (next < total) {
+      if (next % 3 == 0) { if (q.try_push(next)) ++next; else std::this_thread::yield(); continue; }
+      uint32_t k = 0;
+      for (; k < 7 && next + k < total; ++k) buf[k] = next + k;
+      const size_t n = q.try_push_n(buf, k);
+      next += static_cast<uint32_t>(n);
+      if (n == 0) std::this_thread::yield();
+    }
+  });
+  uint32_t expect = 0;
+  bool ok = true;
+  while (expect < total) {
+    auto sp = q.peek(5);
+    if (sp.empty()) {
+      uint32_t v = 0;
+      if (q.try_pop(v)) { ok &= (v == expect); ++expect; } else std::this_thread::yield();
+      continue;
+    }
+    for (uint32_t v : sp) { ok &= (v == expect); ++expect; }
+    q.release(sp.size());
+  }
+  prod.join();
+  T2T_CHECK(ok);
+
+  run_wait_strategy_tests();
+  run_broadcast_tests();
 }
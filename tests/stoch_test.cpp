@@ -4,6 +4,8 @@
 #include <random>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <cstddef>
 
 using namespace t2t;
 
@@ -22,6 +24,81 @@ void run_stoch_tests() {
   T2T_CHECK(std::isfinite(est.sigma) && est.sigma > 0.0 && est.sigma < 10.0);
   T2T_CHECK(std::fabs(est.theta - theta) < 25.0);
 
+  // --- Rolling OU parity with fit_ou on the same window ---
+  auto close = [](double u, double v) { return std::fabs(u - v) <= 1e-6 * (1.0 + std::fabs(v)); };
+  auto same  = [&](const stoch::OuParams& p, const stoch::OuParams& q) {
+    return close(p.kappa, q.kappa) && close(p.theta, q.theta) && close(p.sigma, q.sigma);
+  };
+  const uint64_t step_ns = 10'000'000; // dt = 0.01s
+  const size_t W = 256;
+  stoch::RollingOu roll(W), roll_off(W);
+  for (size_t t=0; t<x.size(); ++t) {
+    roll.push(t * step_ns, x[t]);
+    roll_off.push(t * step_ns, x[t] + 10'000.0); // centring keeps large mids exact
+    if (t == 99 || t == 300 || t == 777 || t + 1 == x.size()) {
+      const size_t n = std::min(t + 1, W);
+      const std::vector<double> win(x.begin() + static_cast<std::ptrdiff_t>(t + 1 - n),
+                                    x.begin() + static_cast<std::ptrdiff_t>(t + 1));
+      T2T_CHECK(roll.size() == n);
+      T2T_CHECK(close(roll.dt_s(), dt));
+      T2T_CHECK(same(roll.params(dt), stoch::fit_ou(win, dt)));
+      T2T_CHECK(roll.last() == win.back());
+
+      const auto po = roll_off.params(dt), pr = roll.params(dt);
+      T2T_CHECK(close(po.kappa, pr.kappa) && close(po.sigma, pr.sigma));
+      T2T_CHECK(close(po.theta - 10'000.0, pr.theta));
+    }
+  }
+
+  // Long run with a drifting level far from the first sample: the shadow
+  // sums keep the window exact without any O(window) resync
+  {
+    const size_t Ws = 64;
+    stoch::RollingOu longrun(Ws);
+    std::vector<double> y(200'000);
+    double lvl = 1e6, dev = 0.0;
+    for (size_t t=0; t<y.size(); ++t) {
+      lvl += 0.05;                                    // drifts 1e4 over the run
+      dev += -kappa*dev*dt + sigma*std::sqrt(dt)*N(rng);
+      y[t] = lvl + dev;
+      longrun.push(t * step_ns, y[t]);
+    }
+    // Reference: fit_ou on the window shifted to near zero (it does not
+    // centre, so at 1e6 it would be the less accurate side)
+    const double m = y.back();
+    std::vector<double> win(y.end() - static_cast<std::ptrdiff_t>(Ws), y.end());
+    for (double& v : win) v -= m;
+    stoch::OuParams ref = stoch::fit_ou(win, dt);
+    ref.theta += m;
+    T2T_CHECK(same(longrun.params(dt), ref));
+  }
+
+  // --- EW OU: lambda == 1 degenerates to an expanding-window fit_ou ---
+  stoch::EwOu ew_all(1.0);
+  for (size_t t=0; t<x.size(); ++t) ew_all.push(t * step_ns, x[t]);
+  T2T_CHECK(ew_all.ready());
+  T2T_CHECK(close(ew_all.dt_s(), dt));
+  T2T_CHECK(same(ew_all.params(dt), est));
+
+  // Decaying weights still give a sane fit
+  stoch::EwOu ew(stoch::EwOu::lambda_from_halflife(200.0));
+  for (size_t t=0; t<x.size(); ++t) ew.push(t * step_ns, x[t]);
+  const auto ewp = ew.params();
+  T2T_CHECK(std::isfinite(ewp.kappa) && ewp.kappa > 0.0);
+  T2T_CHECK(std::isfinite(ewp.sigma) && ewp.sigma > 0.0 && ewp.sigma < 10.0);
+  T2T_CHECK(stoch::usable(ewp) && stoch::usable(est));
+
+  // A half-life of one sample never gathers the weight a fit needs, and a
+  // trending window fits but does not mean-revert: neither is quoted from
+  stoch::EwOu ew1(stoch::EwOu::lambda_from_halflife(1.0));
+  stoch::RollingOu trend(W);
+  for (size_t t=0; t<x.size(); ++t) {
+    ew1.push(t * step_ns, x[t]);
+    trend.push(t * step_ns, 100.0 + 0.5 * static_cast<double>(t));
+  }
+  T2T_CHECK(ew1.size() == x.size() && !ew1.ready());
+  T2T_CHECK(trend.ready() && !stoch::usable(trend.params(dt)));
+
   // --- AvS behavior: ensure integer tick spread grows with sigma ---
   // Use parameters that yield >1 tick half-spread so integer casting won't mask it.
   stoch::OuParams ou_lo{1.0, 100.0, 2.0};  // sigma=2
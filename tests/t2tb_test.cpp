@@ -0,0 +1,73 @@
+#include "tests/test_util.h"
+#include "libitch/itch.h"
+#include "libitch/t2tb.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace t2t::itch;
+
+static bool same_event(const Event& a, const Event& b) {
+  return a.ts_ns == b.ts_ns && a.type == b.type && a.locate == b.locate && a.order_id == b.order_id &&
+         a.side == b.side && a.px == b.px && a.qty == b.qty && a.new_id == b.new_id;
+}
+
+void run_t2tb_tests() {
+  const std::string path = "/tmp/t2t_cache_test.t2tb";
+
+  // Round trip, including a non-monotonic timestamp and odd field values
+  std::vector<Event> ev;
+  for (uint32_t i = 0; i < 2500; ++i) {
+    const uint64_t ts = (i == 1500) ? 10 : 100ull + 3ull * i;
+    ev.push_back(Event{ts, EvType("ACEU"[i % 4]), static_cast<uint16_t>(i % 5), i + 1, (i & 1) != 0,
+                       static_cast<int32_t>(i) - 1000, -static_cast<int32_t>(i % 7), 0});
+  }
+  std::string err;
+  T2T_CHECK(t2tb::write(path, ev, &err, 256));
+  T2T_CHECK(t2tb::sniff(path));
+
+  T2tbFile f;
+  T2T_CHECK(f.open(path, &err));
+  T2T_CHECK(f.verify(&err));
+  T2T_CHECK(f.size() == ev.size());
+  bool all = true;
+  for (size_t i = 0; i < ev.size(); ++i) all &= same_event(f.at(i), ev[i]);
+  T2T_CHECK(all);
+
+  // seek_time == first event with ts >= t (linear reference)
+  for (const uint64_t t : {0ull, 10ull, 11ull, 100ull, 101ull, 4600ull, 4603ull, 7597ull, 7598ull, 99999ull}) {
+    size_t want = 0;
+    while (want < ev.size() && ev[want].ts_ns < t) ++want;
+    T2T_CHECK(f.seek_time(t) == want);
+  }
+  f.close();
+
+  // Empty cache
+  T2T_CHECK(t2tb::write(path, {}, &err));
+  T2T_CHECK(f.open(path, &err) && f.size() == 0 && f.seek_time(0) == 0 && f.verify(&err));
+  f.close();
+
+  // new_id cannot be stored
+  std::vector<Event> rep{Event{1, EvType::Replace, 0, 1, true, 100, 1, 2}};
+  T2T_CHECK(!t2tb::write(path, rep, &err) && !err.empty());
+
+  // Corruption: a flipped record byte fails verify(), a truncated file open()
+  T2T_CHECK(t2tb::write(path, ev, &err));
+  {
+    FILE* w = std::fopen(path.c_str(), "r+b");
+    std::fseek(w, static_cast<long>(sizeof(t2tb::Header) + 5 * sizeof(t2tb::PackedEvent) + 9), SEEK_SET);
+    std::fputc(0x5a, w);
+    std::fclose(w);
+  }
+  T2T_CHECK(f.open(path, &err));
+  T2T_CHECK(!f.verify(&err));
+  f.close();
+  {
+    FILE* w = std::fopen(path.c_str(), "wb");
+    std::fputs("T2TB", w);
+    std::fclose(w);
+  }
+  T2T_CHECK(!f.open(path, &err) && !err.empty());
+  T2T_CHECK(!f.open("/tmp/t2t_no_such_file.t2tb", &err));
+  std::remove(path.c_str());
+}
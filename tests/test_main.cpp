@@ -4,18 +4,34 @@
 int g_failures = 0;
 
 extern void run_ring_tests();
+extern void run_timing_tests();
+extern void run_histo_tests();
+extern void run_perf_tests();
+extern void run_trace_tests();
+extern void run_flat_map_tests();
+extern void run_id_table_tests();
 extern void run_itch_tests();
+extern void run_t2tb_tests();
 extern void run_lob_tests();
 extern void run_sig_risk_tests();
 extern void run_stoch_tests();
+extern void run_engine_tests();
 extern void run_determinism_tests();
 
 int main() {
   run_ring_tests();
+  run_timing_tests();
+  run_histo_tests();
+  run_perf_tests();
+  run_trace_tests();
+  run_flat_map_tests();
+  run_id_table_tests();
   run_itch_tests();
+  run_t2tb_tests();
   run_lob_tests();
   run_sig_risk_tests();
   run_stoch_tests();
+  run_engine_tests();
   run_determinism_tests(); 
   
   if (g_failures) {
@@ -0,0 +1,51 @@
+#include "tests/test_util.h"
+#include "libutil/timing.h"
+#include "libutil/tsc.h"
+#include <thread>
+
+using namespace t2t;
+
+extern void run_timing_tests() {
+  // Calibrated (or fallback) clock: init is idempotent, ticks only go
+  // forward, and a 2 ms sleep converts to roughly 2 ms
+  const tsc::Info& a = tsc::init();
+  const tsc::Info& b = tsc::init(false);
+  T2T_CHECK(&a == &b && a.tsc == tsc::info().tsc);
+  T2T_CHECK(a.ns_per_tick > 0.0 && a.overhead_ns >= 0.0 && a.overhead_ns < 10'000.0);
+  T2T_CHECK(!a.tsc || (a.invariant && a.ghz > 0.1 && a.ghz < 10.0));
+  const uint64_t t0 = tsc::start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  const uint64_t t1 = tsc::stop();
+  const uint64_t ns = tsc::to_ns(t1 - t0);
+  T2T_CHECK(t1 > t0 && ns >= 1'900'000u && ns < 1'000'000'000u);
+
+  // Stages drop warm-up samples, record ticks into the histogram and keep
+  // raw samples only when asked; raw ones convert in to_ns()
+  timing::StageTimers st(1, 4);
+  st.lob.push(5);                               // warm-up
+  { timing::ScopedTimer T(st.lob); std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+  st.e2e.push(0); st.e2e.push(t1 - t0);
+  T2T_CHECK(st.lob.hist.count()==1 && st.e2e.hist.count()==1 && !st.parse.used());
+  T2T_CHECK(st.handoff.raw.ns.empty());           // not threaded
+  st.to_ns();
+  T2T_CHECK(st.lob.raw.ns[0] >= 900'000u && st.lob.raw.ns[0] < 1'000'000'000u);
+  T2T_CHECK(st.e2e.raw.ns[0] == ns && st.e2e.raw.ns[1] == 0 && st.e2e.raw.idx.load() == 1);
+  const timing::Summary sm = timing::summarize(st.e2e.hist);
+  T2T_CHECK(sm.p50_us == sm.p9999_us && sm.p50_us >= 1'890.0 && sm.p50_us < 1e6);
+
+  // e2e splits into service + queue sample by sample; a service measured
+  // past e2e (marks from two threads) is capped, leaving no queue
+  timing::StageTimers sp(0, 4);
+  sp.split(100, 30);
+  sp.split(50, 80);
+  sp.split(7, 0);
+  const uint64_t want_svc[] = {30, 50, 0}, want_q[] = {70, 0, 7};
+  for (size_t i = 0; i < 3; ++i) {
+    T2T_CHECK(sp.service.raw.ns[i] == want_svc[i] && sp.queue.raw.ns[i] == want_q[i]);
+    T2T_CHECK(sp.service.raw.ns[i] + sp.queue.raw.ns[i] == sp.e2e.raw.ns[i]);
+  }
+  T2T_CHECK(sp.e2e.hist.count() == 3 && sp.queue.hist.count() == 3);
+  timing::StageTimers hist_only(0, 0);
+  hist_only.risk.push(42);
+  T2T_CHECK(hist_only.risk.raw.ns.empty() && hist_only.risk.hist.quantile(0.5)==42);
+}
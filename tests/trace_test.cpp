@@ -0,0 +1,54 @@
+#include "tests/test_util.h"
+#include "libutil/trace.h"
+#include <string>
+#include <vector>
+
+using namespace t2t;
+
+namespace {
+trace::Record rec(uint64_t seq, uint32_t e2e) {
+  trace::Record r{};
+  r.seq = seq;
+  r.mark[trace::Encode] = e2e;
+  return r;
+}
+} // namespace
+
+extern void run_trace_tests() {
+  const std::string path = "/tmp/t2t_trace_test.bin";
+  std::string err;
+  trace::Header h{};
+  std::vector<trace::Record> got;
+
+  // Sampling: every 3rd event; a full ring keeps the newest and flushes
+  // oldest first
+  trace::Recorder s(trace::Config{4, 3, 0, 16});
+  T2T_CHECK(s.ok());
+  for (uint64_t i = 1; i <= 20; ++i) s.record(rec(i, 10));
+  T2T_CHECK(s.offered()==20 && s.records()==4);
+  T2T_CHECK(s.flush(path, 0.5, &err) && trace::load(path, h, got, &err));
+  T2T_CHECK(h.records==4 && h.offered==20 && h.overwritten==2 && h.every==3 && h.ns_per_tick==0.5);
+  T2T_CHECK(got.size()==4 && got[0].seq==9 && got[1].seq==12 && got[2].seq==15 && got[3].seq==18);
+
+  // Slow mode: each event over the threshold comes with up to `context`
+  // events either side; a spike inside another's tail extends it
+  trace::Recorder w(trace::Config{64, 1, 100, 2});
+  const uint32_t e2e[] = {5, 5, 5, 5, 500, 5, 5, 5, 5, 5, 700, 5, 900, 5, 5, 5, 5};
+  for (uint64_t i = 0; i < sizeof(e2e) / sizeof(e2e[0]); ++i) w.record(rec(i, e2e[i]));
+  T2T_CHECK(w.slow()==3);
+  T2T_CHECK(w.flush(path, 1.0, &err) && trace::load(path, h, got, &err));
+  const uint64_t want[] = {2, 3, 4, 5, 6, 8, 9, 10, 11, 12, 13, 14};
+  T2T_CHECK(got.size()==sizeof(want) / sizeof(want[0]) && h.slow_ticks==100 && h.context==2);
+  for (size_t k = 0; k < got.size() && k < sizeof(want) / sizeof(want[0]); ++k) {
+    T2T_CHECK(got[k].seq==want[k]);
+    T2T_CHECK(((got[k].flags & trace::kSlow) != 0) == (got[k].mark[trace::Encode] >= 100));
+  }
+
+  // Not a trace
+  std::vector<trace::Record> none;
+  T2T_CHECK(s.flush(path, 1.0, &err));
+  FILE* f = std::fopen(path.c_str(), "r+b");
+  if (f) { std::fputc('X', f); std::fclose(f); }
+  T2T_CHECK(!trace::load(path, h, none, &err) && !err.empty());
+  std::remove(path.c_str());
+}
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Convert the synthetic CSV feed into a binary NASDAQ ITCH 5.0 capture.
+
+A -> 'A' Add Order, C -> 'D' Order Delete, X -> 'X' Order Cancel (partial,
+qty shares), E -> 'E' Order Executed (qty shares). --framing len prefixes every message with a 2-byte
+big-endian length (BinaryFILE style); raw writes messages back to back.
+A seventh "locate" column (named in the header) sets each message's stock
+locate; --symbols dir.csv (locate,symbol,...) emits 'R' Stock Directory
+messages ahead of the orders.
+"""
+import argparse, csv, struct
+
+def hdr(t, ts, loc=0):
+    # type, stock locate, tracking number, 48-bit timestamp
+    return struct.pack(">cHH", t, loc, 0) + struct.pack(">Q", ts)[2:]
+
+def directory(loc, symbol):
+    # 'R' Stock Directory: symbol then fixed reference fields (39 bytes)
+    return hdr(b"R", 0, loc) + struct.pack(">8sccIcc2scccccIc", symbol.ljust(8).encode()[:8],
+                                           b"Q", b"N", 100, b"N", b"C", b"  ", b"P",
+                                           b"N", b"N", b"1", b"N", 0, b"N")
+
+def encode(row, with_locate=False):
+    ts, typ, oid = int(row[0]), row[1], int(row[2])
+    side, px, qty = row[3], int(row[4]), int(row[5])
+    loc = int(row[6]) if with_locate else 0
+    hdr_ = lambda t, ts: hdr(t, ts, loc)
+    if typ == "A":
+        buy = side in ("1", "B", "b")
+        return hdr_(b"A", ts) + struct.pack(">QcI8sI", oid, b"B" if buy else b"S", qty, b"T2T     ", px)
+    if typ == "C":
+        return hdr_(b"D", ts) + struct.pack(">Q", oid)
+    if typ == "X":
+        return hdr_(b"X", ts) + struct.pack(">QI", oid, qty)
+    if typ == "E":
+        return hdr_(b"E", ts) + struct.pack(">QIQ", oid, qty, 0)
+    raise ValueError(f"unknown type {typ!r}")
+
+def convert(src, out, framing, symbols=None):
+    n = 0
+    with open(src, newline="") as f, open(out, "wb") as w:
+        def put(msg):
+            if framing == "len":
+                w.write(struct.pack(">H", len(msg)))
+            w.write(msg)
+        if symbols:
+            with open(symbols, newline="") as sf:
+                for row in csv.reader(sf):
+                    if row and row[0] != "locate":
+                        put(directory(int(row[0]), row[1]))
+                        n += 1
+        with_locate = False
+        for row in csv.reader(f):
+            if not row:
+                continue
+            if row[0] == "ts_ns":
+                with_locate = len(row) > 6 and row[6] == "locate"
+                continue
+            put(encode(row, with_locate))
+            n += 1
+    return n
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--csv", required=True)
+    ap.add_argument("--out", required=True)
+    ap.add_argument("--framing", choices=["raw", "len"], default="len")
+    ap.add_argument("--symbols", help="directory CSV: locate,symbol[,...] -> 'R' messages")
+    args = ap.parse_args()
+    n = convert(args.csv, args.out, args.framing, args.symbols)
+    print(f"wrote {n} messages to {args.out}")
@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Decode a t2t_main --trace file (libutil/trace.h) into a table or CSV.
+
+Stage columns are the time between consecutive stage egress marks, in us;
+a stage whose mark was not recorded (e.g. lob under --pipeline) is folded
+into the next one. e2e runs from ingress to encoded output. Flags: S = over
+the --trace-slow-us threshold, P = book stages ran on another thread.
+"""
+import argparse, struct, sys
+
+HEADER = struct.Struct("<8sIIQQQdQII")
+RECORD = struct.Struct("<QQ5IIiiiiiBBBB")
+MAGIC = b"T2TTRACE"
+STAGES = ["parse", "lob", "sig", "risk", "encode"]
+NO_BBO = (-2**31, 2**31 - 1)
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        raise SystemExit(f"{path}: too short for a trace header")
+    magic, ver, rsize, n, offered, overwritten, ns_per_tick, slow_ticks, every, context = HEADER.unpack_from(data)
+    if magic != MAGIC or ver != 1 or rsize != RECORD.size:
+        raise SystemExit(f"{path}: not a t2t trace (or another version)")
+    if len(data) < HEADER.size + n * RECORD.size:
+        raise SystemExit(f"{path}: truncated ({n} records in header)")
+    hdr = dict(records=n, offered=offered, overwritten=overwritten, ns_per_tick=ns_per_tick,
+               slow_us=slow_ticks * ns_per_tick / 1e3, every=every, context=context)
+    recs = []
+    for i in range(n):
+        (seq, t_in, m0, m1, m2, m3, m4, oid, bb, ba, qb, qa, inv,
+         typ, side, allowed, flags) = RECORD.unpack_from(data, HEADER.size + i * RECORD.size)
+        us = lambda ticks: ticks * ns_per_tick / 1e3
+        stage, prev = {}, 0
+        for name, m in zip(STAGES, (m0, m1, m2, m3, m4)):
+            if m == 0:
+                stage[name] = None
+                continue
+            stage[name] = us(m - prev)
+            prev = m
+        recs.append(dict(seq=seq, ingress_us=us(t_in), type=chr(typ) if typ else "?", side="B" if side else "S",
+                         order_id=oid, e2e_us=us(m4), **{f"{s}_us": stage[s] for s in STAGES},
+                         best_bid=None if bb == NO_BBO[0] or flags & 2 else bb,
+                         best_ask=None if ba == NO_BBO[1] or flags & 2 else ba,
+                         quote_bid=qb, quote_ask=qa, inv=inv, allowed=allowed,
+                         flags=("S" if flags & 1 else "") + ("P" if flags & 2 else "")))
+    return hdr, recs
+
+COLS = ["seq", "type", "side", "order_id", "e2e_us"] + [f"{s}_us" for s in STAGES] + \
+       ["best_bid", "best_ask", "quote_bid", "quote_ask", "inv", "allowed", "flags"]
+
+def fmt(v):
+    if v is None: return "-"
+    if isinstance(v, float): return f"{v:.3f}"
+    return str(v)
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("trace")
+    ap.add_argument("--csv", help="write all selected records as CSV here instead of a table")
+    ap.add_argument("--slow", action="store_true", help="only records over the slow threshold")
+    ap.add_argument("--top", type=int, default=0, help="only the K slowest records, slowest first")
+    args = ap.parse_args()
+
+    hdr, recs = load(args.trace)
+    mode = (f"slow >= {hdr['slow_us']:.2f} us, context {hdr['context']}" if hdr["slow_us"] > 0
+            else f"1 in {hdr['every']}")
+    print(f"# {hdr['records']} records ({mode}) of {hdr['offered']} events, "
+          f"{hdr['overwritten']} overwritten", file=sys.stderr)
+    if args.slow: recs = [r for r in recs if "S" in r["flags"]]
+    if args.top > 0: recs = sorted(recs, key=lambda r: -r["e2e_us"])[:args.top]
+
+    if args.csv:
+        with open(args.csv, "w") as f:
+            f.write(",".join(COLS) + "\n")
+            for r in recs: f.write(",".join("" if r[c] is None else fmt(r[c]) for c in COLS) + "\n")
+        print(f"wrote {args.csv}", file=sys.stderr)
+        return
+    rows = [[fmt(r[c]) for c in COLS] for r in recs]
+    width = [max([len(c)] + [len(row[i]) for row in rows]) for i, c in enumerate(COLS)]
+    print("  ".join(c.rjust(w) for c, w in zip(COLS, width)))
+    for row in rows: print("  ".join(v.rjust(w) for v, w in zip(row, width)))
+
+if __name__ == "__main__":
+    main()